@@ -0,0 +1,110 @@
+#include <vsg/all.h>
+
+#include <osg/Array>
+
+#include <chrono>
+#include <iostream>
+
+#include "ArrayUtils.h"
+
+// benchmark of the osg to vsg vertex attribute array conversion, comparing the original per element copy with the bulk copy and pad kernels.
+
+template<class VsgArray, class OsgArray>
+vsg::ref_ptr<VsgArray> convertPerElement(const OsgArray* inarray, uint32_t bindOverallPaddingCount)
+{
+    uint32_t count = inarray->size();
+    uint32_t targetSize = std::max(count, bindOverallPaddingCount);
+
+    vsg::ref_ptr<VsgArray> outarray(new VsgArray(targetSize));
+    uint32_t i = 0;
+    for (; i < count; ++i)
+    {
+        const auto& in_value = inarray->at(i);
+        std::memcpy(&(outarray->at(i)), in_value.ptr(), sizeof(typename VsgArray::value_type));
+    }
+
+    if (i < bindOverallPaddingCount)
+    {
+        auto last = outarray->at(count - 1);
+        for (; i < bindOverallPaddingCount; ++i)
+        {
+            outarray->at(i) = last;
+        }
+    }
+
+    return outarray;
+}
+
+template<class VsgArray, class OsgArray>
+vsg::ref_ptr<VsgArray> convertBulk(const OsgArray* inarray, uint32_t bindOverallPaddingCount)
+{
+    uint32_t count = inarray->size();
+    uint32_t targetSize = std::max(count, bindOverallPaddingCount);
+
+    auto outarray = VsgArray::create(targetSize);
+    osg2vsg::copyAndPad(outarray->data(), inarray->getDataPointer(), count, targetSize);
+
+    return outarray;
+}
+
+template<class F>
+double measure(uint32_t numIterations, size_t bytesPerIteration, F function)
+{
+    auto before = std::chrono::steady_clock::now();
+
+    size_t check = 0;
+    for (uint32_t i = 0; i < numIterations; ++i)
+    {
+        auto result = function();
+        check += result->valueCount();
+    }
+
+    auto after = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(after - before).count();
+
+    if (check == 0) std::cout << "no data converted" << std::endl;
+
+    return (double(bytesPerIteration) * double(numIterations)) / seconds / 1.0e9;
+}
+
+template<class VsgArray, class OsgArray>
+void benchmark(const char* name, uint32_t numElements, uint32_t numIterations)
+{
+    using value_type = typename VsgArray::value_type;
+
+    osg::ref_ptr<OsgArray> osg_array = new OsgArray(numElements);
+    float* ptr = reinterpret_cast<float*>(osg_array->getDataPointer());
+    for (size_t i = 0; i < numElements * (sizeof(value_type) / sizeof(float)); ++i) ptr[i] = float(i);
+
+    osg::ref_ptr<OsgArray> osg_overall = new OsgArray(1);
+
+    // bytes read plus bytes written
+    size_t copyBytes = size_t(numElements) * sizeof(value_type) * 2;
+    size_t padBytes = size_t(numElements) * sizeof(value_type);
+
+    auto elementCopy = measure(numIterations, copyBytes, [&]() { return convertPerElement<VsgArray>(osg_array.get(), 0); });
+    auto bulkCopy = measure(numIterations, copyBytes, [&]() { return convertBulk<VsgArray>(osg_array.get(), 0); });
+    auto elementPad = measure(numIterations, padBytes, [&]() { return convertPerElement<VsgArray>(osg_overall.get(), numElements); });
+    auto bulkPad = measure(numIterations, padBytes, [&]() { return convertBulk<VsgArray>(osg_overall.get(), numElements); });
+
+    std::cout << name << " copy : per element " << elementCopy << " GB/s, bulk " << bulkCopy << " GB/s, speed up " << bulkCopy / elementCopy << std::endl;
+    std::cout << name << " pad  : per element " << elementPad << " GB/s, bulk " << bulkPad << " GB/s, speed up " << bulkPad / elementPad << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+
+    auto numElements = arguments.value<uint32_t>(1000000, "-n");
+    auto numIterations = arguments.value<uint32_t>(100, {"--iterations", "-i"});
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    std::cout << "elements = " << numElements << ", iterations = " << numIterations << std::endl;
+
+    benchmark<vsg::vec2Array, osg::Vec2Array>("vec2", numElements, numIterations);
+    benchmark<vsg::vec3Array, osg::Vec3Array>("vec3", numElements, numIterations);
+    benchmark<vsg::vec4Array, osg::Vec4Array>("vec4", numElements, numIterations);
+
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include <vsg/all.h>
+
+#include <osg/Image>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include "ImageKernels.h"
+#include "TaskScheduler.h"
+
+// benchmark of the pixel reformatting used when converting osg::Image to vsg::Data,
+// comparing the original per pixel, per component copy with the dedicated scalar, SIMD and row parallel SIMD kernels.
+
+// original formatImage() inner loop, with the component offsets for the swizzle being benchmarked
+void formatImageOriginal(const osg::Image* image, osg::Image* new_image, const std::vector<int>& componentOffset, int numComponents, int numBytesPerComponent)
+{
+    unsigned char component_default[8] = {255, 255, 0, 0, 0, 0, 0, 0};
+
+    for (int r = 0; r < image->r(); ++r)
+    {
+        for (int t = 0; t < image->t(); ++t)
+        {
+            for (int s = 0; s < image->s(); ++s)
+            {
+                const unsigned char* src = image->data(s, t, r);
+                unsigned char* dst = new_image->data(s, t, r);
+
+                for (int c = 0; c < numComponents; ++c)
+                {
+                    int offset = componentOffset[c];
+                    const unsigned char* component_src = (offset >= 0) ? (src + offset) : component_default;
+                    for (int b = 0; b < numBytesPerComponent; ++b)
+                    {
+                        *(dst++) = *(component_src + b);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void formatImageKernel(const osg::Image* image, osg::Image* new_image, const osg2vsg::RowKernel& kernel, osg2vsg::TaskScheduler* scheduler)
+{
+    constexpr size_t bytesPerTask = 256 * 1024;
+    size_t rowSize = std::max(static_cast<size_t>(new_image->getRowSizeInBytes()), size_t(1));
+    size_t numRowsPerImage = image->t();
+    size_t numRows = numRowsPerImage * image->r();
+
+    osg2vsg::parallel_for(scheduler, numRows, std::max(bytesPerTask / rowSize, size_t(1)), [&](size_t row) {
+        unsigned int t = static_cast<unsigned int>(row % numRowsPerImage);
+        unsigned int r = static_cast<unsigned int>(row / numRowsPerImage);
+        kernel(image->data(0, t, r), new_image->data(0, t, r), image->s());
+    });
+}
+
+template<class F>
+double measure(uint32_t numIterations, F function)
+{
+    auto before = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < numIterations; ++i) function();
+    auto after = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::chrono::milliseconds::period>(after - before).count() / double(numIterations);
+}
+
+struct Case
+{
+    const char* name;
+    GLenum sourceFormat;
+    GLenum targetFormat;
+    GLenum dataType;
+    osg2vsg::PixelSwizzle swizzle;
+    std::vector<int> componentOffset; // in components, scaled by the component size
+};
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+
+    auto width = arguments.value<int>(7680, "--width");
+    auto height = arguments.value<int>(4320, "--height");
+    auto numIterations = arguments.value<uint32_t>(5, {"--iterations", "-i"});
+    auto numThreads = arguments.value<uint32_t>(std::max(1u, std::thread::hardware_concurrency()), {"--threads", "-t"});
+    bool skipOriginal = arguments.read("--skip-original");
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    auto scheduler = osg2vsg::TaskScheduler::create(numThreads);
+
+    std::cout << "image " << width << "x" << height << ", iterations = " << numIterations << ", threads = " << numThreads << ", SSSE3 = " << osg2vsg::supportsSSSE3() << std::endl;
+
+    std::vector<Case> cases = {
+        {"RGB8 -> RGBA8  ", GL_RGB, GL_RGBA, GL_UNSIGNED_BYTE, osg2vsg::PixelSwizzle::RGB_TO_RGBA, {0, 1, 2, -1}},
+        {"BGR8 -> RGBA8  ", GL_BGR, GL_RGBA, GL_UNSIGNED_BYTE, osg2vsg::PixelSwizzle::BGR_TO_RGBA, {2, 1, 0, -1}},
+        {"BGRA8 -> RGBA8 ", GL_BGRA, GL_RGBA, GL_UNSIGNED_BYTE, osg2vsg::PixelSwizzle::BGRA_TO_RGBA, {2, 1, 0, 3}},
+        {"BGR8 -> RGB8   ", GL_BGR, GL_RGB, GL_UNSIGNED_BYTE, osg2vsg::PixelSwizzle::BGR_TO_RGB, {2, 1, 0}},
+        {"RGB16 -> RGBA16", GL_RGB, GL_RGBA, GL_UNSIGNED_SHORT, osg2vsg::PixelSwizzle::RGB_TO_RGBA, {0, 1, 2, -1}},
+        {"BGR16 -> RGBA16", GL_BGR, GL_RGBA, GL_UNSIGNED_SHORT, osg2vsg::PixelSwizzle::BGR_TO_RGBA, {2, 1, 0, -1}},
+        {"BGRA16 -> RGBA16", GL_BGRA, GL_RGBA, GL_UNSIGNED_SHORT, osg2vsg::PixelSwizzle::BGRA_TO_RGBA, {2, 1, 0, 3}},
+    };
+
+    for (auto& testCase : cases)
+    {
+        osg::ref_ptr<osg::Image> image = new osg::Image;
+        image->allocateImage(width, height, 1, testCase.sourceFormat, testCase.dataType);
+        for (unsigned int i = 0; i < image->getTotalSizeInBytes(); ++i) image->data()[i] = static_cast<unsigned char>(i * 7);
+
+        osg::ref_ptr<osg::Image> new_image = new osg::Image;
+        new_image->allocateImage(width, height, 1, testCase.targetFormat, testCase.dataType);
+
+        int numBytesPerComponent = (testCase.dataType == GL_UNSIGNED_SHORT) ? 2 : 1;
+        std::vector<int> componentOffset;
+        for (auto offset : testCase.componentOffset) componentOffset.push_back(offset >= 0 ? offset * numBytesPerComponent : -1);
+        int numComponents = static_cast<int>(componentOffset.size());
+
+        auto scalarKernel = osg2vsg::selectRowKernel(testCase.swizzle, numBytesPerComponent, false);
+        auto simdKernel = osg2vsg::selectRowKernel(testCase.swizzle, numBytesPerComponent, true);
+
+        double original = skipOriginal ? 0.0 : measure(numIterations, [&]() { formatImageOriginal(image.get(), new_image.get(), componentOffset, numComponents, numBytesPerComponent); });
+        double scalar = measure(numIterations, [&]() { formatImageKernel(image.get(), new_image.get(), scalarKernel, nullptr); });
+        double simd = measure(numIterations, [&]() { formatImageKernel(image.get(), new_image.get(), simdKernel, nullptr); });
+        double parallel = measure(numIterations, [&]() { formatImageKernel(image.get(), new_image.get(), simdKernel, scheduler.get()); });
+
+        std::cout << testCase.name << " : ";
+        if (!skipOriginal) std::cout << "original " << original << "ms, ";
+        std::cout << "scalar " << scalar << "ms, SIMD " << simd << "ms, SIMD + parallel " << parallel << "ms";
+        if (!skipOriginal) std::cout << ", speed up " << original / parallel;
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
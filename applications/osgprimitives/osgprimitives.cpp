@@ -0,0 +1,218 @@
+#include <vsg/all.h>
+
+#include <osg/Geometry>
+#include <osg/TemplatePrimitiveIndexFunctor>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include "PrimitiveDecoder.h"
+
+// benchmark of the conversion of osg::Geometry primitive sets to a vsg index array, comparing the original collection of each index with push_back
+// followed by a per element copy into the index array with the decoder writing into a presized array followed by a block copy.
+
+// original primitive collection used by osg2vsg::convertToVsg()
+struct ConvertPrimitives
+{
+    std::vector<uint32_t> points;
+    std::vector<uint32_t> lines;
+    std::vector<uint32_t> triangles;
+    std::vector<uint32_t> quads;
+
+    void operator()(unsigned int i0)
+    {
+        points.push_back(i0);
+    }
+    void operator()(unsigned int i0, unsigned int i1)
+    {
+        lines.push_back(i0);
+        lines.push_back(i1);
+    }
+    void operator()(unsigned int i0, unsigned int i1, unsigned int i2)
+    {
+        triangles.push_back(i0);
+        triangles.push_back(i1);
+        triangles.push_back(i2);
+    }
+    void operator()(unsigned int i0, unsigned int i1, unsigned int i2, unsigned int i3)
+    {
+        quads.push_back(i0);
+        quads.push_back(i1);
+        quads.push_back(i2);
+        quads.push_back(i3);
+    }
+};
+
+vsg::ref_ptr<vsg::Data> createIndices(const std::vector<uint32_t>& triangles, bool perElement)
+{
+    uint32_t maxIndex = *std::max_element(triangles.begin(), triangles.end());
+    if (maxIndex > 65535)
+    {
+        auto indices = vsg::uintArray::create(triangles.size());
+        if (perElement)
+            for (size_t i = 0; i < triangles.size(); ++i) indices->set(i, triangles[i]);
+        else
+            std::memcpy(indices->dataPointer(), triangles.data(), triangles.size() * sizeof(uint32_t));
+        return indices;
+    }
+    else
+    {
+        auto indices = vsg::ushortArray::create(triangles.size());
+        if (perElement)
+            for (size_t i = 0; i < triangles.size(); ++i) indices->set(i, static_cast<uint16_t>(triangles[i]));
+        else
+            std::transform(triangles.begin(), triangles.end(), indices->begin(), [](uint32_t index) { return static_cast<uint16_t>(index); });
+        return indices;
+    }
+}
+
+vsg::ref_ptr<vsg::Data> convertOriginal(const osg::Geometry* geometry)
+{
+    osg::TemplatePrimitiveIndexFunctor<ConvertPrimitives> collectPrimitives;
+    geometry->accept(collectPrimitives);
+
+    auto& triangles = collectPrimitives.triangles;
+    auto& quads = collectPrimitives.quads;
+    for (size_t i = 0; i < quads.size(); i += 4)
+    {
+        triangles.push_back(quads[i + 0]);
+        triangles.push_back(quads[i + 1]);
+        triangles.push_back(quads[i + 2]);
+
+        triangles.push_back(quads[i + 0]);
+        triangles.push_back(quads[i + 2]);
+        triangles.push_back(quads[i + 3]);
+    }
+
+    return createIndices(triangles, true);
+}
+
+vsg::ref_ptr<vsg::Data> convertDecoder(const osg::Geometry* geometry)
+{
+    std::vector<uint32_t> triangles;
+    osg2vsg::decodeTriangles(*geometry, triangles);
+
+    return createIndices(triangles, false);
+}
+
+// grid of width x height vertices drawn as a single primitive set of the given mode
+template<class DrawElements>
+osg::ref_ptr<osg::Geometry> createGrid(unsigned int width, unsigned int height, GLenum mode)
+{
+    osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry;
+    osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array(width * height);
+    for (unsigned int j = 0; j < height; ++j)
+    {
+        for (unsigned int i = 0; i < width; ++i) (*vertices)[j * width + i].set(float(i), float(j), 0.0f);
+    }
+    geometry->setVertexArray(vertices.get());
+
+    if (mode == GL_TRIANGLE_STRIP)
+    {
+        // a strip per row
+        for (unsigned int j = 0; j + 1 < height; ++j)
+        {
+            osg::ref_ptr<DrawElements> strip = new DrawElements(GL_TRIANGLE_STRIP);
+            for (unsigned int i = 0; i < width; ++i)
+            {
+                strip->push_back(j * width + i);
+                strip->push_back((j + 1) * width + i);
+            }
+            geometry->addPrimitiveSet(strip.get());
+        }
+        return geometry;
+    }
+
+    osg::ref_ptr<DrawElements> elements = new DrawElements(mode);
+    for (unsigned int j = 0; j + 1 < height; ++j)
+    {
+        for (unsigned int i = 0; i + 1 < width; ++i)
+        {
+            unsigned int i00 = j * width + i, i10 = i00 + 1, i01 = i00 + width, i11 = i01 + 1;
+            if (mode == GL_QUADS)
+            {
+                elements->push_back(i00);
+                elements->push_back(i10);
+                elements->push_back(i11);
+                elements->push_back(i01);
+            }
+            else
+            {
+                elements->push_back(i00);
+                elements->push_back(i10);
+                elements->push_back(i11);
+                elements->push_back(i00);
+                elements->push_back(i11);
+                elements->push_back(i01);
+            }
+        }
+    }
+    geometry->addPrimitiveSet(elements.get());
+    return geometry;
+}
+
+bool same(const vsg::Data* lhs, const vsg::Data* rhs)
+{
+    return lhs && rhs && lhs->dataSize() == rhs->dataSize() && lhs->valueSize() == rhs->valueSize() && std::memcmp(lhs->dataPointer(), rhs->dataPointer(), lhs->dataSize()) == 0;
+}
+
+template<class F>
+double measure(uint32_t numIterations, F function)
+{
+    auto before = std::chrono::steady_clock::now();
+
+    size_t check = 0;
+    for (uint32_t i = 0; i < numIterations; ++i)
+    {
+        auto result = function();
+        check += result->valueCount();
+    }
+
+    auto after = std::chrono::steady_clock::now();
+
+    if (check == 0) std::cout << "no indices converted" << std::endl;
+
+    return std::chrono::duration<double, std::chrono::milliseconds::period>(after - before).count() / double(numIterations);
+}
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+
+    auto width = arguments.value<unsigned int>(1024, "--width");
+    auto height = arguments.value<unsigned int>(1024, "--height");
+    auto numIterations = arguments.value<uint32_t>(20, {"--iterations", "-i"});
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    // 16 bit indices can only address a 256 x 256 grid
+    unsigned int smallWidth = std::min(width, 256u);
+    unsigned int smallHeight = std::min(height, 256u);
+
+    std::cout << "grid " << width << "x" << height << ", 16 bit grid " << smallWidth << "x" << smallHeight << ", iterations = " << numIterations << std::endl;
+
+    std::vector<std::pair<const char*, osg::ref_ptr<osg::Geometry>>> cases = {
+        {"DrawElementsUInt triangles      ", createGrid<osg::DrawElementsUInt>(width, height, GL_TRIANGLES)},
+        {"DrawElementsUInt quads          ", createGrid<osg::DrawElementsUInt>(width, height, GL_QUADS)},
+        {"DrawElementsUInt triangle strips", createGrid<osg::DrawElementsUInt>(width, height, GL_TRIANGLE_STRIP)},
+        {"DrawElementsUShort triangles    ", createGrid<osg::DrawElementsUShort>(smallWidth, smallHeight, GL_TRIANGLES)},
+        {"DrawElementsUShort quads        ", createGrid<osg::DrawElementsUShort>(smallWidth, smallHeight, GL_QUADS)},
+    };
+
+    for (auto& [name, geometry] : cases)
+    {
+        auto original = convertOriginal(geometry.get());
+        auto decoded = convertDecoder(geometry.get());
+
+        double originalTime = measure(numIterations, [&]() { return convertOriginal(geometry.get()); });
+        double decoderTime = measure(numIterations, [&]() { return convertDecoder(geometry.get()); });
+
+        std::cout << name << " : " << original->valueCount() << " indices, original " << originalTime << "ms, decoder " << decoderTime << "ms, speed up " << originalTime / decoderTime;
+        if (!same(original.get(), decoded.get())) std::cout << ", MISMATCH";
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include <vsg/all.h>
+
+#include <osg2vsg/OSG.h>
+#include <osg2vsg/convert.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+// serialize object in the .vsgt text format, so concurrently converted scenes can be compared with the reference conversion
+std::string serialize(const vsg::Object* object, vsg::ref_ptr<const vsg::Options> options)
+{
+    auto local_options = vsg::Options::create(*options);
+    local_options->extensionHint = ".vsgt";
+
+    std::ostringstream out;
+    if (!object || !vsg::VSG::create()->write(object, out, local_options)) return {};
+    return out.str();
+}
+
+int main(int argc, char** argv)
+{
+    auto options = vsg::Options::create();
+    options->paths = vsg::getEnvPaths("VSG_FILE_PATH");
+    options->add(osg2vsg::OSG::create());
+
+    vsg::CommandLine arguments(&argc, argv);
+    arguments.read(options);
+
+    auto numThreads = arguments.value<uint32_t>(std::max(1u, std::thread::hardware_concurrency()), {"--threads", "-t"});
+    auto numReads = arguments.value<uint32_t>(4, {"--reads", "-n"});
+    bool shareCaches = !arguments.read("--no-sharing");
+    bool writeResults = arguments.read("--write");
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    if (argc <= 1)
+    {
+        std::cout << "Usage: osgthreadedread model [--threads n] [--reads n] [--no-sharing] [--write]" << std::endl;
+        std::cout << "    reads model n times on each of the threads, all sharing one set of conversion caches unless --no-sharing is used." << std::endl;
+        std::cout << "    Each result is compared with a reference read of the model made before the threads are started." << std::endl;
+        return 1;
+    }
+
+    vsg::Path filename = arguments[1];
+
+    // all reads share the conversion caches attached to options->sharedObjects
+    if (shareCaches) options->sharedObjects = vsg::SharedObjects::create();
+
+    // the reference conversion is made on its own, so the concurrent reads are compared with a result no other read could have interfered with
+    auto reference = vsg::read_cast<vsg::Node>(filename, options);
+    if (!reference)
+    {
+        std::cout << "Unable to read " << filename << std::endl;
+        return 1;
+    }
+    auto referenceText = serialize(reference, options);
+
+    std::atomic<uint32_t> numSucceeded = 0;
+    std::atomic<uint32_t> numFailed = 0;
+    std::atomic<uint32_t> numMismatched = 0;
+    std::vector<vsg::ref_ptr<vsg::Node>> results(numThreads);
+
+    auto before = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < numThreads; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            for (uint32_t i = 0; i < numReads; ++i)
+            {
+                auto vsg_scene = vsg::read_cast<vsg::Node>(filename, options);
+                if (vsg_scene)
+                {
+                    ++numSucceeded;
+                    if (serialize(vsg_scene, options) != referenceText) ++numMismatched;
+                    results[t] = vsg_scene;
+                }
+                else
+                {
+                    ++numFailed;
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads) thread.join();
+
+    auto after = std::chrono::steady_clock::now();
+    double duration = std::chrono::duration<double, std::chrono::milliseconds::period>(after - before).count();
+
+    std::cout << "threads = " << numThreads << ", reads per thread = " << numReads << std::endl;
+    std::cout << "succeeded = " << numSucceeded << ", failed = " << numFailed << ", differing from the reference = " << numMismatched << std::endl;
+    std::cout << "total time = " << duration << "ms, average per read = " << duration / double(numThreads * numReads) << "ms" << std::endl;
+
+    if (shareCaches) osg2vsg::reportCaches(*options, std::cout);
+
+    if (writeResults)
+    {
+        vsg::write(reference, "osgthreadedread_reference.vsgt", options);
+        for (uint32_t t = 0; t < numThreads; ++t)
+        {
+            if (results[t]) vsg::write(results[t], vsg::make_string("osgthreadedread_", t, ".vsgt"), options);
+        }
+    }
+
+    return (numFailed > 0 || numMismatched > 0) ? 1 : 0;
+}
@@ -45,6 +45,49 @@ namespace osg2vsg
         static constexpr const char* original_converter = "original_converter";   // select early osg2vsg implementation
         static constexpr const char* read_build_options = "read_build_options";   // read build options from specified file
         static constexpr const char* write_build_options = "write_build_options"; // write build options to specified file
+        static constexpr const char* num_threads = "num_threads";                 // number of threads to use when converting subgraphs in parallel
+        static constexpr const char* cache_directory = "cache_directory";         // vsg::Path of directory used to cache converted files between runs, disabled when not set. Scenes read from the cache have their own pipelines rather than those of the PipelineCache
+        static constexpr const char* cache_max_megabytes = "cache_max_megabytes"; // maximum size of the cache directory in megabytes, least recently used entries are removed beyond it, default 1024
+        static constexpr const char* texture_compression = "texture_compression"; // block compress textures, one of none, bc1, bc3 or bc7
+        static constexpr const char* texture_compression_quality = "texture_compression_quality"; // 0 fastest, 1 normal or 2 best quality block compression
+        static constexpr const char* compress_normal_maps = "compress_normal_maps"; // also block compress normal maps, default false
+        static constexpr const char* mipmap_filter = "mipmap_filter";               // generate mipmaps on the CPU, one of none, box or kaiser
+        static constexpr const char* srgb_mipmaps = "srgb_mipmaps";                 // filter mipmaps of colour textures in linear space, default false
+        static constexpr const char* texture_deduplication = "texture_deduplication"; // share textures with identical content, one of none, scene (default), process or shared
+        static constexpr const char* merge_geometries = "merge_geometries";           // merge sibling geometries with the same state into shared draws, default false
+        static constexpr const char* max_merged_vertices = "max_merged_vertices";     // maximum number of vertices in each merged draw, default 65536
+        static constexpr const char* instance_geometries = "instance_geometries";     // replace geometry repeated under different transforms with instanced draws, default false
+        static constexpr const char* min_instances = "min_instances";                 // minimum number of repeats before geometry is instanced, default 4
+        static constexpr const char* max_instances = "max_instances";                 // maximum number of instances in each instanced draw, default 64
+        static constexpr const char* cull_group_hierarchy = "cull_group_hierarchy";   // build a balanced hierarchy of CullGroups over wide groups, default false
+        static constexpr const char* hierarchy_fan_out = "hierarchy_fan_out";         // number of children of each CullGroup in the hierarchy, default 4
+        static constexpr const char* hierarchy_leaf_size = "hierarchy_leaf_size";     // maximum number of original children under each leaf CullGroup, default 16
+        static constexpr const char* bounding_sphere = "bounding_sphere";             // bounding spheres of geometries used for culling, one of osg, ritter (default) or obb
+        static constexpr const char* optimize_meshes = "optimize_meshes";             // reorder triangles and vertices for the vertex cache, overdraw and vertex fetch, default false
+        static constexpr const char* vertex_cache_size = "vertex_cache_size";         // number of entries in the vertex cache optimized for, default 16
+        static constexpr const char* weld_vertices = "weld_vertices";                 // merge duplicate vertices, such as those of DrawArrays geometry, before generating indices, default false
+        static constexpr const char* weld_position_epsilon = "weld_position_epsilon"; // distance within which welded positions are merged, default 0 for exact matches
+        static constexpr const char* weld_normal_epsilon = "weld_normal_epsilon";     // tolerance within which welded normals are merged, default 0 for exact matches
+        static constexpr const char* split_large_meshes = "split_large_meshes";       // split meshes with more than 65535 vertices into chunks so they can use 16 bit indices, default false
+        static constexpr const char* triangle_strips = "triangle_strips";             // draw meshes as triangle strips with primitive restart when that gives smaller index arrays, default false
+        static constexpr const char* compress_vertices = "compress_vertices";                           // octahedral encode normals and tangents, store texcoords as 16 bit and colours as 8 bit values, default false
+        static constexpr const char* texcoord_compression = "texcoord_compression";                     // compressed texcoord format, one of half (default) or unorm16 for texcoords within 0 to 1
+        static constexpr const char* compression_normal_tolerance = "compression_normal_tolerance";     // largest normal and tangent error in degrees, default 0.5
+        static constexpr const char* compression_texcoord_tolerance = "compression_texcoord_tolerance"; // largest texcoord error, default 1/4096
+        static constexpr const char* compression_color_tolerance = "compression_color_tolerance";       // largest colour component error, default 1/255
+        static constexpr const char* enforce_compression_tolerances = "enforce_compression_tolerances"; // leave streams whose error exceeds the tolerance uncompressed, default true
+        static constexpr const char* position_compression = "position_compression";                     // store positions relative to their bounding box, one of none (default), unorm16 or snorm16
+        static constexpr const char* position_tolerance = "position_tolerance";                         // largest position error, positions exceeding it are left uncompressed, default 0.01
+        static constexpr const char* simplify_meshes = "simplify_meshes";                               // generate LOD levels of heavy geometry by simplifying it, default false
+        static constexpr const char* simplify_min_triangles = "simplify_min_triangles";                 // minimum number of triangles of geometry simplified, default 10000
+        static constexpr const char* simplify_levels = "simplify_levels";                               // number of reduced levels generated, at most 4, default 3
+        static constexpr const char* simplify_level_ratio = "simplify_level_ratio";                     // fraction of the triangles of the previous level each level targets, default 0.25
+        static constexpr const char* simplify_max_error = "simplify_max_error";                         // largest error of the coarsest level relative to the geometry's radius, default 0.05
+        static constexpr const char* simplify_pixel_error = "simplify_pixel_error";                     // screen space error in pixels at which each reduced level is switched to, default 1
+        static constexpr const char* build_meshlets = "build_meshlets";                                 // partition draws into meshlets with bounds and normal cones attached to each VertexIndexDraw, default false
+        static constexpr const char* max_meshlet_vertices = "max_meshlet_vertices";                     // maximum number of vertices of each meshlet, at most 256, default 64
+        static constexpr const char* max_meshlet_triangles = "max_meshlet_triangles";                   // maximum number of triangles of each meshlet, default 124
+        static constexpr const char* prune_vertex_attributes = "prune_vertex_attributes";               // leave out vertex attributes the selected shader variant doesn't read, ignored with custom shaders, default true
 
         bool readOptions(vsg::Options& options, vsg::CommandLine& arguments) const override;
 
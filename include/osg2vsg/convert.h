@@ -32,6 +32,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <osg2vsg/Export.h>
 
+#include <ostream>
+
 namespace osg2vsg
 {
 
@@ -63,4 +65,7 @@ namespace osg2vsg
     OSG2VSG_DECLSPEC extern vsg::ref_ptr<vsg::Data> convert(const osg::Image& image, vsg::ref_ptr<const vsg::Options> options = {});
     OSG2VSG_DECLSPEC extern vsg::ref_ptr<vsg::Node> convert(const osg::Node& node, vsg::ref_ptr<const vsg::Options> options = {}, const vsg::Path& filePath = {});
 
+    /// write the statistics of the pipeline, conversion and texture content caches shared between reads using options.
+    OSG2VSG_DECLSPEC extern void reportCaches(const vsg::Options& options, std::ostream& out);
+
 } // namespace vsgXchange
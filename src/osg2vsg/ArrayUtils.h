@@ -0,0 +1,39 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+namespace osg2vsg
+{
+    /// set ptr[1, count) to ptr[0] by repeatedly doubling the initialized block,
+    /// so the work is done by a handful of memcpy calls using the C runtime's vectorized copies rather than per element stores.
+    template<typename T>
+    void replicateFirst(T* ptr, size_t count)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "replicateFirst requires a trivially copyable type.");
+
+        size_t filled = 1;
+        while (filled < count)
+        {
+            size_t n = std::min(filled, count - filled);
+            std::memcpy(ptr + filled, ptr, n * sizeof(T));
+            filled += n;
+        }
+    }
+
+    /// copy count elements from src, which must have the same memory layout as T, to dest then pad to targetCount with copies of the last element.
+    template<typename T>
+    void copyAndPad(T* dest, const void* src, size_t count, size_t targetCount)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "copyAndPad requires a trivially copyable type.");
+
+        if (count == 0) return;
+
+        std::memcpy(dest, src, count * sizeof(T));
+
+        if (targetCount > count) replicateFirst(dest + count - 1, targetCount - count + 1);
+    }
+
+} // namespace osg2vsg
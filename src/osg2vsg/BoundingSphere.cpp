@@ -0,0 +1,320 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2026 the osg2vsg authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "BoundingSphere.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#    define OSG2VSG_SSE2 1
+#    include <emmintrin.h>
+#endif
+
+using namespace osg2vsg;
+
+namespace
+{
+#if defined(OSG2VSG_SSE2)
+    // transpose four consecutive xyz vertices into one register per component
+    inline void loadVertices(const float* ptr, __m128& x, __m128& y, __m128& z)
+    {
+        __m128 a = _mm_loadu_ps(ptr);     // x0 y0 z0 x1
+        __m128 b = _mm_loadu_ps(ptr + 4); // y1 z1 x2 y2
+        __m128 c = _mm_loadu_ps(ptr + 8); // z2 x3 y3 z3
+
+        x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+        y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+        z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+    }
+
+    inline float horizontalMin(__m128 v)
+    {
+        v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+        v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtss_f32(v);
+    }
+
+    inline float horizontalMax(__m128 v)
+    {
+        v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+        v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtss_f32(v);
+    }
+#endif
+
+    void computeMinMax(const vsg::vec3* vertices, size_t count, vsg::vec3& min, vsg::vec3& max)
+    {
+        min = vertices[0];
+        max = vertices[0];
+        size_t i = 0;
+
+#if defined(OSG2VSG_SSE2)
+        if (count >= 4)
+        {
+            __m128 minX, minY, minZ;
+            loadVertices(vertices[0].data(), minX, minY, minZ);
+            __m128 maxX = minX, maxY = minY, maxZ = minZ;
+            for (i = 4; i + 4 <= count; i += 4)
+            {
+                __m128 x, y, z;
+                loadVertices(vertices[i].data(), x, y, z);
+                minX = _mm_min_ps(minX, x);
+                minY = _mm_min_ps(minY, y);
+                minZ = _mm_min_ps(minZ, z);
+                maxX = _mm_max_ps(maxX, x);
+                maxY = _mm_max_ps(maxY, y);
+                maxZ = _mm_max_ps(maxZ, z);
+            }
+            min.set(horizontalMin(minX), horizontalMin(minY), horizontalMin(minZ));
+            max.set(horizontalMax(maxX), horizontalMax(maxY), horizontalMax(maxZ));
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            auto& v = vertices[i];
+            min.set(std::min(min.x, v.x), std::min(min.y, v.y), std::min(min.z, v.z));
+            max.set(std::max(max.x, v.x), std::max(max.y, v.y), std::max(max.z, v.z));
+        }
+    }
+
+    // squared distance from center of the furthest vertex
+    double computeMaxDistance2(const vsg::vec3* vertices, size_t count, const vsg::dvec3& center)
+    {
+        float maxDistance2 = 0.0f;
+        vsg::vec3 c(center);
+        size_t i = 0;
+
+#if defined(OSG2VSG_SSE2)
+        __m128 cx = _mm_set1_ps(c.x), cy = _mm_set1_ps(c.y), cz = _mm_set1_ps(c.z);
+        __m128 maxD2 = _mm_setzero_ps();
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 x, y, z;
+            loadVertices(vertices[i].data(), x, y, z);
+            x = _mm_sub_ps(x, cx);
+            y = _mm_sub_ps(y, cy);
+            z = _mm_sub_ps(z, cz);
+            maxD2 = _mm_max_ps(maxD2, _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+        }
+        maxDistance2 = horizontalMax(maxD2);
+#endif
+
+        for (; i < count; ++i)
+        {
+            auto d = vertices[i] - c;
+            maxDistance2 = std::max(maxDistance2, d.x * d.x + d.y * d.y + d.z * d.z);
+        }
+        return static_cast<double>(maxDistance2);
+    }
+
+    // Ritter's bounding sphere, starting from the most separated pair of the extreme vertices along each axis
+    vsg::dvec3 computeRitterCenter(const vsg::vec3* vertices, size_t count)
+    {
+        size_t minIndex[3] = {0, 0, 0};
+        size_t maxIndex[3] = {0, 0, 0};
+        for (size_t i = 1; i < count; ++i)
+        {
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                if (vertices[i][axis] < vertices[minIndex[axis]][axis]) minIndex[axis] = i;
+                if (vertices[i][axis] > vertices[maxIndex[axis]][axis]) maxIndex[axis] = i;
+            }
+        }
+
+        int widest = 0;
+        double widestDistance2 = -1.0;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            double distance2 = vsg::length2(vsg::dvec3(vertices[maxIndex[axis]]) - vsg::dvec3(vertices[minIndex[axis]]));
+            if (distance2 > widestDistance2)
+            {
+                widest = axis;
+                widestDistance2 = distance2;
+            }
+        }
+
+        vsg::dvec3 center = (vsg::dvec3(vertices[minIndex[widest]]) + vsg::dvec3(vertices[maxIndex[widest]])) * 0.5;
+        double radius = std::sqrt(widestDistance2) * 0.5;
+        double radius2 = radius * radius;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            vsg::dvec3 d = vsg::dvec3(vertices[i]) - center;
+            double distance2 = vsg::length2(d);
+            if (distance2 > radius2)
+            {
+                // grow the sphere just enough to include the vertex, moving its centre towards it
+                double distance = std::sqrt(distance2);
+                double newRadius = (radius + distance) * 0.5;
+                center += d * ((newRadius - radius) / distance);
+                radius = newRadius;
+                radius2 = radius * radius;
+            }
+        }
+        return center;
+    }
+
+    // eigenvectors of the symmetric matrix a using cyclic Jacobi rotations, returned as the columns of v
+    void computeEigenvectors(double a[3][3], double v[3][3])
+    {
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j) v[i][j] = (i == j) ? 1.0 : 0.0;
+
+        for (int sweep = 0; sweep < 16; ++sweep)
+        {
+            double offDiagonal = std::abs(a[0][1]) + std::abs(a[0][2]) + std::abs(a[1][2]);
+            if (offDiagonal < 1e-12 * (std::abs(a[0][0]) + std::abs(a[1][1]) + std::abs(a[2][2]))) break;
+
+            for (int p = 0; p < 2; ++p)
+            {
+                for (int q = p + 1; q < 3; ++q)
+                {
+                    if (a[p][q] == 0.0) continue;
+
+                    double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+                    double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+                    double c = 1.0 / std::sqrt(t * t + 1.0);
+                    double s = t * c;
+
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        double akp = a[k][p], akq = a[k][q];
+                        a[k][p] = c * akp - s * akq;
+                        a[k][q] = s * akp + c * akq;
+                    }
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        double apk = a[p][k], aqk = a[q][k];
+                        a[p][k] = c * apk - s * aqk;
+                        a[q][k] = s * apk + c * aqk;
+                    }
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        double vkp = v[k][p], vkq = v[k][q];
+                        v[k][p] = c * vkp - s * vkq;
+                        v[k][q] = s * vkp + c * vkq;
+                    }
+                }
+            }
+        }
+    }
+
+    // centre of the bounding box aligned with the principal axes of the vertices
+    vsg::dvec3 computeOrientedBoxCenter(const vsg::vec3* vertices, size_t count)
+    {
+        vsg::dvec3 mean;
+        for (size_t i = 0; i < count; ++i) mean += vsg::dvec3(vertices[i]);
+        mean /= static_cast<double>(count);
+
+        double covariance[3][3] = {};
+        for (size_t i = 0; i < count; ++i)
+        {
+            vsg::dvec3 d = vsg::dvec3(vertices[i]) - mean;
+            for (int r = 0; r < 3; ++r)
+                for (int c = r; c < 3; ++c) covariance[r][c] += d[r] * d[c];
+        }
+        for (int r = 0; r < 3; ++r)
+            for (int c = 0; c < r; ++c) covariance[r][c] = covariance[c][r];
+
+        double axes[3][3];
+        computeEigenvectors(covariance, axes);
+
+        double minProjection[3], maxProjection[3];
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            minProjection[axis] = std::numeric_limits<double>::max();
+            maxProjection[axis] = std::numeric_limits<double>::lowest();
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            vsg::dvec3 d = vsg::dvec3(vertices[i]) - mean;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                double projection = d.x * axes[0][axis] + d.y * axes[1][axis] + d.z * axes[2][axis];
+                minProjection[axis] = std::min(minProjection[axis], projection);
+                maxProjection[axis] = std::max(maxProjection[axis], projection);
+            }
+        }
+
+        vsg::dvec3 center = mean;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            double middle = (minProjection[axis] + maxProjection[axis]) * 0.5;
+            center += vsg::dvec3(axes[0][axis], axes[1][axis], axes[2][axis]) * middle;
+        }
+        return center;
+    }
+} // namespace
+
+vsg::dsphere osg2vsg::computeBoundingSphere(const vsg::vec3* vertices, size_t count, BoundingSphereMethod method)
+{
+    if (!vertices || count == 0) return vsg::dsphere();
+
+    vsg::vec3 min, max;
+    computeMinMax(vertices, count, min, max);
+
+    // each candidate centre gets the radius of its furthest vertex, which for the Ritter centre is usually smaller than the radius Ritter's pass grew to
+    vsg::dvec3 bestCenter = (vsg::dvec3(min) + vsg::dvec3(max)) * 0.5;
+    double bestRadius2 = computeMaxDistance2(vertices, count, bestCenter);
+
+    auto tryCenter = [&](const vsg::dvec3& center) {
+        double radius2 = computeMaxDistance2(vertices, count, center);
+        if (radius2 < bestRadius2)
+        {
+            bestCenter = center;
+            bestRadius2 = radius2;
+        }
+    };
+
+    if (method == BOUNDING_SPHERE_RITTER || method == BOUNDING_SPHERE_OBB) tryCenter(computeRitterCenter(vertices, count));
+    if (method == BOUNDING_SPHERE_OBB && count >= 3) tryCenter(computeOrientedBoxCenter(vertices, count));
+
+    // pad by a float ulp of the extents as the distances were computed in single precision
+    double radius = std::sqrt(bestRadius2);
+    radius += (vsg::length(vsg::dvec3(max - min)) + vsg::length(bestCenter)) * std::numeric_limits<float>::epsilon();
+
+    return vsg::dsphere(bestCenter, radius);
+}
+
+vsg::dsphere osg2vsg::computeBoundingSphere(const std::vector<vsg::dsphere>& spheres)
+{
+    vsg::dbox box;
+    for (auto& sphere : spheres)
+    {
+        if (!sphere.valid()) continue;
+        box.add(sphere.center - vsg::dvec3(sphere.radius, sphere.radius, sphere.radius));
+        box.add(sphere.center + vsg::dvec3(sphere.radius, sphere.radius, sphere.radius));
+    }
+    if (!box.valid()) return vsg::dsphere();
+
+    auto center = (box.min + box.max) * 0.5;
+    double radius = 0.0;
+    for (auto& sphere : spheres)
+    {
+        if (sphere.valid()) radius = std::max(radius, vsg::length(sphere.center - center) + sphere.radius);
+    }
+    return vsg::dsphere(center, radius);
+}
+
+vsg::dsphere osg2vsg::transformBoundingSphere(const vsg::dsphere& sphere, const vsg::dmat4& matrix)
+{
+    if (!sphere.valid()) return sphere;
+
+    double scale = std::max({vsg::length(vsg::dvec3(matrix[0][0], matrix[0][1], matrix[0][2])),
+                             vsg::length(vsg::dvec3(matrix[1][0], matrix[1][1], matrix[1][2])),
+                             vsg::length(vsg::dvec3(matrix[2][0], matrix[2][1], matrix[2][2]))});
+    return vsg::dsphere(matrix * sphere.center, sphere.radius * scale);
+}
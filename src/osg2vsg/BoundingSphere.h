@@ -0,0 +1,25 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <vector>
+
+namespace osg2vsg
+{
+    enum BoundingSphereMethod : uint32_t
+    {
+        BOUNDING_SPHERE_OSG,    // osg::Node::getBound(), the sphere around the bounding box for most geometry
+        BOUNDING_SPHERE_RITTER, // Ritter's sphere over the vertices, shrunk to the furthest vertex from its centre
+        BOUNDING_SPHERE_OBB     // also try the centre of the principal axes oriented bounding box, tighter for long thin objects at an angle to the axes
+    };
+
+    /// near minimal bounding sphere of vertices, computes the candidates of the method and returns the smallest, the sphere around the axis aligned bounding box is always a candidate.
+    vsg::dsphere computeBoundingSphere(const vsg::vec3* vertices, size_t count, BoundingSphereMethod method);
+
+    /// sphere enclosing spheres, centred on their bounding box.
+    vsg::dsphere computeBoundingSphere(const std::vector<vsg::dsphere>& spheres);
+
+    /// sphere enclosing sphere transformed by matrix.
+    vsg::dsphere transformBoundingSphere(const vsg::dsphere& sphere, const vsg::dmat4& matrix);
+
+} // namespace osg2vsg
@@ -10,9 +10,13 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 </editor-fold> */
 
+#include <osg2vsg/OSG.h>
+
 #include "BuildOptions.h"
 #include "ShaderUtils.h"
 
+#include <algorithm>
+
 #include "shaders/pbr_vert.cpp"
 #include "shaders/pbr_frag.cpp"
 
@@ -40,6 +44,47 @@ void BuildOptions::read(vsg::Input& input)
     input.read("vertexShaderPath", vertexShaderPath);
     input.read("fragmentShaderPath", fragmentShaderPath);
     input.read("extension", extension);
+    input.read("numThreads", numThreads);
+    input.readValue<uint32_t>("textureCompression", textureCompression);
+    input.read("textureCompressionQuality", textureCompressionQuality);
+    input.read("compressNormalMaps", compressNormalMaps);
+    input.readValue<uint32_t>("mipmapFilter", mipmapFilter);
+    input.read("sRGBMipmaps", sRGBMipmaps);
+    input.readValue<uint32_t>("textureDeduplication", textureDeduplication);
+    input.read("mergeGeometries", mergeGeometries);
+    input.read("maxMergedVertices", maxMergedVertices);
+    input.read("instanceGeometries", instanceGeometries);
+    input.read("minInstances", minInstances);
+    input.read("maxInstances", maxInstances);
+    input.read("buildCullGroupHierarchy", buildCullGroupHierarchy);
+    input.read("hierarchyFanOut", hierarchyFanOut);
+    input.read("hierarchyLeafSize", hierarchyLeafSize);
+    input.readValue<uint32_t>("boundingSphereMethod", boundingSphereMethod);
+    input.read("optimizeMeshes", optimizeMeshes);
+    input.read("vertexCacheSize", vertexCacheSize);
+    input.read("weldVertices", vertexWelding.enabled);
+    input.read("weldPositionEpsilon", vertexWelding.positionEpsilon);
+    input.read("weldNormalEpsilon", vertexWelding.normalEpsilon);
+    input.read("splitLargeMeshes", splitLargeMeshes);
+    input.read("triangleStrips", triangleStrips);
+    input.read("compressVertices", vertexCompression.enabled);
+    input.readValue<uint32_t>("texCoordCompression", vertexCompression.texCoordCompression);
+    input.read("compressionNormalTolerance", vertexCompression.normalTolerance);
+    input.read("compressionTexCoordTolerance", vertexCompression.texCoordTolerance);
+    input.read("compressionColorTolerance", vertexCompression.colorTolerance);
+    input.read("enforceCompressionTolerances", vertexCompression.enforceTolerances);
+    input.readValue<uint32_t>("positionCompression", vertexCompression.positionCompression);
+    input.read("positionTolerance", vertexCompression.positionTolerance);
+    input.read("simplifyMeshes", meshSimplification.enabled);
+    input.read("simplifyMinTriangles", meshSimplification.minTriangles);
+    input.read("simplifyLevels", meshSimplification.numLevels);
+    input.read("simplifyLevelRatio", meshSimplification.levelRatio);
+    input.read("simplifyMaxError", meshSimplification.maxError);
+    input.read("simplifyPixelError", meshSimplification.pixelError);
+    input.read("buildMeshlets", buildMeshlets);
+    input.read("maxMeshletVertices", maxMeshletVertices);
+    input.read("maxMeshletTriangles", maxMeshletTriangles);
+    input.read("pruneVertexAttributes", pruneVertexAttributes);
 }
 
 void BuildOptions::write(vsg::Output& output) const
@@ -62,6 +107,241 @@ void BuildOptions::write(vsg::Output& output) const
     output.write("vertexShaderPath", vertexShaderPath);
     output.write("fragmentShaderPath", fragmentShaderPath);
     output.write("extension", extension);
+    output.write("numThreads", numThreads);
+    output.writeValue<uint32_t>("textureCompression", textureCompression);
+    output.write("textureCompressionQuality", textureCompressionQuality);
+    output.write("compressNormalMaps", compressNormalMaps);
+    output.writeValue<uint32_t>("mipmapFilter", mipmapFilter);
+    output.write("sRGBMipmaps", sRGBMipmaps);
+    output.writeValue<uint32_t>("textureDeduplication", textureDeduplication);
+    output.write("mergeGeometries", mergeGeometries);
+    output.write("maxMergedVertices", maxMergedVertices);
+    output.write("instanceGeometries", instanceGeometries);
+    output.write("minInstances", minInstances);
+    output.write("maxInstances", maxInstances);
+    output.write("buildCullGroupHierarchy", buildCullGroupHierarchy);
+    output.write("hierarchyFanOut", hierarchyFanOut);
+    output.write("hierarchyLeafSize", hierarchyLeafSize);
+    output.writeValue<uint32_t>("boundingSphereMethod", boundingSphereMethod);
+    output.write("optimizeMeshes", optimizeMeshes);
+    output.write("vertexCacheSize", vertexCacheSize);
+    output.write("weldVertices", vertexWelding.enabled);
+    output.write("weldPositionEpsilon", vertexWelding.positionEpsilon);
+    output.write("weldNormalEpsilon", vertexWelding.normalEpsilon);
+    output.write("splitLargeMeshes", splitLargeMeshes);
+    output.write("triangleStrips", triangleStrips);
+    output.write("compressVertices", vertexCompression.enabled);
+    output.writeValue<uint32_t>("texCoordCompression", vertexCompression.texCoordCompression);
+    output.write("compressionNormalTolerance", vertexCompression.normalTolerance);
+    output.write("compressionTexCoordTolerance", vertexCompression.texCoordTolerance);
+    output.write("compressionColorTolerance", vertexCompression.colorTolerance);
+    output.write("enforceCompressionTolerances", vertexCompression.enforceTolerances);
+    output.writeValue<uint32_t>("positionCompression", vertexCompression.positionCompression);
+    output.write("positionTolerance", vertexCompression.positionTolerance);
+    output.write("simplifyMeshes", meshSimplification.enabled);
+    output.write("simplifyMinTriangles", meshSimplification.minTriangles);
+    output.write("simplifyLevels", meshSimplification.numLevels);
+    output.write("simplifyLevelRatio", meshSimplification.levelRatio);
+    output.write("simplifyMaxError", meshSimplification.maxError);
+    output.write("simplifyPixelError", meshSimplification.pixelError);
+    output.write("buildMeshlets", buildMeshlets);
+    output.write("maxMeshletVertices", maxMeshletVertices);
+    output.write("maxMeshletTriangles", maxMeshletTriangles);
+    output.write("pruneVertexAttributes", pruneVertexAttributes);
+}
+
+vsg::ref_ptr<BuildOptions> osg2vsg::readBuildOptions(vsg::ref_ptr<const vsg::Options> options)
+{
+    vsg::ref_ptr<BuildOptions> buildOptions;
+
+    std::string build_options_filename;
+    if (options && options->getValue(OSG::read_build_options, build_options_filename))
+    {
+        buildOptions = vsg::read_cast<BuildOptions>(build_options_filename, options);
+    }
+
+    if (!buildOptions)
+    {
+        buildOptions = BuildOptions::create();
+        buildOptions->mapRGBtoRGBAHint = !options || options->mapRGBtoRGBAHint;
+    }
+
+    // texture compression and mipmap settings change the converted output so are applied here, where the DiskCache keys are computed from
+    std::string texture_compression;
+    if (options && options->getValue(OSG::texture_compression, texture_compression))
+    {
+        if (texture_compression == "bc1") buildOptions->textureCompression = TEXTURE_COMPRESSION_BC1;
+        else if (texture_compression == "bc3") buildOptions->textureCompression = TEXTURE_COMPRESSION_BC3;
+        else if (texture_compression == "bc7") buildOptions->textureCompression = TEXTURE_COMPRESSION_BC7;
+        else if (texture_compression == "none") buildOptions->textureCompression = TEXTURE_COMPRESSION_NONE;
+        else vsg::warn("osg2vsg::readBuildOptions() unsupported texture_compression \"", texture_compression, "\", expected none, bc1, bc3 or bc7.");
+    }
+    buildOptions->textureCompressionQuality = vsg::value<uint32_t>(buildOptions->textureCompressionQuality, OSG::texture_compression_quality, options);
+    buildOptions->compressNormalMaps = vsg::value<bool>(buildOptions->compressNormalMaps, OSG::compress_normal_maps, options);
+
+    std::string mipmap_filter;
+    if (options && options->getValue(OSG::mipmap_filter, mipmap_filter))
+    {
+        if (mipmap_filter == "box") buildOptions->mipmapFilter = MIPMAP_FILTER_BOX;
+        else if (mipmap_filter == "kaiser") buildOptions->mipmapFilter = MIPMAP_FILTER_KAISER;
+        else if (mipmap_filter == "none") buildOptions->mipmapFilter = MIPMAP_FILTER_NONE;
+        else vsg::warn("osg2vsg::readBuildOptions() unsupported mipmap_filter \"", mipmap_filter, "\", expected none, box or kaiser.");
+    }
+    buildOptions->sRGBMipmaps = vsg::value<bool>(buildOptions->sRGBMipmaps, OSG::srgb_mipmaps, options);
+
+    std::string texture_deduplication;
+    if (options && options->getValue(OSG::texture_deduplication, texture_deduplication))
+    {
+        if (texture_deduplication == "scene") buildOptions->textureDeduplication = TEXTURE_DEDUPLICATION_SCENE;
+        else if (texture_deduplication == "process") buildOptions->textureDeduplication = TEXTURE_DEDUPLICATION_PROCESS;
+        else if (texture_deduplication == "shared") buildOptions->textureDeduplication = TEXTURE_DEDUPLICATION_SHARED;
+        else if (texture_deduplication == "none") buildOptions->textureDeduplication = TEXTURE_DEDUPLICATION_NONE;
+        else vsg::warn("osg2vsg::readBuildOptions() unsupported texture_deduplication \"", texture_deduplication, "\", expected none, scene, process or shared.");
+    }
+
+    buildOptions->mergeGeometries = vsg::value<bool>(buildOptions->mergeGeometries, OSG::merge_geometries, options);
+    buildOptions->maxMergedVertices = vsg::value<uint32_t>(buildOptions->maxMergedVertices, OSG::max_merged_vertices, options);
+    buildOptions->instanceGeometries = vsg::value<bool>(buildOptions->instanceGeometries, OSG::instance_geometries, options);
+    buildOptions->minInstances = vsg::value<uint32_t>(buildOptions->minInstances, OSG::min_instances, options);
+    buildOptions->maxInstances = vsg::value<uint32_t>(buildOptions->maxInstances, OSG::max_instances, options);
+    buildOptions->buildCullGroupHierarchy = vsg::value<bool>(buildOptions->buildCullGroupHierarchy, OSG::cull_group_hierarchy, options);
+    buildOptions->hierarchyFanOut = vsg::value<uint32_t>(buildOptions->hierarchyFanOut, OSG::hierarchy_fan_out, options);
+    buildOptions->hierarchyLeafSize = vsg::value<uint32_t>(buildOptions->hierarchyLeafSize, OSG::hierarchy_leaf_size, options);
+
+    std::string bounding_sphere;
+    if (options && options->getValue(OSG::bounding_sphere, bounding_sphere))
+    {
+        if (bounding_sphere == "osg") buildOptions->boundingSphereMethod = BOUNDING_SPHERE_OSG;
+        else if (bounding_sphere == "ritter") buildOptions->boundingSphereMethod = BOUNDING_SPHERE_RITTER;
+        else if (bounding_sphere == "obb") buildOptions->boundingSphereMethod = BOUNDING_SPHERE_OBB;
+        else vsg::warn("osg2vsg::readBuildOptions() unsupported bounding_sphere \"", bounding_sphere, "\", expected osg, ritter or obb.");
+    }
+
+    buildOptions->optimizeMeshes = vsg::value<bool>(buildOptions->optimizeMeshes, OSG::optimize_meshes, options);
+    buildOptions->vertexCacheSize = vsg::value<uint32_t>(buildOptions->vertexCacheSize, OSG::vertex_cache_size, options);
+    buildOptions->vertexWelding.enabled = vsg::value<bool>(buildOptions->vertexWelding.enabled, OSG::weld_vertices, options);
+    buildOptions->vertexWelding.positionEpsilon = vsg::value<float>(buildOptions->vertexWelding.positionEpsilon, OSG::weld_position_epsilon, options);
+    buildOptions->vertexWelding.normalEpsilon = vsg::value<float>(buildOptions->vertexWelding.normalEpsilon, OSG::weld_normal_epsilon, options);
+    buildOptions->splitLargeMeshes = vsg::value<bool>(buildOptions->splitLargeMeshes, OSG::split_large_meshes, options);
+    buildOptions->triangleStrips = vsg::value<bool>(buildOptions->triangleStrips, OSG::triangle_strips, options);
+
+    buildOptions->vertexCompression.enabled = vsg::value<bool>(buildOptions->vertexCompression.enabled, OSG::compress_vertices, options);
+    std::string texcoord_compression;
+    if (options && options->getValue(OSG::texcoord_compression, texcoord_compression))
+    {
+        if (texcoord_compression == "half") buildOptions->vertexCompression.texCoordCompression = TEXCOORD_COMPRESSION_HALF;
+        else if (texcoord_compression == "unorm16") buildOptions->vertexCompression.texCoordCompression = TEXCOORD_COMPRESSION_UNORM16;
+        else vsg::warn("osg2vsg::readBuildOptions() unsupported texcoord_compression \"", texcoord_compression, "\", expected half or unorm16.");
+    }
+    buildOptions->vertexCompression.normalTolerance = vsg::value<float>(buildOptions->vertexCompression.normalTolerance, OSG::compression_normal_tolerance, options);
+    buildOptions->vertexCompression.texCoordTolerance = vsg::value<float>(buildOptions->vertexCompression.texCoordTolerance, OSG::compression_texcoord_tolerance, options);
+    buildOptions->vertexCompression.colorTolerance = vsg::value<float>(buildOptions->vertexCompression.colorTolerance, OSG::compression_color_tolerance, options);
+    buildOptions->vertexCompression.enforceTolerances = vsg::value<bool>(buildOptions->vertexCompression.enforceTolerances, OSG::enforce_compression_tolerances, options);
+
+    std::string position_compression;
+    if (options && options->getValue(OSG::position_compression, position_compression))
+    {
+        if (position_compression == "unorm16") buildOptions->vertexCompression.positionCompression = POSITION_COMPRESSION_UNORM16;
+        else if (position_compression == "snorm16") buildOptions->vertexCompression.positionCompression = POSITION_COMPRESSION_SNORM16;
+        else if (position_compression == "none") buildOptions->vertexCompression.positionCompression = POSITION_COMPRESSION_NONE;
+        else vsg::warn("osg2vsg::readBuildOptions() unsupported position_compression \"", position_compression, "\", expected none, unorm16 or snorm16.");
+    }
+    buildOptions->vertexCompression.positionTolerance = vsg::value<float>(buildOptions->vertexCompression.positionTolerance, OSG::position_tolerance, options);
+
+    buildOptions->meshSimplification.enabled = vsg::value<bool>(buildOptions->meshSimplification.enabled, OSG::simplify_meshes, options);
+    buildOptions->meshSimplification.minTriangles = vsg::value<uint32_t>(buildOptions->meshSimplification.minTriangles, OSG::simplify_min_triangles, options);
+    buildOptions->meshSimplification.numLevels = vsg::value<uint32_t>(buildOptions->meshSimplification.numLevels, OSG::simplify_levels, options);
+    buildOptions->meshSimplification.levelRatio = vsg::value<float>(buildOptions->meshSimplification.levelRatio, OSG::simplify_level_ratio, options);
+    buildOptions->meshSimplification.maxError = vsg::value<float>(buildOptions->meshSimplification.maxError, OSG::simplify_max_error, options);
+    buildOptions->meshSimplification.pixelError = vsg::value<float>(buildOptions->meshSimplification.pixelError, OSG::simplify_pixel_error, options);
+
+    buildOptions->buildMeshlets = vsg::value<bool>(buildOptions->buildMeshlets, OSG::build_meshlets, options);
+    buildOptions->maxMeshletVertices = vsg::value<uint32_t>(buildOptions->maxMeshletVertices, OSG::max_meshlet_vertices, options);
+    buildOptions->maxMeshletTriangles = vsg::value<uint32_t>(buildOptions->maxMeshletTriangles, OSG::max_meshlet_triangles, options);
+
+    buildOptions->pruneVertexAttributes = vsg::value<bool>(buildOptions->pruneVertexAttributes, OSG::prune_vertex_attributes, options);
+
+    return buildOptions;
+}
+
+vsg::ref_ptr<PipelineCache> PipelineCache::instance()
+{
+    static vsg::ref_ptr<PipelineCache> s_pipelineCache = PipelineCache::create();
+    return s_pipelineCache;
+}
+
+vsg::ref_ptr<PipelineCache> PipelineCache::instance(const vsg::Options* options)
+{
+    if (options && options->sharedObjects) return options->sharedObjects->shared_default<PipelineCache>();
+    return instance();
+}
+
+vsg::ref_ptr<vsg::PipelineLayout> PipelineCache::getOrCreatePipelineLayout(uint32_t shaderModeMask)
+{
+    // the descriptor set layout only depends on the material and texture bindings, so pipelines that differ in other modes or in their vertex attributes share it
+    uint32_t layoutMask = shaderModeMask & (MATERIAL | DIFFUSE_MAP | OPACITY_MAP | AMBIENT_MAP | NORMAL_MAP | SPECULAR_MAP | AORM_MAP);
+
+    std::lock_guard<std::mutex> guard(mutex);
+    if (auto itr = pipelineLayoutMap.find(layoutMask); itr != pipelineLayoutMap.end())
+    {
+        ++numPipelineLayoutsReused;
+        return itr->second;
+    }
+
+    vsg::DescriptorSetLayoutBindings descriptorBindings;
+
+    // add material first, if any (for now material is hardcoded to binding MATERIAL_BINDING)
+    if (layoutMask & MATERIAL) descriptorBindings.push_back({MATERIAL_BINDING, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr}); // { binding, descriptorType, descriptorCount, stageFlags, pImmutableSamplers }
+
+    // these need to go in incremental order by texture unit value as that is how they will have been added to the descriptor set
+    // VkDescriptorSetLayoutBinding { binding, descriptorType, descriptorCount, stageFlags, pImmutableSamplers }
+    if (layoutMask & DIFFUSE_MAP) descriptorBindings.push_back({DIFFUSE_TEXTURE_UNIT, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr}); // { binding, descriptorType, descriptorCount, stageFlags, pImmutableSamplers }
+    if (layoutMask & OPACITY_MAP) descriptorBindings.push_back({OPACITY_TEXTURE_UNIT, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr});
+    if (layoutMask & AMBIENT_MAP) descriptorBindings.push_back({AMBIENT_TEXTURE_UNIT, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr});
+    if (layoutMask & NORMAL_MAP) descriptorBindings.push_back({NORMAL_TEXTURE_UNIT, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr});
+    if (layoutMask & SPECULAR_MAP) descriptorBindings.push_back({SPECULAR_TEXTURE_UNIT, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr});
+    if (layoutMask & AORM_MAP) descriptorBindings.push_back({AORM_TEXTURE_UNIT, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr });
+
+    ValueKey layoutKey;
+    for (auto& binding : descriptorBindings) appendValueKey(layoutKey, binding);
+
+    auto& descriptorSetLayout = descriptorSetLayoutMap[layoutKey];
+    if (descriptorSetLayout) ++numDescriptorSetLayoutsReused;
+    else descriptorSetLayout = vsg::DescriptorSetLayout::create(descriptorBindings);
+
+    vsg::DescriptorSetLayouts descriptorSetLayouts{descriptorSetLayout};
+
+    vsg::PushConstantRanges pushConstantRanges{
+        {VK_SHADER_STAGE_VERTEX_BIT, 0, 128} // projection and modelview matrices
+    };
+
+    auto pipelineLayout = vsg::PipelineLayout::create(descriptorSetLayouts, pushConstantRanges);
+    pipelineLayoutMap[layoutMask] = pipelineLayout;
+
+    return pipelineLayout;
+}
+
+vsg::ref_ptr<vsg::BindGraphicsPipeline> PipelineCache::getOrCreateBindGraphicsPipelineVariant(const vsg::BindGraphicsPipeline* bindGraphicsPipeline, uint32_t additionalGeometryMask, vsg::ref_ptr<const vsg::Options> options)
+{
+    Key key;
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        auto itr = std::find_if(pipelineMap.begin(), pipelineMap.end(), [&](const PipelineMap::value_type& entry) { return entry.second.get() == bindGraphicsPipeline; });
+        if (itr == pipelineMap.end()) return {};
+        key = itr->first;
+    }
+
+    auto& [shaderModeMask, geometryMask, vertShaderPath, fragShaderPath] = key;
+    return getOrCreateBindGraphicsPipeline(shaderModeMask, geometryMask | additionalGeometryMask, vertShaderPath, fragShaderPath, options);
+}
+
+void PipelineCache::report(std::ostream& out) const
+{
+    std::lock_guard<std::mutex> guard(mutex);
+    out << "PipelineCache " << this << std::endl;
+    out << "    pipelines created = " << numPipelinesCreated << ", reused = " << numPipelinesReused << std::endl;
+    out << "    pipeline layouts created = " << pipelineLayoutMap.size() << ", reused = " << numPipelineLayoutsReused << std::endl;
+    out << "    descriptor set layouts created = " << descriptorSetLayoutMap.size() << ", reused = " << numDescriptorSetLayoutsReused << std::endl;
 }
 
 vsg::ref_ptr<vsg::BindGraphicsPipeline> PipelineCache::getOrCreateBindGraphicsPipeline(uint32_t shaderModeMask, uint32_t geometryAttributesMask, const vsg::Path& vertShaderPath, const vsg::Path& fragShaderPath, vsg::ref_ptr<const vsg::Options> options)
@@ -71,7 +351,11 @@ vsg::ref_ptr<vsg::BindGraphicsPipeline> PipelineCache::getOrCreateBindGraphicsPi
     // check to see if pipeline has already been created
     {
         std::lock_guard<std::mutex> guard(mutex);
-        if (auto itr = pipelineMap.find(key); itr != pipelineMap.end()) return itr->second;
+        if (auto itr = pipelineMap.find(key); itr != pipelineMap.end())
+        {
+            ++numPipelinesReused;
+            return itr->second;
+        }
     }
 
     auto scs = vsg::ShaderCompileSettings::create();
@@ -91,26 +375,7 @@ vsg::ref_ptr<vsg::BindGraphicsPipeline> PipelineCache::getOrCreateBindGraphicsPi
 
     // std::cout<<"createBindGraphicsPipeline("<<shaderModeMask<<", "<<geometryAttributesMask<<")"<<std::endl;
 
-    vsg::DescriptorSetLayoutBindings descriptorBindings;
-
-    // add material first, if any (for now material is hardcoded to binding MATERIAL_BINDING)
-    if (shaderModeMask & MATERIAL) descriptorBindings.push_back({MATERIAL_BINDING, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr}); // { binding, descriptorType, descriptorCount, stageFlags, pImmutableSamplers }
-
-    // these need to go in incremental order by texture unit value as that is how they will have been added to the descriptor set
-    // VkDescriptorSetLayoutBinding { binding, descriptorType, descriptorCount, stageFlags, pImmutableSamplers }
-    if (shaderModeMask & DIFFUSE_MAP) descriptorBindings.push_back({DIFFUSE_TEXTURE_UNIT, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr}); // { binding, descriptorType, descriptorCount, stageFlags, pImmutableSamplers }
-    if (shaderModeMask & OPACITY_MAP) descriptorBindings.push_back({OPACITY_TEXTURE_UNIT, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr});
-    if (shaderModeMask & AMBIENT_MAP) descriptorBindings.push_back({AMBIENT_TEXTURE_UNIT, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr});
-    if (shaderModeMask & NORMAL_MAP) descriptorBindings.push_back({NORMAL_TEXTURE_UNIT, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr});
-    if (shaderModeMask & SPECULAR_MAP) descriptorBindings.push_back({SPECULAR_TEXTURE_UNIT, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr});
-    if (shaderModeMask & AORM_MAP) descriptorBindings.push_back({AORM_TEXTURE_UNIT, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr });
-
-    auto descriptorSetLayout = vsg::DescriptorSetLayout::create(descriptorBindings);
-    vsg::DescriptorSetLayouts descriptorSetLayouts{descriptorSetLayout};
-
-    vsg::PushConstantRanges pushConstantRanges{
-        {VK_SHADER_STAGE_VERTEX_BIT, 0, 128} // projection and modelview matrices
-    };
+    auto pipelineLayout = getOrCreatePipelineLayout(shaderModeMask);
 
     uint32_t vertexBindingIndex = 0;
 
@@ -118,6 +383,15 @@ vsg::ref_ptr<vsg::BindGraphicsPipeline> PipelineCache::getOrCreateBindGraphicsPi
     vsg::VertexInputState::Attributes vertexAttributeDescriptions;
 
     // setup vertex array
+    if (geometryAttributesMask & (VERTEX_UNORM16 | VERTEX_SNORM16))
+    {
+        // compressed positions are read as vec3, the parent transform maps them back onto the geometry's bounding box
+        VkFormat format = (geometryAttributesMask & VERTEX_SNORM16) ? VK_FORMAT_R16G16B16A16_SNORM : VK_FORMAT_R16G16B16A16_UNORM;
+        vertexBindingsDescriptions.push_back(VkVertexInputBindingDescription{vertexBindingIndex, sizeof(vsg::usvec4), VK_VERTEX_INPUT_RATE_VERTEX});
+        vertexAttributeDescriptions.push_back(VkVertexInputAttributeDescription{VERTEX_CHANNEL, vertexBindingIndex, format, 0});
+        vertexBindingIndex++;
+    }
+    else
     {
         vertexBindingsDescriptions.push_back(VkVertexInputBindingDescription{vertexBindingIndex, sizeof(vsg::vec3), VK_VERTEX_INPUT_RATE_VERTEX});
         vertexAttributeDescriptions.push_back(VkVertexInputAttributeDescription{VERTEX_CHANNEL, vertexBindingIndex, VK_FORMAT_R32G32B32_SFLOAT, 0});
@@ -127,28 +401,61 @@ vsg::ref_ptr<vsg::BindGraphicsPipeline> PipelineCache::getOrCreateBindGraphicsPi
     if (geometryAttributesMask & NORMAL)
     {
         VkVertexInputRate normal_rate = geometryAttributesMask & NORMAL_OVERALL ? VK_VERTEX_INPUT_RATE_INSTANCE : VK_VERTEX_INPUT_RATE_VERTEX;
-        vertexBindingsDescriptions.push_back(VkVertexInputBindingDescription{vertexBindingIndex, sizeof(vsg::vec3), normal_rate});
-        vertexAttributeDescriptions.push_back(VkVertexInputAttributeDescription{NORMAL_CHANNEL, vertexBindingIndex, VK_FORMAT_R32G32B32_SFLOAT, 0}); // normal as vec3
+        if (geometryAttributesMask & NORMAL_OCT16)
+        {
+            vertexBindingsDescriptions.push_back(VkVertexInputBindingDescription{vertexBindingIndex, sizeof(vsg::svec2), normal_rate});
+            vertexAttributeDescriptions.push_back(VkVertexInputAttributeDescription{NORMAL_CHANNEL, vertexBindingIndex, VK_FORMAT_R16G16_SNORM, 0}); // octahedral normal, decoded by VSG_OCT_NORMAL
+        }
+        else
+        {
+            vertexBindingsDescriptions.push_back(VkVertexInputBindingDescription{vertexBindingIndex, sizeof(vsg::vec3), normal_rate});
+            vertexAttributeDescriptions.push_back(VkVertexInputAttributeDescription{NORMAL_CHANNEL, vertexBindingIndex, VK_FORMAT_R32G32B32_SFLOAT, 0}); // normal as vec3
+        }
         vertexBindingIndex++;
     }
     if (geometryAttributesMask & TANGENT)
     {
         VkVertexInputRate tangent_rate = geometryAttributesMask & TANGENT_OVERALL ? VK_VERTEX_INPUT_RATE_INSTANCE : VK_VERTEX_INPUT_RATE_VERTEX;
-        vertexBindingsDescriptions.push_back(VkVertexInputBindingDescription{vertexBindingIndex, sizeof(vsg::vec4), tangent_rate});
-        vertexAttributeDescriptions.push_back(VkVertexInputAttributeDescription{TANGENT_CHANNEL, vertexBindingIndex, VK_FORMAT_R32G32B32A32_SFLOAT, 0}); // tangent as vec4
+        if (geometryAttributesMask & TANGENT_OCT16)
+        {
+            vertexBindingsDescriptions.push_back(VkVertexInputBindingDescription{vertexBindingIndex, sizeof(vsg::svec4), tangent_rate});
+            vertexAttributeDescriptions.push_back(VkVertexInputAttributeDescription{TANGENT_CHANNEL, vertexBindingIndex, VK_FORMAT_R16G16B16A16_SNORM, 0}); // octahedral tangent and handedness, decoded by VSG_OCT_TANGENT
+        }
+        else
+        {
+            vertexBindingsDescriptions.push_back(VkVertexInputBindingDescription{vertexBindingIndex, sizeof(vsg::vec4), tangent_rate});
+            vertexAttributeDescriptions.push_back(VkVertexInputAttributeDescription{TANGENT_CHANNEL, vertexBindingIndex, VK_FORMAT_R32G32B32A32_SFLOAT, 0}); // tangent as vec4
+        }
         vertexBindingIndex++;
     }
     if (geometryAttributesMask & COLOR)
     {
         VkVertexInputRate color_rate = geometryAttributesMask & COLOR_OVERALL ? VK_VERTEX_INPUT_RATE_INSTANCE : VK_VERTEX_INPUT_RATE_VERTEX;
-        vertexBindingsDescriptions.push_back(VkVertexInputBindingDescription{vertexBindingIndex, sizeof(vsg::vec4), color_rate});
-        vertexAttributeDescriptions.push_back(VkVertexInputAttributeDescription{COLOR_CHANNEL, vertexBindingIndex, VK_FORMAT_R32G32B32A32_SFLOAT, 0}); // color as vec4
+        if (geometryAttributesMask & COLOR_UNORM8)
+        {
+            vertexBindingsDescriptions.push_back(VkVertexInputBindingDescription{vertexBindingIndex, sizeof(vsg::ubvec4), color_rate});
+            vertexAttributeDescriptions.push_back(VkVertexInputAttributeDescription{COLOR_CHANNEL, vertexBindingIndex, VK_FORMAT_R8G8B8A8_UNORM, 0}); // color as ubvec4, read as vec4
+        }
+        else
+        {
+            vertexBindingsDescriptions.push_back(VkVertexInputBindingDescription{vertexBindingIndex, sizeof(vsg::vec4), color_rate});
+            vertexAttributeDescriptions.push_back(VkVertexInputAttributeDescription{COLOR_CHANNEL, vertexBindingIndex, VK_FORMAT_R32G32B32A32_SFLOAT, 0}); // color as vec4
+        }
         vertexBindingIndex++;
     }
     if (geometryAttributesMask & TEXCOORD0)
     {
-        vertexBindingsDescriptions.push_back(VkVertexInputBindingDescription{vertexBindingIndex, sizeof(vsg::vec2), VK_VERTEX_INPUT_RATE_VERTEX});
-        vertexAttributeDescriptions.push_back(VkVertexInputAttributeDescription{TEXCOORD0_CHANNEL, vertexBindingIndex, VK_FORMAT_R32G32_SFLOAT, 0}); // texcoord as vec2
+        if (geometryAttributesMask & (TEXCOORD0_HALF | TEXCOORD0_UNORM16))
+        {
+            VkFormat format = (geometryAttributesMask & TEXCOORD0_UNORM16) ? VK_FORMAT_R16G16_UNORM : VK_FORMAT_R16G16_SFLOAT;
+            vertexBindingsDescriptions.push_back(VkVertexInputBindingDescription{vertexBindingIndex, sizeof(vsg::usvec2), VK_VERTEX_INPUT_RATE_VERTEX});
+            vertexAttributeDescriptions.push_back(VkVertexInputAttributeDescription{TEXCOORD0_CHANNEL, vertexBindingIndex, format, 0}); // texcoord as 16 bit values, read as vec2
+        }
+        else
+        {
+            vertexBindingsDescriptions.push_back(VkVertexInputBindingDescription{vertexBindingIndex, sizeof(vsg::vec2), VK_VERTEX_INPUT_RATE_VERTEX});
+            vertexAttributeDescriptions.push_back(VkVertexInputAttributeDescription{TEXCOORD0_CHANNEL, vertexBindingIndex, VK_FORMAT_R32G32_SFLOAT, 0}); // texcoord as vec2
+        }
         vertexBindingIndex++;
     }
     if (geometryAttributesMask & TRANSLATE)
@@ -158,8 +465,16 @@ vsg::ref_ptr<vsg::BindGraphicsPipeline> PipelineCache::getOrCreateBindGraphicsPi
         vertexAttributeDescriptions.push_back(VkVertexInputAttributeDescription{TRANSLATE_CHANNEL, vertexBindingIndex, VK_FORMAT_R32G32B32_SFLOAT, 0}); // translation as vec3
         vertexBindingIndex++;
     }
-
-    auto pipelineLayout = vsg::PipelineLayout::create(descriptorSetLayouts, pushConstantRanges);
+    if (geometryAttributesMask & INSTANCE_TRANSFORM)
+    {
+        // a mat4 input is passed as four consecutive vec4 columns
+        vertexBindingsDescriptions.push_back(VkVertexInputBindingDescription{vertexBindingIndex, sizeof(vsg::mat4), VK_VERTEX_INPUT_RATE_INSTANCE});
+        for (uint32_t column = 0; column < 4; ++column)
+        {
+            vertexAttributeDescriptions.push_back(VkVertexInputAttributeDescription{INSTANCE_TRANSFORM_CHANNEL + column, vertexBindingIndex, VK_FORMAT_R32G32B32A32_SFLOAT, static_cast<uint32_t>(column * sizeof(vsg::vec4))});
+        }
+        vertexBindingIndex++;
+    }
 
     // if blending is requested setup appropriate colorblendstate
     vsg::ColorBlendState::ColorBlendAttachments colorBlendAttachments;
@@ -183,9 +498,17 @@ vsg::ref_ptr<vsg::BindGraphicsPipeline> PipelineCache::getOrCreateBindGraphicsPi
 
     colorBlendAttachments.push_back(colorBlendAttachment);
 
+    // triangle strips are joined with primitive restart indices
+    auto inputAssemblyState = vsg::InputAssemblyState::create();
+    if (geometryAttributesMask & TRIANGLE_STRIP_TOPOLOGY)
+    {
+        inputAssemblyState->topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+        inputAssemblyState->primitiveRestartEnable = VK_TRUE;
+    }
+
     vsg::GraphicsPipelineStates pipelineStates{
         vsg::VertexInputState::create(vertexBindingsDescriptions, vertexAttributeDescriptions),
-        vsg::InputAssemblyState::create(),
+        inputAssemblyState,
         vsg::RasterizationState::create(),
         vsg::MultisampleState::create(),
         vsg::ColorBlendState::create(colorBlendAttachments),
@@ -197,8 +520,15 @@ vsg::ref_ptr<vsg::BindGraphicsPipeline> PipelineCache::getOrCreateBindGraphicsPi
     vsg::ref_ptr<vsg::GraphicsPipeline> graphicsPipeline = vsg::GraphicsPipeline::create(pipelineLayout, shaders, pipelineStates);
     auto bindGraphicsPipeline = vsg::BindGraphicsPipeline::create(graphicsPipeline);
 
-    // assign the pipeline to cache.
+    // assign the pipeline to cache, if another thread has created the same pipeline in the meantime use that one so all users share it.
     std::lock_guard<std::mutex> guard(mutex);
+    if (auto itr = pipelineMap.find(key); itr != pipelineMap.end())
+    {
+        ++numPipelinesReused;
+        return itr->second;
+    }
+
+    ++numPipelinesCreated;
     pipelineMap[key] = bindGraphicsPipeline;
 
     return bindGraphicsPipeline;
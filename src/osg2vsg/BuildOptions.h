@@ -2,20 +2,48 @@
 
 #include <vsg/all.h>
 
+#include "BoundingSphere.h"
+#include "ConversionCache.h"
 #include "GeometryUtils.h"
+#include "Mipmaps.h"
 #include "ShaderUtils.h"
+#include "TaskScheduler.h"
+#include "TextureCompression.h"
 
 namespace osg2vsg
 {
+    /// cache of the pipelines and pipeline layouts used by converted subgraphs, shared between reads so that vsg's compile traversal only compiles each pipeline once.
     struct PipelineCache : public vsg::Inherit<vsg::Object, PipelineCache>
     {
         using Key = std::tuple<uint32_t, uint32_t, vsg::Path, vsg::Path>;
         using PipelineMap = std::map<Key, vsg::ref_ptr<vsg::BindGraphicsPipeline>>;
+        using PipelineLayoutMap = std::map<uint32_t, vsg::ref_ptr<vsg::PipelineLayout>>;
+        using DescriptorSetLayoutMap = std::map<ValueKey, vsg::ref_ptr<vsg::DescriptorSetLayout>>;
 
-        std::mutex mutex;
+        /// process wide PipelineCache
+        static vsg::ref_ptr<PipelineCache> instance();
+
+        /// PipelineCache shared through options->sharedObjects if assigned, otherwise the process wide instance()
+        static vsg::ref_ptr<PipelineCache> instance(const vsg::Options* options);
+
+        mutable std::mutex mutex;
         PipelineMap pipelineMap;
+        PipelineLayoutMap pipelineLayoutMap;
+        DescriptorSetLayoutMap descriptorSetLayoutMap; // interned by their bindings
+
+        std::atomic<uint64_t> numPipelinesCreated = 0;
+        std::atomic<uint64_t> numPipelinesReused = 0;
+        std::atomic<uint64_t> numPipelineLayoutsReused = 0;
+        std::atomic<uint64_t> numDescriptorSetLayoutsReused = 0;
+
+        vsg::ref_ptr<vsg::PipelineLayout> getOrCreatePipelineLayout(uint32_t shaderModeMask);
 
         vsg::ref_ptr<vsg::BindGraphicsPipeline> getOrCreateBindGraphicsPipeline(uint32_t shaderModeMask, uint32_t geometryMask, const vsg::Path& vertShaderPath, const vsg::Path& fragShaderPath, vsg::ref_ptr<const vsg::Options> options);
+
+        /// return the variant of a pipeline created by this cache with additionalGeometryMask enabled, or null if bindGraphicsPipeline wasn't created by this cache.
+        vsg::ref_ptr<vsg::BindGraphicsPipeline> getOrCreateBindGraphicsPipelineVariant(const vsg::BindGraphicsPipeline* bindGraphicsPipeline, uint32_t additionalGeometryMask, vsg::ref_ptr<const vsg::Options> options);
+
+        void report(std::ostream& out) const;
     };
 
     struct BuildOptions : public vsg::Inherit<vsg::Object, BuildOptions>
@@ -46,8 +74,75 @@ namespace osg2vsg
 
         vsg::Path extension = "vsgb";
 
+        // number of threads used to convert independent subgraphs in parallel, 0 or 1 converts on the calling thread
+        uint32_t numThreads = 0;
+
+        // block compress uncompressed 8 bit RGB(A) textures on the CPU, trading encode time at conversion for GPU memory and upload bandwidth
+        TextureCompression textureCompression = TEXTURE_COMPRESSION_NONE;
+        uint32_t textureCompressionQuality = TEXTURE_COMPRESSION_NORMAL;
+        bool compressNormalMaps = false; // normal maps lose noticeable precision in BC1/BC3 so are left uncompressed by default
+
+        // generate the mipmaps of textures that need them on the CPU, rather than on the GPU as each texture is compiled
+        MipmapFilter mipmapFilter = MIPMAP_FILTER_NONE;
+        bool sRGBMipmaps = false; // filter RGB in linear space, treating colour textures as sRGB encoded
+
+        // share converted textures between osg::Texture objects with the same image data and sampler settings, textureContentCache is assigned by osg2vsg::convert() to match the scope
+        TextureDeduplication textureDeduplication = TEXTURE_DEDUPLICATION_SCENE;
+
+        // merge sibling geometries that share the same pipeline and descriptor set into batches of at most maxMergedVertices, reducing the number of draws recorded
+        bool mergeGeometries = false;
+        uint32_t maxMergedVertices = 65536;
+
+        // draw geometry repeated under at least minInstances sibling transforms with instanced draws of spatially close groups of at most maxInstances
+        bool instanceGeometries = false;
+        uint32_t minInstances = 4;
+        uint32_t maxInstances = 64;
+
+        // build a balanced hierarchy of CullGroups over groups with more than hierarchyLeafSize children
+        bool buildCullGroupHierarchy = false;
+        uint32_t hierarchyFanOut = 4;
+        uint32_t hierarchyLeafSize = 16;
+
+        // compute the bounding spheres of CullNodes and DepthSorted nodes from the vertices, rather than using the looser osg::Node::getBound()
+        BoundingSphereMethod boundingSphereMethod = BOUNDING_SPHERE_RITTER;
+
+        // reorder the triangles and vertices of converted meshes for a vertex cache of vertexCacheSize entries, reduced overdraw and sequential vertex fetch
+        bool optimizeMeshes = false;
+        uint32_t vertexCacheSize = 16;
+
+        // merge duplicate vertices across all the per vertex arrays as geometry is converted
+        VertexWelding vertexWelding;
+
+        // split meshes too large for 16 bit indices into chunks of at most 65535 vertices, each drawn with its own DrawIndexed
+        bool splitLargeMeshes = false;
+
+        // draw meshes as triangle strips joined by primitive restart indices when that gives a smaller index array than the triangle list
+        bool triangleStrips = false;
+
+        // quantize normals, tangents, texcoords and colours to smaller vertex formats, leaving any stream whose error exceeds its tolerance uncompressed,
+        // and optionally positions to 16 bits relative to each geometry's bounding box
+        VertexCompression vertexCompression;
+
+        // generate reduced levels of geometry with many triangles, drawn through a vsg::LOD that switches to each once its simplification error is below a pixel on screen
+        MeshSimplification meshSimplification;
+
+        // partition the triangle lists of the converted draws into meshlets, attaching their bounds and backface cones to each VertexIndexDraw for GPU driven culling
+        bool buildMeshlets = false;
+        uint32_t maxMeshletVertices = 64; // at most 256 as meshlet triangles use 8 bit local indices
+        uint32_t maxMeshletTriangles = 124;
+
+        // leave out the vertex attributes the selected shader variant doesn't read, such as texcoords without texture maps, from both the pipeline and the vertex buffers.
+        // Skipped when vertexShaderPath or fragmentShaderPath is set, as custom shaders may read inputs beyond those enabled by their shader mode defines.
+        bool pruneVertexAttributes = true;
+
         vsg::ref_ptr<PipelineCache> pipelineCache;
+        vsg::ref_ptr<TaskScheduler> scheduler;
+        vsg::ref_ptr<ConversionCache> conversionCache;
+        vsg::ref_ptr<TextureContentCache> textureContentCache;
     };
+
+    /// read the BuildOptions from the file specified by the OSG::read_build_options option, or create the default BuildOptions if none is specified.
+    extern vsg::ref_ptr<BuildOptions> readBuildOptions(vsg::ref_ptr<const vsg::Options> options);
 } // namespace osg2vsg
 
 EVSG_type_name(osg2vsg::BuildOptions);
@@ -0,0 +1,209 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2026 the osg2vsg authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "ConversionCache.h"
+
+using namespace osg2vsg;
+
+SceneCache::SceneCache()
+{
+}
+
+SceneCache::~SceneCache()
+{
+}
+
+osg::ref_ptr<osg::StateSet> SceneCache::uniqueState(osg::ref_ptr<osg::StateSet> stateset)
+{
+    std::scoped_lock<std::mutex> lock(_uniqueStateMutex);
+
+    if (auto itr = _uniqueStateSets.find(stateset); itr != _uniqueStateSets.end())
+    {
+        ++uniqueStateHits;
+        return *itr;
+    }
+
+    ++uniqueStateMisses;
+    _uniqueStateSets.insert(stateset);
+    return stateset;
+}
+
+vsg::ref_ptr<vsg::DescriptorSet> SceneCache::uniqueDescriptorSet(vsg::ref_ptr<vsg::DescriptorSet> descriptorSet)
+{
+    if (!descriptorSet) return descriptorSet;
+
+    ValueKey key;
+    appendValueKey(key, descriptorSet->setLayout.get());
+    for (auto& descriptor : descriptorSet->descriptors)
+    {
+        appendValueKey(key, descriptor->dstBinding);
+        appendValueKey(key, descriptor->dstArrayElement);
+        appendValueKey(key, descriptor->descriptorType);
+
+        // descriptors rebound to another binding share the ImageInfo and BufferInfo of the interned originals, so these are compared rather than the descriptors
+        if (auto descriptorImage = descriptor.cast<vsg::DescriptorImage>())
+        {
+            for (auto& imageInfo : descriptorImage->imageInfoList) appendValueKey(key, imageInfo.get());
+        }
+        else if (auto descriptorBuffer = descriptor.cast<vsg::DescriptorBuffer>())
+        {
+            for (auto& bufferInfo : descriptorBuffer->bufferInfoList) appendValueKey(key, bufferInfo.get());
+        }
+        else
+        {
+            appendValueKey(key, descriptor.get());
+        }
+    }
+
+    return descriptorSets.getOrCreate(key, [&]() { return descriptorSet; });
+}
+
+vsg::ref_ptr<vsg::BindDescriptorSet> SceneCache::uniqueBindDescriptorSet(vsg::ref_ptr<vsg::BindDescriptorSet> bindDescriptorSet)
+{
+    if (!bindDescriptorSet) return bindDescriptorSet;
+
+    ValueKey key;
+    appendValueKey(key, bindDescriptorSet->pipelineBindPoint);
+    appendValueKey(key, bindDescriptorSet->layout.get());
+    appendValueKey(key, bindDescriptorSet->firstSet);
+    appendValueKey(key, bindDescriptorSet->descriptorSet.get());
+
+    return uniqueBindDescriptorSets.getOrCreate(key, [&]() { return bindDescriptorSet; });
+}
+
+ConversionCache::ConversionCache()
+{
+}
+
+ConversionCache::~ConversionCache()
+{
+}
+
+vsg::ref_ptr<vsg::Sampler> ConversionCache::uniqueSampler(vsg::ref_ptr<vsg::Sampler> sampler)
+{
+    if (!sampler) return sampler;
+
+    ValueKey key;
+    appendValueKey(key, sampler->flags);
+    appendValueKey(key, sampler->magFilter);
+    appendValueKey(key, sampler->minFilter);
+    appendValueKey(key, sampler->mipmapMode);
+    appendValueKey(key, sampler->addressModeU);
+    appendValueKey(key, sampler->addressModeV);
+    appendValueKey(key, sampler->addressModeW);
+    appendValueKey(key, sampler->mipLodBias);
+    appendValueKey(key, sampler->anisotropyEnable);
+    appendValueKey(key, sampler->maxAnisotropy);
+    appendValueKey(key, sampler->compareEnable);
+    appendValueKey(key, sampler->compareOp);
+    appendValueKey(key, sampler->minLod);
+    appendValueKey(key, sampler->maxLod);
+    appendValueKey(key, sampler->borderColor);
+    appendValueKey(key, sampler->unnormalizedCoordinates);
+
+    return samplers.getOrCreate(key, [&]() { return sampler; });
+}
+
+vsg::ref_ptr<vsg::DescriptorBuffer> ConversionCache::uniqueMaterial(vsg::ref_ptr<vsg::materialValue> material, uint32_t binding)
+{
+    if (!material) return {};
+
+    ValueKey key;
+    appendValueKey(key, binding);
+    appendValueKey(key, material->value());
+
+    return materials.getOrCreate(key, [&]() { return vsg::DescriptorBuffer::create(material, binding); });
+}
+
+void ConversionCache::addSceneCacheCounts(const SceneCache& sceneCache)
+{
+    statePairs.add(sceneCache.statePairs.hits, sceneCache.statePairs.misses);
+    uniqueStates.add(sceneCache.uniqueStateHits, sceneCache.uniqueStateMisses);
+    textures.add(sceneCache.textures.hits, sceneCache.textures.misses);
+    bindDescriptorSets.add(sceneCache.bindDescriptorSets.hits, sceneCache.bindDescriptorSets.misses);
+    descriptorSets.add(sceneCache.descriptorSets.hits, sceneCache.descriptorSets.misses);
+    uniqueBindDescriptorSets.add(sceneCache.uniqueBindDescriptorSets.hits, sceneCache.uniqueBindDescriptorSets.misses);
+    vertexBounds.add(sceneCache.vertexBounds.hits, sceneCache.vertexBounds.misses);
+    tangents.add(sceneCache.tangents.hits, sceneCache.tangents.misses);
+    geometryStatistics.add(sceneCache.geometryStatistics);
+}
+
+void ConversionCache::clear()
+{
+    samplers.clear();
+    materials.clear();
+}
+
+void ConversionCache::report(std::ostream& out) const
+{
+    auto print = [&out](const char* name, uint64_t hits, uint64_t misses) {
+        out << "    " << name << " hits = " << hits << ", misses = " << misses << std::endl;
+    };
+
+    out << "ConversionCache " << this << std::endl;
+    print("statePairs", statePairs.hits, statePairs.misses);
+    print("uniqueStates", uniqueStates.hits, uniqueStates.misses);
+    print("textures", textures.hits, textures.misses);
+    print("bindDescriptorSets", bindDescriptorSets.hits, bindDescriptorSets.misses);
+    print("samplers", samplers.hits, samplers.misses);
+    print("materials", materials.hits, materials.misses);
+    print("descriptorSets", descriptorSets.hits, descriptorSets.misses);
+    print("uniqueBindDescriptorSets", uniqueBindDescriptorSets.hits, uniqueBindDescriptorSets.misses);
+    print("vertexBounds", vertexBounds.hits, vertexBounds.misses);
+    print("tangents", tangents.hits, tangents.misses);
+    out << "    index bytes = " << geometryStatistics.indexBytes << ", saved by 16 bit indices = " << geometryStatistics.indexBytesSaved << ", meshes split = " << geometryStatistics.numMeshesSplit << std::endl;
+    out << "    meshes drawn as triangle strips = " << geometryStatistics.numMeshesStripped << ", index bytes saved = " << geometryStatistics.stripBytesSaved << std::endl;
+    out << "    vertex bytes = " << geometryStatistics.vertexBytes << ", saved by compression = " << geometryStatistics.vertexBytesSaved << ", streams left uncompressed = " << geometryStatistics.numStreamsRejected << std::endl;
+    out << "    meshes simplified = " << geometryStatistics.numMeshesSimplified << ", triangles = " << geometryStatistics.simplifiedTriangles << ", reduced levels =";
+    for (auto& levelTriangles : geometryStatistics.levelTriangles) out << " " << levelTriangles;
+    out << std::endl;
+    out << "    vertex streams pruned = " << geometryStatistics.numStreamsPruned << ", bytes = " << geometryStatistics.vertexBytesPruned << std::endl;
+}
+
+TextureContentCache::TextureContentCache()
+{
+}
+
+TextureContentCache::~TextureContentCache()
+{
+}
+
+vsg::ref_ptr<TextureContentCache> TextureContentCache::instance()
+{
+    static vsg::ref_ptr<TextureContentCache> s_textureContentCache = TextureContentCache::create();
+    return s_textureContentCache;
+}
+
+size_t TextureContentCache::dataSize(const vsg::DescriptorImage& texture)
+{
+    size_t size = 0;
+    for (auto& imageInfo : texture.imageInfoList)
+    {
+        if (imageInfo && imageInfo->imageView && imageInfo->imageView->image && imageInfo->imageView->image->data)
+        {
+            size += imageInfo->imageView->image->data->dataSize();
+        }
+    }
+    return size;
+}
+
+void TextureContentCache::clear()
+{
+    textures.clear();
+}
+
+void TextureContentCache::report(std::ostream& out) const
+{
+    out << "TextureContentCache " << this << std::endl;
+    out << "    textures hits = " << textures.hits << ", misses = " << textures.misses << std::endl;
+    out << "    duplicate textures = " << duplicateTextures << ", bytes saved = " << duplicateTextureBytes << std::endl;
+}
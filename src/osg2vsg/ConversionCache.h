@@ -0,0 +1,354 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <osg/Array>
+#include <osg/StateSet>
+#include <osg/Texture>
+
+#include "GeometryUtils.h"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace osg2vsg
+{
+    using StateStack = std::vector<osg::ref_ptr<osg::StateSet>>;
+    using StatePair = std::pair<osg::ref_ptr<osg::StateSet>, osg::ref_ptr<osg::StateSet>>;
+    using MasksAndState = std::tuple<uint32_t, uint32_t, osg::ref_ptr<osg::StateSet>>;
+    using TextureKey = std::pair<osg::ref_ptr<const osg::Texture>, bool>; // texture and whether it's used as a normal map
+
+    struct UniqueStateSet
+    {
+        bool operator()(const osg::ref_ptr<osg::StateSet>& lhs, const osg::ref_ptr<osg::StateSet>& rhs) const
+        {
+            if (!lhs) return true;
+            if (!rhs) return false;
+            return lhs->compare(*rhs) < 0;
+        }
+    };
+
+    inline size_t hash_pointer(const void* ptr)
+    {
+        // mix the bits so aligned addresses spread evenly across shards and buckets
+        auto value = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(ptr));
+        value ^= value >> 33;
+        value *= 0xff51afd7ed558ccdULL;
+        value ^= value >> 33;
+        return static_cast<size_t>(value);
+    }
+
+    inline void hash_combine(size_t& seed, size_t value)
+    {
+        seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    }
+
+    /// bytes of the values an object is built from, so objects can be interned by value rather than by pointer
+    using ValueKey = std::string;
+
+    template<typename T>
+    void appendValueKey(ValueKey& key, const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "appendValueKey(key, value) requires a trivially copyable type.");
+        key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    struct RefPtrHash
+    {
+        template<class T>
+        size_t operator()(const osg::ref_ptr<T>& ptr) const { return hash_pointer(ptr.get()); }
+    };
+
+    struct StateStackHash
+    {
+        size_t operator()(const StateStack& stack) const
+        {
+            size_t seed = stack.size();
+            for (auto& stateset : stack) hash_combine(seed, hash_pointer(stateset.get()));
+            return seed;
+        }
+    };
+
+    struct TextureKeyHash
+    {
+        size_t operator()(const TextureKey& key) const
+        {
+            size_t seed = hash_pointer(key.first.get());
+            hash_combine(seed, key.second ? 1 : 0);
+            return seed;
+        }
+    };
+
+    struct MasksAndStateHash
+    {
+        size_t operator()(const MasksAndState& masksAndState) const
+        {
+            size_t seed = std::get<0>(masksAndState);
+            hash_combine(seed, std::get<1>(masksAndState));
+            hash_combine(seed, hash_pointer(std::get<2>(masksAndState).get()));
+            return seed;
+        }
+    };
+
+    /// thread safe map split into independently locked shards.
+    /// getOrCreate() calls create() at most once per key, other threads requesting the same key wait for that value rather than creating their own.
+    template<class Key, class Value, class Hash>
+    class ShardedMap
+    {
+    public:
+        static constexpr size_t numShards = 16;
+
+        template<class Create>
+        Value getOrCreate(const Key& key, Create create)
+        {
+            auto& shard = _shards[Hash()(key) % numShards];
+
+            std::shared_ptr<Entry> entry;
+            {
+                std::scoped_lock<std::mutex> lock(shard.mutex);
+                auto& slot = shard.entries[key];
+                if (slot)
+                {
+                    ++hits;
+                }
+                else
+                {
+                    slot = std::make_shared<Entry>();
+                    ++misses;
+                }
+                entry = slot;
+            }
+
+            // create outside the shard lock so expensive conversions of different keys don't serialize
+            std::call_once(entry->once, [&]() { entry->value = create(); });
+            return entry->value;
+        }
+
+        size_t size() const
+        {
+            size_t count = 0;
+            for (auto& shard : _shards)
+            {
+                std::scoped_lock<std::mutex> lock(shard.mutex);
+                count += shard.entries.size();
+            }
+            return count;
+        }
+
+        void clear()
+        {
+            for (auto& shard : _shards)
+            {
+                std::scoped_lock<std::mutex> lock(shard.mutex);
+                shard.entries.clear();
+            }
+        }
+
+        std::atomic<uint64_t> hits = 0;
+        std::atomic<uint64_t> misses = 0;
+
+    protected:
+        struct Entry
+        {
+            std::once_flag once;
+            Value value;
+        };
+
+        struct Shard
+        {
+            mutable std::mutex mutex;
+            std::unordered_map<Key, std::shared_ptr<Entry>, Hash> entries;
+        };
+
+        std::array<Shard, numShards> _shards;
+    };
+
+    enum TextureDeduplication : uint32_t
+    {
+        TEXTURE_DEDUPLICATION_NONE,    // only textures sharing the same osg::Texture are shared
+        TEXTURE_DEDUPLICATION_SCENE,   // textures with matching image data and sampler settings are shared within each converted scene
+        TEXTURE_DEDUPLICATION_PROCESS, // textures are shared by all the conversions in the process
+        TEXTURE_DEDUPLICATION_SHARED   // textures are shared by the conversions using the same vsg::Options::sharedObjects
+    };
+
+    /// layout and bytes of a texture's image data and the sampler and build settings that affect its conversion, kept in full so matching hashes alone never share a texture
+    struct TextureContentKey
+    {
+        uint64_t imageHash = 0;
+        ValueKey image;
+        ValueKey settings;
+
+        bool operator==(const TextureContentKey& rhs) const { return imageHash == rhs.imageHash && settings == rhs.settings && image == rhs.image; }
+    };
+
+    struct TextureContentKeyHash
+    {
+        size_t operator()(const TextureContentKey& key) const
+        {
+            size_t seed = static_cast<size_t>(key.imageHash);
+            hash_combine(seed, std::hash<ValueKey>()(key.settings));
+            return seed;
+        }
+    };
+
+    /// converted textures keyed by the content of the osg::Texture they were converted from, so separate osg::Texture objects referencing the same image data share a single vsg::DescriptorImage.
+    /// Each entry keeps a copy of its source image data, so a lookup only matches textures with identical bytes.
+    class TextureContentCache : public vsg::Inherit<vsg::Object, TextureContentCache>
+    {
+    public:
+        TextureContentCache();
+
+        /// process wide TextureContentCache
+        static vsg::ref_ptr<TextureContentCache> instance();
+
+        ShardedMap<TextureContentKey, vsg::ref_ptr<vsg::DescriptorImage>, TextureContentKeyHash> textures;
+
+        std::atomic<uint64_t> duplicateTextures = 0;
+        std::atomic<uint64_t> duplicateTextureBytes = 0;
+
+        /// return the texture converted for key, calling create() if there isn't one yet. duplicate is set when an existing texture is returned.
+        template<class Create>
+        vsg::ref_ptr<vsg::DescriptorImage> getOrCreate(const TextureContentKey& key, Create create, bool& duplicate)
+        {
+            bool created = false;
+            auto texture = textures.getOrCreate(key, [&]() {
+                created = true;
+                return create();
+            });
+
+            duplicate = !created && texture;
+            if (duplicate)
+            {
+                ++duplicateTextures;
+                duplicateTextureBytes += dataSize(*texture);
+            }
+            return texture;
+        }
+
+        /// size of the image data bound by texture
+        static size_t dataSize(const vsg::DescriptorImage& texture);
+
+        /// remove all cached entries, must not be called while converters are using the cache.
+        void clear();
+
+        void report(std::ostream& out) const;
+
+    protected:
+        virtual ~TextureContentCache();
+    };
+
+    /// caches keyed by the OSG objects of the scene being converted, shared by the converters of a single convert() call running on different threads.
+    /// The keys and values hold references to the scene's OSG objects, so a SceneCache is discarded once its scene is converted rather than shared between reads.
+    class SceneCache : public vsg::Inherit<vsg::Object, SceneCache>
+    {
+    public:
+        SceneCache();
+
+        ShardedMap<StateStack, StatePair, StateStackHash> statePairs;
+        ShardedMap<TextureKey, vsg::ref_ptr<vsg::DescriptorImage>, TextureKeyHash> textures;
+        ShardedMap<MasksAndState, vsg::ref_ptr<vsg::BindDescriptorSet>, MasksAndStateHash> bindDescriptorSets;
+
+        // bounding spheres of vertex arrays, so geometries sharing their vertices only compute them once
+        ShardedMap<osg::ref_ptr<const osg::Array>, vsg::dsphere, RefPtrHash> vertexBounds;
+
+        // tangents generated for geometries without them, so shared geometries only generate them once
+        ShardedMap<osg::ref_ptr<const osg::Geometry>, vsg::ref_ptr<vsg::Data>, RefPtrHash> tangents;
+
+        // interning tables keyed by the addresses of the scene's descriptors, they hold the scene's textures so are only kept for the scene's conversion
+        ShardedMap<ValueKey, vsg::ref_ptr<vsg::DescriptorSet>, std::hash<ValueKey>> descriptorSets;
+        ShardedMap<ValueKey, vsg::ref_ptr<vsg::BindDescriptorSet>, std::hash<ValueKey>> uniqueBindDescriptorSets;
+
+        /// return the first StateSet added that matches stateset, or stateset if no match has been added yet.
+        osg::ref_ptr<osg::StateSet> uniqueState(osg::ref_ptr<osg::StateSet> stateset);
+
+        /// descriptor sets are matched by layout and by the images, samplers and buffers bound, so the descriptors should be interned first.
+        vsg::ref_ptr<vsg::DescriptorSet> uniqueDescriptorSet(vsg::ref_ptr<vsg::DescriptorSet> descriptorSet);
+        vsg::ref_ptr<vsg::BindDescriptorSet> uniqueBindDescriptorSet(vsg::ref_ptr<vsg::BindDescriptorSet> bindDescriptorSet);
+
+        std::atomic<uint64_t> uniqueStateHits = 0;
+        std::atomic<uint64_t> uniqueStateMisses = 0;
+
+        // textures of this scene shared through the TextureContentCache, which may also count the duplicates of other scenes
+        std::atomic<uint64_t> duplicateTextures = 0;
+        std::atomic<uint64_t> duplicateTextureBytes = 0;
+
+        // sizes of the arrays created for this scene alone, so concurrent conversions sharing a ConversionCache don't mix up their reports
+        GeometryStatistics geometryStatistics;
+
+    protected:
+        virtual ~SceneCache();
+
+        std::mutex _uniqueStateMutex;
+        std::set<osg::ref_ptr<osg::StateSet>, UniqueStateSet> _uniqueStateSets;
+    };
+
+    /// hits and misses of a cache, accumulated over the SceneCaches of the conversions sharing a ConversionCache
+    struct CacheCounts
+    {
+        std::atomic<uint64_t> hits = 0;
+        std::atomic<uint64_t> misses = 0;
+
+        void add(uint64_t in_hits, uint64_t in_misses)
+        {
+            hits += in_hits;
+            misses += in_misses;
+        }
+    };
+
+    /// conversion caches that can be shared between ConvertToVsg instances running on different threads, assign to BuildOptions::conversionCache,
+    /// or use vsg::Options::sharedObjects to share one between all the OSG::read() calls using those options.
+    /// Only vsg objects interned by value are kept, so sharing a ConversionCache doesn't keep the converted OSG scenes alive.
+    /// Converters sharing a cache should use the same BuildOptions settings.
+    class ConversionCache : public vsg::Inherit<vsg::Object, ConversionCache>
+    {
+    public:
+        ConversionCache();
+
+        // interning tables, identical state built from different OSG objects collapses to a single vsg object
+        ShardedMap<ValueKey, vsg::ref_ptr<vsg::Sampler>, std::hash<ValueKey>> samplers;
+        ShardedMap<ValueKey, vsg::ref_ptr<vsg::DescriptorBuffer>, std::hash<ValueKey>> materials;
+
+        /// return the first Sampler added with the same settings as sampler, or sampler if no match has been added yet.
+        vsg::ref_ptr<vsg::Sampler> uniqueSampler(vsg::ref_ptr<vsg::Sampler> sampler);
+
+        /// return the uniform buffer descriptor for the first material added with the same values at binding.
+        vsg::ref_ptr<vsg::DescriptorBuffer> uniqueMaterial(vsg::ref_ptr<vsg::materialValue> material, uint32_t binding);
+
+        /// add the hits, misses and geometry statistics of a converted scene's SceneCache to the totals reported.
+        void addSceneCacheCounts(const SceneCache& sceneCache);
+
+        CacheCounts statePairs;
+        CacheCounts uniqueStates;
+        CacheCounts textures;
+        CacheCounts bindDescriptorSets;
+        CacheCounts descriptorSets;
+        CacheCounts uniqueBindDescriptorSets;
+        CacheCounts vertexBounds;
+        CacheCounts tangents;
+
+        // totals of the scenes converted
+        GeometryStatistics geometryStatistics;
+
+        /// remove all cached entries, must not be called while converters are using the cache.
+        void clear();
+
+        void report(std::ostream& out) const;
+
+    protected:
+        virtual ~ConversionCache();
+    };
+
+} // namespace osg2vsg
+
+EVSG_type_name(osg2vsg::SceneCache);
+EVSG_type_name(osg2vsg::ConversionCache);
+EVSG_type_name(osg2vsg::TextureContentCache);
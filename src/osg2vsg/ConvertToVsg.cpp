@@ -32,31 +32,51 @@ vsg::ref_ptr<vsg::BindGraphicsPipeline> ConvertToVsg::getOrCreateBindGraphicsPip
 vsg::ref_ptr<vsg::BindDescriptorSet> ConvertToVsg::getOrCreateBindDescriptorSet(uint32_t shaderModeMask, uint32_t geometryMask, osg::StateSet* stateset)
 {
     MasksAndState masksAndState(shaderModeMask, geometryMask, stateset);
-    if (auto itr = bindDescriptorSetMap.find(masksAndState); itr != bindDescriptorSetMap.end())
-    {
-        // std::cout<<"reusing bindDescriptorSet "<<itr->second.get()<<std::endl;
-        return itr->second;
-    }
+    return sceneCache->bindDescriptorSets.getOrCreate(masksAndState, [&]() -> vsg::ref_ptr<vsg::BindDescriptorSet> {
+        auto bindGraphicsPipeline = getOrCreateBindGraphicsPipeline(shaderModeMask, geometryMask);
+        if (!bindGraphicsPipeline) return {};
 
-    auto bindGraphicsPipeline = getOrCreateBindGraphicsPipeline(shaderModeMask, geometryMask);
-    if (!bindGraphicsPipeline) return {};
+        auto pipeline = bindGraphicsPipeline->pipeline;
+        if (!pipeline) return {};
 
-    auto pipeline = bindGraphicsPipeline->pipeline;
-    if (!pipeline) return {};
+        auto pipelineLayout = pipeline->layout;
+        if (!pipelineLayout) return {};
 
-    auto pipelineLayout = pipeline->layout;
-    if (!pipelineLayout) return {};
+        auto descriptorSet = createVsgStateSet(pipelineLayout->setLayouts.front(), stateset, shaderModeMask);
+        if (!descriptorSet) return {};
 
-    auto descriptorSet = createVsgStateSet(pipelineLayout->setLayouts.front(), stateset, shaderModeMask);
-    if (!descriptorSet) return {};
+        // std::cout<<"   We have descriptorSet "<<descriptorSet<<std::endl;
 
-    // std::cout<<"   We have descriptorSet "<<descriptorSet<<std::endl;
+        return sceneCache->uniqueBindDescriptorSet(vsg::BindDescriptorSet::create(VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, descriptorSet));
+    });
+}
 
-    auto bindDescriptorSet = vsg::BindDescriptorSet::create(VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, descriptorSet);
+osg::ref_ptr<osg::StateSet> ConvertToVsg::uniqueState(osg::ref_ptr<osg::StateSet> stateset, bool /*programStateSet*/)
+{
+    return sceneCache->uniqueState(stateset);
+}
 
-    bindDescriptorSetMap[masksAndState] = bindDescriptorSet;
+ConvertToVsg::StatePair ConvertToVsg::getStatePair(const StateStack& stack)
+{
+    if (stack.empty()) return StatePair();
 
-    return bindDescriptorSet;
+    return sceneCache->statePairs.getOrCreate(stack, [&]() { return createStatePair(stack); });
+}
+
+vsg::ref_ptr<vsg::DescriptorImage> ConvertToVsg::convertToVsgTexture(const osg::Texture* osgtexture, bool normalMap)
+{
+    return sceneCache->textures.getOrCreate(TextureKey(osgtexture, normalMap), [&]() { return createOrShareVsgTexture(osgtexture, normalMap); });
+}
+
+void ConvertToVsg::sharedTexture(const vsg::DescriptorImage& texture)
+{
+    ++sceneCache->duplicateTextures;
+    sceneCache->duplicateTextureBytes += TextureContentCache::dataSize(texture);
+}
+
+vsg::dsphere ConvertToVsg::computeVertexBound(const osg::Vec3Array& vertices)
+{
+    return sceneCache->vertexBounds.getOrCreate(osg::ref_ptr<const osg::Array>(&vertices), [&]() { return SceneBuilderBase::computeVertexBound(vertices); });
 }
 
 vsg::Path ConvertToVsg::mapFileName(const std::string& filename)
@@ -104,13 +124,24 @@ vsg::ref_ptr<vsg::Node> ConvertToVsg::convert(osg::Node* node)
 {
     root = nullptr;
 
+    // analyse the scene graph up front so the parallel tasks only ever read from the subgraphInfoMap
+    if (node && convertDepth == 0 && buildOptions->scheduler)
+    {
+        if (!subgraphInfoMap) subgraphInfoMap = std::make_shared<SubgraphInfoMap>();
+        computeSubgraphInfo(node);
+
+        if (buildOptions->textureCompression != TEXTURE_COMPRESSION_NONE || buildOptions->mipmapFilter != MIPMAP_FILTER_NONE) convertTextures(node);
+    }
+
     if (auto itr = nodeMap.find(node); itr != nodeMap.end())
     {
         root = itr->second;
     }
     else
     {
+        ++convertDepth;
         if (node) node->accept(*this);
+        --convertDepth;
 
         nodeMap[node] = root;
 
@@ -123,6 +154,165 @@ vsg::ref_ptr<vsg::Node> ConvertToVsg::convert(osg::Node* node)
     return root;
 }
 
+namespace
+{
+    // number of triangles drawn by the geometry's primitive sets, estimated without decomposing them
+    uint64_t estimateNumTriangles(const osg::Geometry& geometry)
+    {
+        uint64_t numTriangles = 0;
+        for (auto& primitiveSet : geometry.getPrimitiveSetList())
+        {
+            uint64_t numIndices = primitiveSet->getNumIndices();
+            switch (primitiveSet->getMode())
+            {
+            case osg::PrimitiveSet::TRIANGLES: numTriangles += numIndices / 3; break;
+            case osg::PrimitiveSet::QUADS: numTriangles += numIndices / 2; break;
+            case osg::PrimitiveSet::TRIANGLE_STRIP:
+            case osg::PrimitiveSet::TRIANGLE_FAN:
+            case osg::PrimitiveSet::QUAD_STRIP:
+            case osg::PrimitiveSet::POLYGON: numTriangles += (numIndices > 2) ? numIndices - 2 : 0; break;
+            default: break;
+            }
+        }
+        return numTriangles;
+    }
+} // namespace
+
+const ConvertToVsg::SubgraphInfo& ConvertToVsg::computeSubgraphInfo(const osg::Node* node)
+{
+    if (auto itr = subgraphInfoMap->find(node); itr != subgraphInfoMap->end()) return itr->second;
+
+    SubgraphInfo info;
+    info.independent = node->getNumParents() <= 1;
+
+    // geometry heavy enough to be simplified is worth converting as a separate task
+    auto& simplification = buildOptions->meshSimplification;
+    if (auto geometry = node->asGeometry(); geometry && simplification.enabled && estimateNumTriangles(*geometry) >= simplification.minTriangles)
+    {
+        info.numNodes = minimumParallelSubgraphSize;
+    }
+
+    if (auto group = node->asGroup())
+    {
+        for (unsigned int i = 0; i < group->getNumChildren(); ++i)
+        {
+            const auto& childInfo = computeSubgraphInfo(group->getChild(i));
+            info.numNodes += childInfo.numNodes;
+            info.independent = info.independent && childInfo.independent;
+        }
+    }
+
+    return (*subgraphInfoMap)[node] = info;
+}
+
+bool ConvertToVsg::convertInParallel(const osg::Node* node) const
+{
+    if (!buildOptions->scheduler || !subgraphInfoMap || !node) return false;
+
+    // subgraphs containing shared nodes are converted on the calling thread so they are visited in the same order as a serial traversal
+    auto itr = subgraphInfoMap->find(node);
+    return itr != subgraphInfoMap->end() && itr->second.independent && itr->second.numNodes >= minimumParallelSubgraphSize;
+}
+
+ConvertToVsg::Children ConvertToVsg::convertChildren(osg::Group& group, unsigned int numChildren)
+{
+    Children children(numChildren);
+
+    auto scheduler = buildOptions->scheduler.get();
+    std::vector<osg::ref_ptr<ConvertToVsg>> converters(numChildren);
+    TaskScheduler::TaskGroup tasks;
+
+    for (unsigned int i = 0; i < numChildren; ++i)
+    {
+        auto child = group.getChild(i);
+        if (!convertInParallel(child)) continue;
+
+        osg::ref_ptr<ConvertToVsg> converter = new ConvertToVsg(buildOptions, inheritedStateGroup, conversionCache, sceneCache);
+        converter->subgraphInfoMap = subgraphInfoMap;
+        converter->statestack = statestack;
+        converter->nodeShaderModeMasks = nodeShaderModeMasks;
+        converter->convertDepth = convertDepth;
+        converters[i] = converter;
+
+        auto& result = children[i];
+        scheduler->run(tasks, [converter, child, &result]() { result = converter->convert(child); });
+    }
+
+    for (unsigned int i = 0; i < numChildren; ++i)
+    {
+        if (!converters[i]) children[i] = convert(group.getChild(i));
+    }
+
+    if (scheduler) scheduler->wait(tasks);
+
+    // merge the per task results in child order so the final state matches a serial traversal
+    for (auto& converter : converters)
+    {
+        if (!converter) continue;
+
+        nodeMap.insert(converter->nodeMap.begin(), converter->nodeMap.end());
+        filenameMap.insert(converter->filenameMap.begin(), converter->filenameMap.end());
+        numOfPagedLOD += converter->numOfPagedLOD;
+    }
+
+    return children;
+}
+
+namespace
+{
+    /// collect the textures, and whether they are used as normal maps, of all the StateSets in a subgraph
+    class CollectTextures : public osg::NodeVisitor
+    {
+    public:
+        explicit CollectTextures(uint32_t in_shaderModeMask) :
+            osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ACTIVE_CHILDREN),
+            shaderModeMask(in_shaderModeMask) {}
+
+        uint32_t shaderModeMask;
+        std::set<std::pair<const osg::Texture*, bool>> textures;
+
+        void apply(osg::Node& node) override
+        {
+            // only the units createVsgStateSet() binds, when their shader mode is supported, textures on other units are never converted
+            static constexpr std::pair<unsigned int, uint32_t> boundUnits[] = {
+                {DIFFUSE_TEXTURE_UNIT, DIFFUSE_MAP},
+                {OPACITY_TEXTURE_UNIT, OPACITY_MAP},
+                {AMBIENT_TEXTURE_UNIT, AMBIENT_MAP},
+                {NORMAL_TEXTURE_UNIT, NORMAL_MAP},
+                {SPECULAR_TEXTURE_UNIT, SPECULAR_MAP},
+                {AORM_TEXTURE_UNIT, AORM_MAP}};
+
+            if (auto stateset = node.getStateSet())
+            {
+                for (auto& [unit, mode] : boundUnits)
+                {
+                    if ((shaderModeMask & mode) == 0) continue;
+
+                    auto texture = dynamic_cast<const osg::Texture*>(stateset->getTextureAttribute(unit, osg::StateAttribute::TEXTURE));
+                    if (texture && texture->getImage(0)) textures.emplace(texture, unit == NORMAL_TEXTURE_UNIT);
+                }
+            }
+            traverse(node);
+        }
+    };
+} // namespace
+
+void ConvertToVsg::convertTextures(osg::Node* node)
+{
+    // block compression and mipmap generation dominate the conversion time of textured scenes, so process all the scene's textures up front in parallel,
+    // the traversal then picks the results up from the sceneCache.
+    CollectTextures collectTextures(buildOptions->supportedShaderModeMask);
+    node->accept(collectTextures);
+
+    auto scheduler = buildOptions->scheduler.get();
+    TaskScheduler::TaskGroup tasks;
+    for (auto& [texture, normalMap] : collectTextures.textures)
+    {
+        scheduler->run(tasks, [this, texture = texture, normalMap = normalMap]() { convertToVsgTexture(texture, normalMap); });
+    }
+    scheduler->wait(tasks);
+}
+
 vsg::ref_ptr<vsg::Data> ConvertToVsg::copy(osg::Array* src_array)
 {
     if (!src_array) return {};
@@ -189,7 +379,7 @@ uint32_t ConvertToVsg::calculateShaderModeMask()
 {
     if (statestack.empty()) return osg2vsg::ShaderModeMask::NONE;
 
-    auto& statepair = getStatePair();
+    auto statepair = getStatePair();
 
     return osg2vsg::calculateShaderModeMask(statepair.first) | osg2vsg::calculateShaderModeMask(statepair.second);
 }
@@ -202,68 +392,132 @@ void ConvertToVsg::apply(osg::Geometry& geometry)
     uint32_t shaderModeMask = (calculateShaderModeMask() | buildOptions->overrideShaderModeMask | nodeShaderModeMasks) & buildOptions->supportedShaderModeMask;
     bool requiredBlending = (shaderModeMask & BLEND) != 0;
 
+    // the pipeline variant and the converted vertex buffers both leave out the attributes its shaders don't read,
+    // custom shaders may read inputs their shader mode defines don't enable so their geometry is left intact
+    bool customShaders = !buildOptions->vertexShaderPath.empty() || !buildOptions->fragmentShaderPath.empty();
+    if (buildOptions->pruneVertexAttributes && !customShaders) geometryMask = pruneGeometryAttributes(shaderModeMask, geometryMask);
+
     // std::cout<<"Have geometry with "<<statestack.size()<<" shaderModeMask="<<shaderModeMask<<", geometryMask="<<geometryMask<<std::endl;
 
-    auto vsg_geometry = osg2vsg::convertToVsg(&geometry, geometryMask, buildOptions->geometryTarget);
+    GeometryConversionSettings settings;
+    settings.welding = buildOptions->vertexWelding;
+    settings.splitLargeMeshes = buildOptions->splitLargeMeshes;
+    settings.compression = buildOptions->vertexCompression;
+    settings.simplification = buildOptions->meshSimplification;
+    settings.statistics = &sceneCache->geometryStatistics;
+
+    // blended geometry keeps the triangle order of the triangle list
+    if (buildOptions->triangleStrips && !requiredBlending) settings.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+    // billboards and per vertex translations offset the positions in the shader, in the space the folded position transform would scale
+    if ((geometryMask & TRANSLATE) || (shaderModeMask & (BILLBOARD | SHADER_TRANSLATE))) settings.compression.positionCompression = POSITION_COMPRESSION_NONE;
+
+    // tangents required but missing are generated once per geometry, so geometries shared across the scene, or converted by other threads, reuse them
+    auto tangentArray = geometry.getVertexAttribArray(6);
+    if ((geometryMask & TANGENT) && (!tangentArray || tangentArray->getNumElements() == 0))
+    {
+        settings.generatedTangents = sceneCache->tangents.getOrCreate(osg::ref_ptr<const osg::Geometry>(&geometry), [&]() { return osg2vsg::generateTangents(&geometry); });
+    }
+
+    GeometryConversionResult result;
+    auto vsg_geometry = osg2vsg::convertToVsg(&geometry, geometryMask, buildOptions->geometryTarget, settings, &result);
     if (!vsg_geometry)
     {
         return;
     }
 
-    auto stategroup = vsg::StateGroup::create();
+    auto createSubgraph = [&](vsg::ref_ptr<vsg::Command> command, VkPrimitiveTopology drawTopology, const VertexCompressionReport& report) -> vsg::ref_ptr<vsg::Node> {
+        // the pipeline variant matching the topology and vertex formats of the converted draw
+        uint32_t drawGeometryMask = geometryMask | report.compressedAttributes;
+        if (drawTopology == VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP) drawGeometryMask |= TRIANGLE_STRIP_TOPOLOGY;
 
-    auto bindGraphicsPipeline = getOrCreateBindGraphicsPipeline(shaderModeMask, geometryMask);
-    if (bindGraphicsPipeline)
-    {
-        if (!inheritedStateGroup || !inheritedStateGroup->contains(bindGraphicsPipeline))
+        auto stategroup = vsg::StateGroup::create();
+
+        auto bindGraphicsPipeline = getOrCreateBindGraphicsPipeline(shaderModeMask, drawGeometryMask);
+        if (bindGraphicsPipeline)
         {
-            stategroup->add(bindGraphicsPipeline);
+            if (!inheritedStateGroup || !inheritedStateGroup->contains(bindGraphicsPipeline))
+            {
+                stategroup->add(bindGraphicsPipeline);
+            }
         }
-    }
 
-    if (!statestack.empty())
-    {
-        auto stateset = getStatePair().second;
-        //std::cout<<"   We have stateset "<<stateset<<", descriptorSetLayouts.size() = "<<descriptorSetLayouts.size()<<", "<<shaderModeMask<<std::endl;
-        if (stateset)
+        if (!statestack.empty())
         {
-            auto bindDescriptorSet = getOrCreateBindDescriptorSet(shaderModeMask, geometryMask, stateset);
-            if (bindDescriptorSet)
+            auto stateset = getStatePair().second;
+            //std::cout<<"   We have stateset "<<stateset<<", descriptorSetLayouts.size() = "<<descriptorSetLayouts.size()<<", "<<shaderModeMask<<std::endl;
+            if (stateset)
             {
-                if (!inheritedStateGroup || !inheritedStateGroup->contains(bindDescriptorSet))
+                auto bindDescriptorSet = getOrCreateBindDescriptorSet(shaderModeMask, drawGeometryMask, stateset);
+                if (bindDescriptorSet)
                 {
-                    stategroup->add(bindDescriptorSet);
+                    if (!inheritedStateGroup || !inheritedStateGroup->contains(bindDescriptorSet))
+                    {
+                        stategroup->add(bindDescriptorSet);
+                    }
                 }
             }
         }
-    }
 
-    stategroup->addChild(vsg_geometry);
+        stategroup->addChild(command);
 
-    if (requiredBlending && buildOptions->useDepthSorted)
+        // compressed positions are mapped back onto the geometry's bounding box by a transform, the bounds are computed from the original vertices so stay above it
+        if (report.compressedAttributes & (VERTEX_UNORM16 | VERTEX_SNORM16))
+        {
+            // nothing below it is culled, so the cull traversal needn't compute a local frustum for it
+            auto transform = vsg::MatrixTransform::create(report.positionTransform);
+            transform->subgraphRequiresLocalFrustum = false;
+            transform->addChild(stategroup);
+            return transform;
+        }
+        return stategroup;
+    };
+
+    vsg::ref_ptr<vsg::Node> subgraph = createSubgraph(vsg_geometry, result.topology, result.compressionReport);
+    auto bound = computeBound(geometry, geometryMask);
+
+    // the reduced levels are switched to once their error projects to less than meshSimplification.pixelError pixels, using the same reference screen as apply(osg::LOD&).
+    // As the LOD culls against its bound it takes the place of the CullNode.
+    vsg::ref_ptr<vsg::LOD> lod;
+    auto& levels = result.levels;
+    if (!levels.empty())
     {
-        auto center = geometry.getBound().center();
-        auto radius = geometry.getBound().radius();
+        // the screen height ratio, in units of half the screen height, at which error covers pixelError pixels
+        const double pixel_ratio = 1.0 / 1080.0;
+        auto minimumScreenHeightRatio = [&](float error) {
+            double clampedError = std::max(static_cast<double>(error), bound.radius * 1e-4);
+            return 2.0 * buildOptions->meshSimplification.pixelError * pixel_ratio * bound.radius / clampedError;
+        };
 
+        lod = vsg::LOD::create();
+        lod->bound = bound;
+        lod->addChild(vsg::LOD::Child{minimumScreenHeightRatio(levels.front().error), subgraph});
+        for (size_t i = 0; i < levels.size(); ++i)
+        {
+            auto& level = levels[i];
+            double ratio = (i + 1 < levels.size()) ? minimumScreenHeightRatio(levels[i + 1].error) : 0.0;
+            lod->addChild(vsg::LOD::Child{ratio, createSubgraph(level.command, level.topology, level.compressionReport)});
+        }
+        subgraph = lod;
+    }
+
+    if (requiredBlending && buildOptions->useDepthSorted)
+    {
         auto depthSorted = vsg::DepthSorted::create();
         depthSorted->binNumber = 10;
-        depthSorted->bound.set(center.x(), center.y(), center.z(), radius);
-        depthSorted->child = stategroup;
+        depthSorted->bound = bound;
+        depthSorted->child = subgraph;
 
         root = depthSorted;
     }
     else
     {
-        if (buildOptions->insertCullGroups || buildOptions->insertCullNodes)
+        if ((buildOptions->insertCullGroups || buildOptions->insertCullNodes) && !lod)
         {
-            auto center = geometry.getBound().center();
-            auto radius = geometry.getBound().radius();
-
-            root = vsg::CullNode::create(vsg::dsphere(center.x(), center.y(), center.z(), radius), stategroup);
+            root = vsg::CullNode::create(bound, subgraph);
         }
         else
         {
-            root = stategroup;
+            root = subgraph;
         }
     }
 }
@@ -282,13 +536,9 @@ void ConvertToVsg::apply(osg::Group& group)
 
     //vsg_group->setValue("class", group.className());
 
-    for (unsigned int i = 0; i < group.getNumChildren(); ++i)
+    for (auto& vsg_child : convertChildren(group, group.getNumChildren()))
     {
-        auto child = group.getChild(i);
-        if (auto vsg_child = convert(child); vsg_child)
-        {
-            vsg_group->addChild(vsg_child);
-        }
+        if (vsg_child) vsg_group->addChild(vsg_child);
     }
 
     root = vsg_group;
@@ -301,13 +551,9 @@ void ConvertToVsg::apply(osg::MatrixTransform& transform)
     auto vsg_transform = vsg::MatrixTransform::create();
     vsg_transform->matrix = osg2vsg::convert(transform.getMatrix());
 
-    for (unsigned int i = 0; i < transform.getNumChildren(); ++i)
+    for (auto& vsg_child : convertChildren(transform, transform.getNumChildren()))
     {
-        auto child = transform.getChild(i);
-        if (auto vsg_child = convert(child); vsg_child)
-        {
-            vsg_transform->addChild(vsg_child);
-        }
+        if (vsg_child) vsg_transform->addChild(vsg_child);
     }
 
     struct CheckForCullNodes : public vsg::ConstVisitor
@@ -491,9 +737,10 @@ void ConvertToVsg::apply(osg::LOD& lod)
 
     // build a map of minimum screen ratio to child
     std::map<double, vsg::ref_ptr<vsg::Node>> ratioChildMap;
+    auto vsg_children = convertChildren(lod, numChildren);
     for (unsigned int i = 0; i < numChildren; ++i)
     {
-        if (auto vsg_child = convert(lod.getChild(i)); vsg_child)
+        if (auto& vsg_child = vsg_children[i]; vsg_child)
         {
             double minimumScreenHeightRatio = (lod.getRangeMode() == osg::LOD::DISTANCE_FROM_EYE_POINT) ? (atan2(radius, static_cast<double>(lod.getMaxRange(i))) * angle_ratio) : (lod.getMinRange(i) * pixel_ratio);
 
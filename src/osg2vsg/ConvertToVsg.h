@@ -9,6 +9,8 @@
 #include <osgUtil/MeshOptimizers>
 #include <osgUtil/Optimizer>
 
+#include <unordered_map>
+
 #include "GeometryUtils.h"
 #include "Optimize.h"
 #include "SceneBuilder.h"
@@ -22,27 +24,65 @@ namespace osg2vsg
     class ConvertToVsg : public osg::NodeVisitor, public osg2vsg::SceneBuilderBase
     {
     public:
-        ConvertToVsg(vsg::ref_ptr<const BuildOptions> options, vsg::ref_ptr<vsg::StateGroup> in_inheritedStateGroup = {}) :
+        ConvertToVsg(vsg::ref_ptr<const BuildOptions> options, vsg::ref_ptr<vsg::StateGroup> in_inheritedStateGroup = {}, vsg::ref_ptr<ConversionCache> in_conversionCache = {}, vsg::ref_ptr<SceneCache> in_sceneCache = {}) :
             osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ACTIVE_CHILDREN),
             SceneBuilderBase(options),
-            inheritedStateGroup(in_inheritedStateGroup)
+            inheritedStateGroup(in_inheritedStateGroup),
+            conversionCache(in_conversionCache),
+            sceneCache(in_sceneCache)
         {
+            if (!conversionCache) conversionCache = buildOptions->conversionCache;
+            if (!conversionCache) conversionCache = ConversionCache::create();
+            if (!sceneCache) sceneCache = SceneCache::create();
         }
 
         vsg::ref_ptr<vsg::Node> root;
 
         using osg::NodeVisitor::apply;
-        using MasksAndState = std::tuple<uint32_t, uint32_t, osg::ref_ptr<osg::StateSet>>;
-        using BindDescriptorSetMap = std::map<MasksAndState, vsg::ref_ptr<vsg::BindDescriptorSet>>;
-        BindDescriptorSetMap bindDescriptorSetMap;
         vsg::ref_ptr<vsg::StateGroup> inheritedStateGroup;
 
+        // caches of the vsg objects interned by value, may be shared with converters running on other threads and with other reads
+        vsg::ref_ptr<ConversionCache> conversionCache;
+
+        // state, texture and descriptor set caches keyed by the OSG objects of the scene, only shared with the converters of the same scene
+        vsg::ref_ptr<SceneCache> sceneCache;
+
         using NodeMap = std::map<osg::Node*, vsg::ref_ptr<vsg::Node>>;
         NodeMap nodeMap;
 
         size_t numOfPagedLOD = 0;
         FileNameMap filenameMap;
 
+        // parallel conversion support, per task converters share the conversionCache and sceneCache of the converter that created them.
+        struct SubgraphInfo
+        {
+            uint32_t numNodes = 1;
+            bool independent = true; // no node in the subgraph has more than one parent
+        };
+        using SubgraphInfoMap = std::unordered_map<const osg::Node*, SubgraphInfo>;
+        using Children = std::vector<vsg::ref_ptr<vsg::Node>>;
+
+        // minimum number of nodes in a subgraph before it's worth converting it as a separate task
+        static constexpr uint32_t minimumParallelSubgraphSize = 16;
+
+        std::shared_ptr<SubgraphInfoMap> subgraphInfoMap;
+        uint32_t convertDepth = 0;
+
+        osg::ref_ptr<osg::StateSet> uniqueState(osg::ref_ptr<osg::StateSet> stateset, bool programStateSet) override;
+        StatePair getStatePair(const StateStack& stack) override;
+        vsg::ref_ptr<vsg::DescriptorImage> convertToVsgTexture(const osg::Texture* osgtexture, bool normalMap = false) override;
+        void sharedTexture(const vsg::DescriptorImage& texture) override;
+        vsg::ref_ptr<vsg::Sampler> uniqueSampler(vsg::ref_ptr<vsg::Sampler> sampler) override { return conversionCache->uniqueSampler(sampler); }
+        vsg::ref_ptr<vsg::DescriptorBuffer> uniqueMaterial(vsg::ref_ptr<vsg::materialValue> material, uint32_t binding) override { return conversionCache->uniqueMaterial(material, binding); }
+        vsg::ref_ptr<vsg::DescriptorSet> uniqueDescriptorSet(vsg::ref_ptr<vsg::DescriptorSet> descriptorSet) override { return sceneCache->uniqueDescriptorSet(descriptorSet); }
+        vsg::dsphere computeVertexBound(const osg::Vec3Array& vertices) override;
+        using SceneBuilderBase::getStatePair;
+
+        const SubgraphInfo& computeSubgraphInfo(const osg::Node* node);
+        bool convertInParallel(const osg::Node* node) const;
+        Children convertChildren(osg::Group& group, unsigned int numChildren);
+        void convertTextures(osg::Node* node);
+
         vsg::ref_ptr<vsg::BindGraphicsPipeline> getOrCreateBindGraphicsPipeline(uint32_t shaderModeMask, uint32_t geometryMask);
 
         vsg::ref_ptr<vsg::BindDescriptorSet> getOrCreateBindDescriptorSet(uint32_t shaderModeMask, uint32_t geometryMask, osg::StateSet* stateset);
@@ -0,0 +1,197 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2026 the osg2vsg authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "CullGroupHierarchy.h"
+
+#include <algorithm>
+#include <functional>
+#include <typeinfo>
+
+using namespace osg2vsg;
+
+namespace
+{
+    struct Child
+    {
+        vsg::ref_ptr<vsg::Node> node;
+        vsg::dsphere bound;
+    };
+
+    using Children = std::vector<Child>;
+    using Iterator = Children::iterator;
+
+    bool computeBound(const vsg::Node* node, vsg::dsphere& bound)
+    {
+        // use the bounds the culling nodes already hold rather than traversing their subgraphs
+        if (auto cullNode = node->cast<vsg::CullNode>()) bound = cullNode->bound;
+        else if (auto cullGroup = node->cast<vsg::CullGroup>()) bound = cullGroup->bound;
+        else if (auto lod = node->cast<vsg::LOD>()) bound = lod->bound;
+        else if (auto plod = node->cast<vsg::PagedLOD>()) bound = plod->bound;
+        else if (auto depthSorted = node->cast<vsg::DepthSorted>()) bound = depthSorted->bound;
+        else
+        {
+            vsg::ComputeBounds computeBounds;
+            node->accept(computeBounds);
+            if (!computeBounds.bounds.valid()) return false;
+
+            auto center = (computeBounds.bounds.min + computeBounds.bounds.max) * 0.5;
+            bound.set(center.x, center.y, center.z, vsg::length(computeBounds.bounds.max - computeBounds.bounds.min) * 0.5);
+        }
+        return bound.valid();
+    }
+
+    vsg::dbox centerBounds(Iterator begin, Iterator end)
+    {
+        vsg::dbox box;
+        for (auto itr = begin; itr != end; ++itr) box.add(itr->bound.center);
+        return box;
+    }
+
+    vsg::dsphere enclosingSphere(Iterator begin, Iterator end)
+    {
+        vsg::dbox box;
+        for (auto itr = begin; itr != end; ++itr)
+        {
+            auto& bound = itr->bound;
+            box.add(bound.center - vsg::dvec3(bound.radius, bound.radius, bound.radius));
+            box.add(bound.center + vsg::dvec3(bound.radius, bound.radius, bound.radius));
+        }
+
+        // centred on the box around the children, with the radius reaching the far side of the furthest child
+        auto center = (box.min + box.max) * 0.5;
+        double radius = 0.0;
+        for (auto itr = begin; itr != end; ++itr) radius = std::max(radius, vsg::length(itr->bound.center - center) + itr->bound.radius);
+        return vsg::dsphere(center.x, center.y, center.z, radius);
+    }
+
+    // split [begin, end) at the median along the longest axis of the child centres, recursively, into at most numParts ranges
+    void partition(Iterator begin, Iterator end, uint32_t numParts, uint32_t leafSize, std::vector<std::pair<Iterator, Iterator>>& parts)
+    {
+        auto size = static_cast<uint32_t>(std::distance(begin, end));
+        if (numParts <= 1 || size <= leafSize)
+        {
+            parts.emplace_back(begin, end);
+            return;
+        }
+
+        auto box = centerBounds(begin, end);
+        auto extents = box.max - box.min;
+        int axis = (extents.x >= extents.y && extents.x >= extents.z) ? 0 : (extents.y >= extents.z ? 1 : 2);
+
+        auto middle = begin + size / 2;
+        std::nth_element(begin, middle, end, [axis](const Child& lhs, const Child& rhs) { return lhs.bound.center[axis] < rhs.bound.center[axis]; });
+
+        partition(begin, middle, numParts / 2, leafSize, parts);
+        partition(middle, end, numParts - numParts / 2, leafSize, parts);
+    }
+} // namespace
+
+BuildCullGroupHierarchy::BuildCullGroupHierarchy(uint32_t in_fanOut, uint32_t in_leafSize) :
+    fanOut(std::max(in_fanOut, 2u)),
+    leafSize(std::max(in_leafSize, 1u))
+{
+}
+
+void BuildCullGroupHierarchy::apply(vsg::Node& node)
+{
+    node.traverse(*this);
+}
+
+void BuildCullGroupHierarchy::apply(vsg::Group& group)
+{
+    if (!_visited.insert(&group).second) return;
+
+    group.traverse(*this);
+
+    // other Group subclasses, such as vsg::Switch, give their children a meaning that a reorganisation would lose
+    if (typeid(group) == typeid(vsg::Group) || typeid(group) == typeid(vsg::StateGroup) || typeid(group) == typeid(vsg::CullGroup))
+    {
+        reorganise(group);
+    }
+}
+
+void BuildCullGroupHierarchy::apply(vsg::MatrixTransform& transform)
+{
+    if (!_visited.insert(&transform).second) return;
+
+    transform.traverse(*this);
+
+    // the CullGroups are in the transform's local coordinates so its subgraph now needs culling against the local frustum
+    if (reorganise(transform)) transform.subgraphRequiresLocalFrustum = true;
+}
+
+bool BuildCullGroupHierarchy::reorganise(vsg::Group& group)
+{
+    if (group.children.size() <= leafSize) return false;
+
+    // build the hierarchy top down, each node of it becoming a CullGroup with up to fanOut children
+    std::function<vsg::ref_ptr<vsg::Node>(Iterator, Iterator)> build = [&](Iterator begin, Iterator end) -> vsg::ref_ptr<vsg::Node> {
+        if (std::distance(begin, end) == 1) return begin->node;
+
+        auto bound = enclosingSphere(begin, end);
+        auto cullGroup = vsg::CullGroup::create(bound);
+        ++numCullGroupsCreated;
+
+        if (static_cast<uint32_t>(std::distance(begin, end)) <= leafSize)
+        {
+            for (auto itr = begin; itr != end; ++itr) cullGroup->addChild(itr->node);
+            return cullGroup;
+        }
+
+        std::vector<std::pair<Iterator, Iterator>> parts;
+        partition(begin, end, fanOut, leafSize, parts);
+        for (auto& [partBegin, partEnd] : parts) cullGroup->addChild(build(partBegin, partEnd));
+        return cullGroup;
+    };
+
+    // children without a bound keep their place, each run of bounded children between them gets its own hierarchy, the top level of which is split straight into the group's children
+    // so the group itself and any state it applies are kept
+    vsg::Group::Children children;
+    Children run;
+    bool reorganised = false;
+    auto flush = [&]() {
+        if (run.size() > leafSize)
+        {
+            std::vector<std::pair<Iterator, Iterator>> parts;
+            partition(run.begin(), run.end(), fanOut, leafSize, parts);
+            for (auto& [begin, end] : parts) children.push_back(build(begin, end));
+            reorganised = true;
+        }
+        else
+        {
+            for (auto& child : run) children.push_back(child.node);
+        }
+        run.clear();
+    };
+
+    for (auto& node : group.children)
+    {
+        Child child{node, {}};
+        if (node && computeBound(node.get(), child.bound))
+        {
+            run.push_back(child);
+        }
+        else
+        {
+            flush();
+            children.push_back(node);
+        }
+    }
+    flush();
+
+    if (!reorganised) return false;
+
+    group.children = children;
+
+    ++numGroupsReorganised;
+    return true;
+}
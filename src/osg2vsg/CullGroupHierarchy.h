@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <set>
+
+namespace osg2vsg
+{
+    /// reorganise the children of groups with more than leafSize children into a balanced hierarchy of CullGroups, so culling a wide flat group costs log rather than linear time in its number of children.
+    /// The children are split at the median of their bounding sphere centres along the longest axis, recursively into fanOut subtrees per level, until at most leafSize children remain in each CullGroup.
+    /// Children without a bound, such as state only subgraphs, are left where they are, only the runs of bounded children between them are reorganised, and reordered spatially.
+    class BuildCullGroupHierarchy : public vsg::Visitor
+    {
+    public:
+        BuildCullGroupHierarchy(uint32_t in_fanOut = 4, uint32_t in_leafSize = 16);
+
+        uint32_t fanOut;
+        uint32_t leafSize;
+
+        uint32_t numGroupsReorganised = 0;
+        uint32_t numCullGroupsCreated = 0;
+
+        void apply(vsg::Node& node) override;
+        void apply(vsg::Group& group) override;
+        void apply(vsg::MatrixTransform& transform) override;
+
+    protected:
+        bool reorganise(vsg::Group& group);
+
+        std::set<const vsg::Group*> _visited;
+    };
+
+} // namespace osg2vsg
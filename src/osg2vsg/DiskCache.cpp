@@ -0,0 +1,301 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2026 the osg2vsg authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <osg2vsg/OSG.h>
+
+#include <osg/Texture>
+#include <osgDB/FileUtils>
+
+#include "DiskCache.h"
+#include "Hash.h"
+#include "ImageUtils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <set>
+#include <sstream>
+
+using namespace osg2vsg;
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    // temporary files left behind by crashed writers are removed once they are this old
+    constexpr auto staleTemporaryAge = std::chrono::hours(1);
+
+    vsg::ref_ptr<vsg::Options> binaryOptions(vsg::ref_ptr<const vsg::Options> options)
+    {
+        auto local_options = options ? vsg::Options::create(*options) : vsg::Options::create();
+        local_options->extensionHint = ".vsgb";
+        return local_options;
+    }
+
+    // size and modification time of each file, or a marker for files that don't exist, so adding, removing or changing any of them is detected
+    std::string fileStates(const std::string& files)
+    {
+        std::ostringstream states;
+        std::istringstream lines(files);
+        for (std::string file; std::getline(lines, file);)
+        {
+            std::error_code ec;
+            fs::path path(file);
+            auto size = fs::file_size(path, ec);
+            auto modified = ec ? fs::file_time_type() : fs::last_write_time(path, ec);
+            if (ec)
+                states << "-\n";
+            else
+                states << size << ' ' << modified.time_since_epoch().count() << '\n';
+        }
+        return states.str();
+    }
+
+    class CollectImageFiles : public osg::NodeVisitor
+    {
+    public:
+        explicit CollectImageFiles(const std::string& in_sourceFile) :
+            osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ALL_CHILDREN),
+            sourceFile(in_sourceFile) {}
+
+        std::string sourceFile;
+        std::set<std::string> files;
+
+        void apply(osg::Node& node) override
+        {
+            collect(node.getStateSet());
+            traverse(node);
+        }
+
+        void collect(const osg::StateSet* stateset)
+        {
+            if (!stateset) return;
+
+            for (unsigned int unit = 0; unit < stateset->getNumTextureAttributeLists(); ++unit)
+            {
+                auto texture = dynamic_cast<const osg::Texture*>(stateset->getTextureAttribute(unit, osg::StateAttribute::TEXTURE));
+                if (!texture) continue;
+
+                for (unsigned int i = 0; i < texture->getNumImages(); ++i)
+                {
+                    auto image = texture->getImage(i);
+                    if (!image || image->getFileName().empty()) continue;
+
+                    auto fileName = osgDB::findDataFile(image->getFileName());
+                    files.insert(fileName.empty() ? image->getFileName() : fileName);
+
+                    // the maps looked for alongside the diffuse image are recorded even when missing, so adding one later invalidates the entry
+                    if (unit == 0 && i == 0)
+                    {
+                        files.insert(siblingImageFileName(sourceFile, image->getFileName(), "_NML."));
+                        files.insert(siblingImageFileName(sourceFile, image->getFileName(), "_AORM."));
+                    }
+                }
+            }
+        }
+    };
+} // namespace
+
+DiskCache::DiskCache(const vsg::Path& in_directory, uint64_t in_maxSize) :
+    directory(in_directory),
+    maxSize(in_maxSize)
+{
+}
+
+DiskCache::~DiskCache()
+{
+}
+
+bool DiskCache::computeKey(const vsg::Path& sourceFile, const BuildOptions& buildOptions, const vsg::Options* options, Key& key)
+{
+    std::ifstream fin(fs::path(sourceFile.string()), std::ios::in | std::ios::binary);
+    if (!fin) return false;
+
+    // the conversion depends on the file's location as well as its contents as textures are searched for relative to it
+    Hash64 sourceHash(formatVersion);
+    sourceHash.update(sourceFile.string());
+
+    std::vector<char> buffer(1024 * 1024);
+    while (fin)
+    {
+        fin.read(buffer.data(), buffer.size());
+        sourceHash.update(buffer.data(), static_cast<size_t>(fin.gcount()));
+    }
+    if (fin.bad()) return false;
+
+    // hash the serialized form so any setting that BuildOptions::write() records is part of the key,
+    // apart from numThreads which only changes how the conversion is scheduled, not the scene graph it produces
+    auto keyBuildOptions = BuildOptions::create(buildOptions);
+    keyBuildOptions->numThreads = 0;
+
+    std::ostringstream settings;
+    if (!vsg::VSG::create()->write(keyBuildOptions, settings, binaryOptions({}))) return false;
+
+    // the original converter ignores most of the BuildOptions and produces a different scene graph
+    if (vsg::value<bool>(false, OSG::original_converter, options)) settings << OSG::original_converter;
+
+    key.source = sourceHash.digest();
+    key.buildOptions = hash64(settings.str().data(), settings.str().size(), formatVersion);
+    return true;
+}
+
+std::vector<std::string> DiskCache::collectDependencies(osg::Node& scene, const vsg::Path& sourceFile)
+{
+    CollectImageFiles collectImageFiles(sourceFile.string());
+    scene.accept(collectImageFiles);
+    return std::vector<std::string>(collectImageFiles.files.begin(), collectImageFiles.files.end());
+}
+
+vsg::Path DiskCache::entryPath(const Key& key) const
+{
+    char filename[64];
+    std::snprintf(filename, sizeof(filename), "%016llx-%016llx.vsgb", static_cast<unsigned long long>(key.source), static_cast<unsigned long long>(key.buildOptions));
+    return directory / filename;
+}
+
+vsg::ref_ptr<vsg::Object> DiskCache::read(const Key& key, vsg::ref_ptr<const vsg::Options> options) const
+{
+    fs::path path(entryPath(key).string());
+
+    vsg::ref_ptr<vsg::Object> object;
+    {
+        std::ifstream fin(path, std::ios::in | std::ios::binary);
+        if (!fin) return {};
+
+        object = vsg::VSG::create()->read(fin, binaryOptions(options));
+    }
+
+    // entries hold the dependencies' file names, their state when the entry was written and the converted object
+    auto entry = object.cast<vsg::Objects>();
+    auto files = (entry && entry->children.size() == 3) ? entry->children[0].cast<vsg::stringValue>() : nullptr;
+    auto states = (entry && entry->children.size() == 3) ? entry->children[1].cast<vsg::stringValue>() : nullptr;
+
+    std::error_code ec;
+    if (!files || !states || !entry->children[2])
+    {
+        // unreadable entry, possibly from an incompatible version of the VSG, so remove it to allow it to be replaced
+        fs::remove(path, ec);
+        return {};
+    }
+
+    // a dependency has changed, the entry is replaced once the source file has been converted again
+    if (fileStates(files->value()) != states->value()) return {};
+
+    // mark as recently used, failure just affects the order of eviction
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+
+    return entry->children[2];
+}
+
+bool DiskCache::write(const Key& key, vsg::ref_ptr<vsg::Object> object, const std::vector<std::string>& dependencies, vsg::ref_ptr<const vsg::Options> options) const
+{
+    if (!object) return false;
+
+    std::string files;
+    for (auto& dependency : dependencies) files += dependency + '\n';
+
+    auto entry = vsg::Objects::create();
+    entry->children.push_back(vsg::stringValue::create(files));
+    entry->children.push_back(vsg::stringValue::create(fileStates(files)));
+    entry->children.push_back(object);
+
+    std::error_code ec;
+    fs::create_directories(fs::path(directory.string()), ec);
+    if (ec) return false;
+
+    fs::path path(entryPath(key).string());
+
+    // write to a uniquely named temporary file so readers in other processes never see a partially written entry
+    std::random_device random;
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), ".tmp%08x%08x", random(), random());
+    fs::path temporaryPath = path;
+    temporaryPath += suffix;
+
+    bool result = false;
+    {
+        std::ofstream fout(temporaryPath, std::ios::out | std::ios::binary);
+        if (fout)
+        {
+            result = vsg::VSG::create()->write(entry, fout, binaryOptions(options));
+            fout.close();
+            result = result && !fout.fail();
+        }
+    }
+
+    if (result)
+    {
+        fs::rename(temporaryPath, path, ec);
+
+        // if the rename failed another process may have written the same entry first, which is equally valid
+        if (ec) result = fs::exists(path, ec);
+    }
+
+    if (fs::exists(temporaryPath, ec)) fs::remove(temporaryPath, ec);
+
+    if (result) evict();
+
+    return result;
+}
+
+void DiskCache::evict() const
+{
+    if (maxSize == 0) return;
+
+    struct Entry
+    {
+        fs::path path;
+        fs::file_time_type lastUsed;
+        uintmax_t size;
+    };
+
+    std::vector<Entry> entries;
+    uintmax_t totalSize = 0;
+    auto now = fs::file_time_type::clock::now();
+
+    // other processes may be adding and removing entries at the same time so errors on individual files are ignored
+    std::error_code ec;
+    for (fs::directory_iterator itr(fs::path(directory.string()), ec), end; !ec && itr != end; itr.increment(ec))
+    {
+        std::error_code file_ec;
+        const auto& path = itr->path();
+        auto lastUsed = itr->last_write_time(file_ec);
+        if (file_ec) continue;
+
+        if (path.extension() == ".vsgb")
+        {
+            auto size = itr->file_size(file_ec);
+            if (file_ec) continue;
+
+            entries.push_back(Entry{path, lastUsed, size});
+            totalSize += size;
+        }
+        else if (path.extension().string().compare(0, 4, ".tmp") == 0 && (now - lastUsed) > staleTemporaryAge)
+        {
+            fs::remove(path, file_ec);
+        }
+    }
+
+    if (totalSize <= maxSize) return;
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs) { return lhs.lastUsed < rhs.lastUsed; });
+
+    for (auto& entry : entries)
+    {
+        std::error_code file_ec;
+        if (fs::remove(entry.path, file_ec)) totalSize -= entry.size;
+        if (totalSize <= maxSize) break;
+    }
+}
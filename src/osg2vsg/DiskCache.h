@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <osg/Node>
+
+#include "BuildOptions.h"
+
+#include <string>
+#include <vector>
+
+namespace osg2vsg
+{
+    /// persistent cache of converted scene graphs stored as .vsgb files, keyed by a hash of the source file and of the BuildOptions used to convert it.
+    /// Each entry records the size and modification time of the images the conversion read, and is ignored once any of them change.
+    /// Entries are written to a temporary file and renamed into place so several processes can safely share the same directory.
+    /// Reading an entry marks it as recently used, when the directory grows beyond maxSize the least recently used entries are removed.
+    class DiskCache : public vsg::Inherit<vsg::Object, DiskCache>
+    {
+    public:
+        DiskCache(const vsg::Path& in_directory, uint64_t in_maxSize);
+
+        struct Key
+        {
+            uint64_t source = 0;
+            uint64_t buildOptions = 0;
+        };
+
+        /// increment when the conversion changes in a way that invalidates existing entries
+        static constexpr uint64_t formatVersion = 2;
+
+        /// compute the key for sourceFile converted with buildOptions and the converter selected by options, return false if the source file can't be read.
+        static bool computeKey(const vsg::Path& sourceFile, const BuildOptions& buildOptions, const vsg::Options* options, Key& key);
+
+        /// files other than the source file that converting scene, loaded from sourceFile, depends on: the images of its textures and the _NML and _AORM maps
+        /// osg2vsg::convert() looks for alongside each diffuse image, whether or not those exist.
+        static std::vector<std::string> collectDependencies(osg::Node& scene, const vsg::Path& sourceFile);
+
+        vsg::Path directory;
+        uint64_t maxSize = 0; // 0 for no limit
+
+        vsg::Path entryPath(const Key& key) const;
+
+        /// read entry, returns null if the entry doesn't exist, can't be read or any of its dependencies have changed since it was written.
+        vsg::ref_ptr<vsg::Object> read(const Key& key, vsg::ref_ptr<const vsg::Options> options) const;
+
+        /// write object to the cache along with the current state of its dependencies, replacing any existing entry.
+        bool write(const Key& key, vsg::ref_ptr<vsg::Object> object, const std::vector<std::string>& dependencies, vsg::ref_ptr<const vsg::Options> options) const;
+
+        /// remove least recently used entries until the total size of the entries is no more than maxSize.
+        void evict() const;
+
+    protected:
+        virtual ~DiskCache();
+    };
+
+} // namespace osg2vsg
+
+EVSG_type_name(osg2vsg::DiskCache);
@@ -11,95 +11,61 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 </editor-fold> */
 
 #include "GeometryUtils.h"
+#include "ArrayUtils.h"
+#include "Hash.h"
 #include "ImageUtils.h"
+#include "PrimitiveDecoder.h"
 #include "ShaderUtils.h"
+#include "Simplify.h"
+#include "Tangents.h"
 
-#include <osg/TemplatePrimitiveIndexFunctor>
 #include <osgUtil/MeshOptimizers>
-#include <osgUtil/TangentSpaceGenerator>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
 
 namespace osg2vsg
 {
 
-    vsg::ref_ptr<vsg::vec2Array> convertToVsg(const osg::Vec2Array* inarray, uint32_t bindOverallPaddingCount)
+    // osg and vsg vector types have the same memory layout so arrays are converted with a bulk copy, the C runtime's memcpy already
+    // selects the widest SIMD copy the CPU supports at runtime, so hand written SSE/AVX loops don't improve on it.
+    template<class VsgArray, class OsgArray>
+    vsg::ref_ptr<VsgArray> convertArray(const OsgArray* inarray, uint32_t bindOverallPaddingCount)
     {
-        if (!inarray) return vsg::ref_ptr<vsg::vec2Array>();
+        using value_type = typename VsgArray::value_type;
+        static_assert(sizeof(value_type) == sizeof(typename OsgArray::ElementDataType), "osg and vsg array elements must have the same memory layout.");
 
         uint32_t count = inarray->size();
         uint32_t targetSize = std::max(count, bindOverallPaddingCount);
 
-        vsg::ref_ptr<vsg::vec2Array> outarray(new vsg::vec2Array(targetSize));
-        uint32_t i = 0;
-        for (; i < count; ++i)
-        {
-            const osg::Vec2& in_value = inarray->at(i);
-            outarray->at(i) = vsg::vec2(in_value.x(), in_value.y());
-        }
-
-        if (i < bindOverallPaddingCount)
-        {
-            auto last = outarray->at(count - 1);
-            for (; i < bindOverallPaddingCount; ++i)
-            {
-                outarray->at(i) = last;
-            }
-        }
+        auto outarray = VsgArray::create(targetSize);
+        copyAndPad(outarray->data(), inarray->getDataPointer(), count, targetSize);
 
         return outarray;
     }
 
-    vsg::ref_ptr<vsg::vec3Array> convertToVsg(const osg::Vec3Array* inarray, uint32_t bindOverallPaddingCount)
+    vsg::ref_ptr<vsg::vec2Array> convertToVsg(const osg::Vec2Array* inarray, uint32_t bindOverallPaddingCount)
     {
-        if (!inarray || inarray->size() == 0) return vsg::ref_ptr<vsg::vec3Array>();
-
-        uint32_t count = inarray->size();
-        uint32_t targetSize = std::max(count, bindOverallPaddingCount);
+        if (!inarray) return vsg::ref_ptr<vsg::vec2Array>();
 
-        vsg::ref_ptr<vsg::vec3Array> outarray(new vsg::vec3Array(targetSize));
-        uint32_t i = 0;
-        for (; i < count; ++i)
-        {
-            const osg::Vec3& in_value = inarray->at(i);
-            outarray->at(i) = vsg::vec3(in_value.x(), in_value.y(), in_value.z());
-        }
+        return convertArray<vsg::vec2Array>(inarray, bindOverallPaddingCount);
+    }
 
-        if (i < bindOverallPaddingCount)
-        {
-            auto last = outarray->at(count - 1);
-            for (; i < bindOverallPaddingCount; ++i)
-            {
-                outarray->at(i) = last;
-            }
-        }
+    vsg::ref_ptr<vsg::vec3Array> convertToVsg(const osg::Vec3Array* inarray, uint32_t bindOverallPaddingCount)
+    {
+        if (!inarray || inarray->size() == 0) return vsg::ref_ptr<vsg::vec3Array>();
 
-        return outarray;
+        return convertArray<vsg::vec3Array>(inarray, bindOverallPaddingCount);
     }
 
     vsg::ref_ptr<vsg::vec4Array> convertToVsg(const osg::Vec4Array* inarray, uint32_t bindOverallPaddingCount)
     {
         if (!inarray) return vsg::ref_ptr<vsg::vec4Array>();
 
-        uint32_t count = inarray->size();
-        uint32_t targetSize = std::max(count, bindOverallPaddingCount);
-
-        vsg::ref_ptr<vsg::vec4Array> outarray(new vsg::vec4Array(targetSize));
-        uint32_t i = 0;
-        for (; i < count; ++i)
-        {
-            const osg::Vec4& in_value = inarray->at(i);
-            outarray->at(i) = vsg::vec4(in_value.x(), in_value.y(), in_value.z(), in_value.w());
-        }
-
-        if (i < bindOverallPaddingCount)
-        {
-            auto last = outarray->at(count - 1);
-            for (; i < bindOverallPaddingCount; ++i)
-            {
-                outarray->at(i) = last;
-            }
-        }
-
-        return outarray;
+        return convertArray<vsg::vec4Array>(inarray, bindOverallPaddingCount);
     }
 
     vsg::ref_ptr<vsg::Data> convertToVsg(const osg::Array* inarray, uint32_t bindOverallPaddingCount)
@@ -259,157 +225,789 @@ namespace osg2vsg
         return matvalue;
     }
 
-    struct ConvertPrimitives
+    template<class A>
+    vsg::ref_ptr<vsg::Data> gatherValues(const vsg::Data* data, const std::vector<uint32_t>& sources)
     {
-        std::vector<uint32_t> points;
-        std::vector<uint32_t> lines;
-        std::vector<uint32_t> triangles;
-        std::vector<uint32_t> quads;
+        auto source = data->cast<A>();
+        if (!source) return {};
+
+        auto gathered = A::create(static_cast<uint32_t>(sources.size()));
+        gathered->properties = source->properties;
+        for (size_t i = 0; i < sources.size(); ++i) gathered->at(i) = source->at(sources[i]);
+        return gathered;
+    }
 
-        void operator()(unsigned int i0)
+    // indices of the per vertex arrays, those with as many values as arrays.front(), returns false if any of them is of a type gatherVertices() doesn't support
+    bool getPerVertexArrays(const vsg::DataList& arrays, std::vector<size_t>& perVertexArrays)
+    {
+        if (arrays.empty() || !arrays.front()) return false;
+
+        size_t numVertices = arrays.front()->valueCount();
+        for (size_t i = 0; i < arrays.size(); ++i)
         {
-            points.push_back(i0);
+            auto& data = arrays[i];
+            if (!data || data->valueCount() != numVertices) continue;
+            if (data->dataSize() != numVertices * data->valueSize()) return false;
+            if (!data->cast<vsg::vec2Array>() && !data->cast<vsg::vec3Array>() && !data->cast<vsg::vec4Array>() && !data->cast<vsg::ubvec4Array>()) return false;
+            perVertexArrays.push_back(i);
         }
-        void operator()(unsigned int i0, unsigned int i1)
+        return true;
+    }
+
+    // replace each per vertex array with an array of the values at sources
+    void gatherVertices(vsg::DataList& arrays, const std::vector<size_t>& perVertexArrays, const std::vector<uint32_t>& sources)
+    {
+        for (auto i : perVertexArrays)
         {
-            lines.push_back(i0);
-            lines.push_back(i1);
+            auto& data = arrays[i];
+            vsg::ref_ptr<vsg::Data> gathered = gatherValues<vsg::vec3Array>(data.get(), sources);
+            if (!gathered) gathered = gatherValues<vsg::vec2Array>(data.get(), sources);
+            if (!gathered) gathered = gatherValues<vsg::vec4Array>(data.get(), sources);
+            if (!gathered) gathered = gatherValues<vsg::ubvec4Array>(data.get(), sources);
+            data = gathered;
         }
-        void operator()(unsigned int i0, unsigned int i1, unsigned int i2)
+    }
+
+    bool weldVertices(vsg::DataList& arrays, const vsg::Data* normals, std::vector<uint32_t>& indices, const VertexWelding& welding)
+    {
+        std::vector<size_t> perVertexArrays;
+        if (indices.empty() || !getPerVertexArrays(arrays, perVertexArrays)) return false;
+
+        size_t numVertices = arrays.front()->valueCount();
+
+        enum Comparison
+        {
+            EXACT,
+            QUANTIZE_POSITION,
+            QUANTIZE_NORMAL
+        };
+
+        struct Stream
         {
-            triangles.push_back(i0);
-            triangles.push_back(i1);
-            triangles.push_back(i2);
+            const uint8_t* data;
+            size_t valueSize;
+            Comparison comparison;
+        };
+
+        std::vector<Stream> streams;
+        for (auto i : perVertexArrays)
+        {
+            auto& data = arrays[i];
+
+            Comparison comparison = EXACT;
+            if (data->cast<vsg::vec3Array>())
+            {
+                if (i == 0 && welding.positionEpsilon > 0.0f) comparison = QUANTIZE_POSITION;
+                else if (data.get() == normals && welding.normalEpsilon > 0.0f) comparison = QUANTIZE_NORMAL;
+            }
+            streams.push_back(Stream{static_cast<const uint8_t*>(data->dataPointer()), data->valueSize(), comparison});
         }
-        void operator()(unsigned int i0, unsigned int i1, unsigned int i2, unsigned int i3)
+
+        for (auto index : indices)
         {
-            quads.push_back(i0);
-            quads.push_back(i1);
-            quads.push_back(i2);
-            quads.push_back(i3);
+            if (index >= numVertices) return false;
         }
-    };
 
-    vsg::ref_ptr<vsg::Command> convertToVsg(osg::Geometry* ingeometry, uint32_t requiredAttributesMask, GeometryTarget geometryTarget)
-    {
-        uint32_t instanceCount = 1;
+        // the bytes compared for each vertex, positions and normals within epsilon of each other land on the same grid point
+        auto computeKey = [&](uint32_t v, std::vector<uint8_t>& key) {
+            key.clear();
+            for (auto& stream : streams)
+            {
+                const uint8_t* value = stream.data + v * stream.valueSize;
+                if (stream.comparison == EXACT)
+                {
+                    key.insert(key.end(), value, value + stream.valueSize);
+                    continue;
+                }
 
-        // work out if we need to enable instancing by looking at BIND_OVERALL entries
-        // to see if any have more than one element which we'll interpret as requesting instancing, such as for our custom osg::Billboard handling.
+                float epsilon = (stream.comparison == QUANTIZE_POSITION) ? welding.positionEpsilon : welding.normalEpsilon;
+                auto& vec = *reinterpret_cast<const vsg::vec3*>(value);
+                for (int c = 0; c < 3; ++c)
+                {
+                    int64_t q = std::llround(static_cast<double>(vec[c]) / epsilon);
+                    key.insert(key.end(), reinterpret_cast<const uint8_t*>(&q), reinterpret_cast<const uint8_t*>(&q) + sizeof(q));
+                }
+            }
+        };
+
+        // open addressed hash table of welded vertices, sized to stay at most half full so probe sequences remain short
+        size_t capacity = 1;
+        while (capacity < numVertices * 2) capacity <<= 1;
+        constexpr uint32_t empty = std::numeric_limits<uint32_t>::max();
+        std::vector<uint32_t> table(capacity, empty);
+
+        std::vector<uint32_t> remap(numVertices, empty);
+        std::vector<uint32_t> sources;
+        std::vector<uint64_t> sourceHashes;
+        std::vector<uint32_t> weldedIndices(indices.size());
+        std::vector<uint8_t> key, otherKey;
+
+        for (size_t i = 0; i < indices.size(); ++i)
         {
-            osg::Geometry::ArrayList arrays;
-            if (ingeometry->getArrayList(arrays))
+            uint32_t v = indices[i];
+            if (remap[v] == empty)
             {
-                for (auto& array : arrays)
+                computeKey(v, key);
+                uint64_t hash = hash64(key.data(), key.size());
+
+                for (size_t slot = hash & (capacity - 1);; slot = (slot + 1) & (capacity - 1))
                 {
-                    if (array->getBinding() == osg::Array::BIND_OVERALL)
+                    uint32_t welded = table[slot];
+                    if (welded == empty)
                     {
-                        if (instanceCount < array->getNumElements()) instanceCount = array->getNumElements();
+                        welded = static_cast<uint32_t>(sources.size());
+                        sources.push_back(v);
+                        sourceHashes.push_back(hash);
+                        table[slot] = welded;
+                        remap[v] = welded;
+                        break;
+                    }
+
+                    if (sourceHashes[welded] == hash)
+                    {
+                        computeKey(sources[welded], otherKey);
+                        if (key == otherKey)
+                        {
+                            remap[v] = welded;
+                            break;
+                        }
                     }
                 }
             }
+            weldedIndices[i] = remap[v];
         }
 
-        uint32_t bindOverallPaddingCount = instanceCount;
+        if (sources.size() == numVertices) return false;
 
-        // convert attribute arrays, create defaults for any requested attributes that don't exist for now to ensure pipeline gets required data
-        vsg::ref_ptr<vsg::Data> vertices(osg2vsg::convertToVsg(ingeometry->getVertexArray(), bindOverallPaddingCount));
-        if (!vertices.valid() || vertices->valueCount() == 0) return {};
+        gatherVertices(arrays, perVertexArrays, sources);
+        indices.swap(weldedIndices);
 
-        // normals
-        vsg::ref_ptr<vsg::Data> normals(osg2vsg::convertToVsg(ingeometry->getNormalArray(), bindOverallPaddingCount));
+        return true;
+    }
 
-        // tangents
-        vsg::ref_ptr<vsg::Data> tangents(osg2vsg::convertToVsg(ingeometry->getVertexAttribArray(6), bindOverallPaddingCount));
-        if ((!tangents.valid() || tangents->valueCount() == 0) && (requiredAttributesMask & TANGENT))
+    struct IndexChunk
+    {
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+        int32_t vertexOffset = 0;
+    };
+
+    // split the triangles into runs that each reference at most maxVertices vertices, duplicating the vertices shared between runs so each run's vertices are contiguous
+    // and its indices can be made relative to its first vertex
+    bool splitIntoChunks(vsg::DataList& arrays, std::vector<uint32_t>& indices, uint32_t maxVertices, std::vector<IndexChunk>& chunks)
+    {
+        std::vector<size_t> perVertexArrays;
+        if (indices.empty() || !getPerVertexArrays(arrays, perVertexArrays)) return false;
+
+        size_t numVertices = arrays.front()->valueCount();
+        constexpr uint32_t unassigned = std::numeric_limits<uint32_t>::max();
+        std::vector<uint32_t> vertexChunk(numVertices, unassigned);
+        std::vector<uint32_t> localIndex(numVertices, 0);
+        std::vector<uint32_t> sources;
+
+        IndexChunk chunk;
+        uint32_t chunkNumber = 0;
+        for (size_t t = 0; t + 2 < indices.size(); t += 3)
         {
-            osg::ref_ptr<osgUtil::TangentSpaceGenerator> tangentSpaceGenerator = new osgUtil::TangentSpaceGenerator();
-            tangentSpaceGenerator->generate(ingeometry, 0);
+            uint32_t a = indices[t], b = indices[t + 1], c = indices[t + 2];
+            uint32_t newVertices = (vertexChunk[a] != chunkNumber ? 1 : 0) + (vertexChunk[b] != chunkNumber && b != a ? 1 : 0) + (vertexChunk[c] != chunkNumber && c != a && c != b ? 1 : 0);
+            uint32_t chunkVertices = static_cast<uint32_t>(sources.size()) - static_cast<uint32_t>(chunk.vertexOffset);
+            if (chunkVertices + newVertices > maxVertices)
+            {
+                chunk.indexCount = static_cast<uint32_t>(t) - chunk.firstIndex;
+                chunks.push_back(chunk);
 
-            osg::Vec4Array* tangentArray = tangentSpaceGenerator->getTangentArray();
-            //osg::Vec4Array* biNormalArray = tangGen->getBinormalArray();
+                ++chunkNumber;
+                chunk.firstIndex = static_cast<uint32_t>(t);
+                chunk.vertexOffset = static_cast<int32_t>(sources.size());
+            }
 
-            if (tangentArray && tangentArray->size() > 0)
+            for (size_t k = t; k < t + 3; ++k)
             {
-                tangents = osg2vsg::convertToVsg(tangentArray, bindOverallPaddingCount);
-                // bind them to the osg geometry too??
-                ingeometry->setVertexAttribArray(6, tangentArray);
-                ingeometry->setVertexAttribBinding(6, osg::Geometry::BIND_PER_VERTEX);
+                uint32_t v = indices[k];
+                if (vertexChunk[v] != chunkNumber)
+                {
+                    vertexChunk[v] = chunkNumber;
+                    localIndex[v] = static_cast<uint32_t>(sources.size()) - static_cast<uint32_t>(chunk.vertexOffset);
+                    sources.push_back(v);
+                }
+                indices[k] = localIndex[v];
             }
         }
+        chunk.indexCount = static_cast<uint32_t>(indices.size()) - chunk.firstIndex;
+        chunks.push_back(chunk);
 
-        // colors
-        vsg::ref_ptr<vsg::Data> colors(osg2vsg::convertToVsg(ingeometry->getColorArray(), bindOverallPaddingCount));
+        gatherVertices(arrays, perVertexArrays, sources);
+        return true;
+    }
 
-        // tex0
-        vsg::ref_ptr<vsg::Data> texcoord0(osg2vsg::convertToVsg(ingeometry->getTexCoordArray(0), bindOverallPaddingCount));
+    void generateTriangleStrips(const std::vector<uint32_t>& triangles, std::vector<uint32_t>& strips)
+    {
+        size_t numTriangles = triangles.size() / 3;
 
-        vsg::ref_ptr<vsg::Data> translations(osg2vsg::convertToVsg(ingeometry->getVertexAttribArray(7), bindOverallPaddingCount));
+        // directed edges of each triangle, sorted so the triangles continuing a strip across an edge can be found with a binary search
+        struct Edge
+        {
+            uint64_t key;
+            uint32_t triangle;
+            uint32_t opposite;
 
-        // fill arrays data list THE ORDER HERE IS IMPORTANT
-        auto attributeArrays = vsg::DataList{vertices}; // always have vertices
-        if (normals.valid() && normals->valueCount() > 0) attributeArrays.push_back(normals);
-        if (tangents.valid() && tangents->valueCount() > 0) attributeArrays.push_back(tangents);
-        if (colors.valid() && colors->valueCount() > 0) attributeArrays.push_back(colors);
-        if (texcoord0.valid() && texcoord0->valueCount() > 0) attributeArrays.push_back(texcoord0);
-        if (translations.valid() && translations->valueCount() > 0) attributeArrays.push_back(translations);
+            bool operator<(const Edge& rhs) const { return key < rhs.key; }
+        };
 
-        // convert indices
+        auto edgeKey = [](uint32_t a, uint32_t b) { return (static_cast<uint64_t>(a) << 32) | b; };
 
-        // assume all the draw elements use the same primitive mode, copy all drawelements indices into one index array and use a single drawindexed command
-        // create a draw command per drawarrays primitive set
+        std::vector<Edge> edges;
+        edges.reserve(numTriangles * 3);
+        for (uint32_t t = 0; t < numTriangles; ++t)
+        {
+            const uint32_t* v = &triangles[t * 3];
+            edges.push_back(Edge{edgeKey(v[0], v[1]), t, v[2]});
+            edges.push_back(Edge{edgeKey(v[1], v[2]), t, v[0]});
+            edges.push_back(Edge{edgeKey(v[2], v[0]), t, v[1]});
+        }
+        std::sort(edges.begin(), edges.end());
+
+        std::vector<bool> used(numTriangles, false);
+
+        // return the edge of an unused triangle that has the directed edge a->b
+        auto findTriangle = [&](uint32_t a, uint32_t b) -> const Edge* {
+            Edge search{edgeKey(a, b), 0, 0};
+            for (auto itr = std::lower_bound(edges.begin(), edges.end(), search); itr != edges.end() && itr->key == search.key; ++itr)
+            {
+                if (!used[itr->triangle]) return &(*itr);
+            }
+            return nullptr;
+        };
+
+        strips.clear();
+        for (uint32_t t = 0; t < numTriangles; ++t)
+        {
+            if (used[t]) continue;
+            used[t] = true;
+
+            // the second triangle of a strip a,b,c,d is c,b,d, so start with the rotation of t that has an unused neighbour across its last edge
+            const uint32_t* v = &triangles[t * 3];
+            uint32_t rotation = 0;
+            for (uint32_t r = 0; r < 3; ++r)
+            {
+                if (findTriangle(v[(r + 2) % 3], v[(r + 1) % 3]))
+                {
+                    rotation = r;
+                    break;
+                }
+            }
+
+            if (!strips.empty()) strips.push_back(primitiveRestartIndex);
+            size_t stripStart = strips.size();
+            strips.push_back(v[rotation]);
+            strips.push_back(v[(rotation + 1) % 3]);
+            strips.push_back(v[(rotation + 2) % 3]);
+
+            // odd triangles of a strip have their first two vertices swapped to keep the winding consistent
+            for (size_t k = 1;; ++k)
+            {
+                uint32_t a = strips[stripStart + k];
+                uint32_t b = strips[stripStart + k + 1];
+                const Edge* next = (k % 2 == 0) ? findTriangle(a, b) : findTriangle(b, a);
+                if (!next) break;
+
+                used[next->triangle] = true;
+                strips.push_back(next->opposite);
+            }
+        }
+    }
+
+    // IEEE 754 half float with round to nearest even, values beyond the half range become infinity
+    uint16_t floatToHalf(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        uint32_t sign = (bits >> 16) & 0x8000;
+        uint32_t magnitude = bits & 0x7fffffff;
+
+        if (magnitude >= 0x7f800000) return static_cast<uint16_t>(sign | 0x7c00 | (magnitude > 0x7f800000 ? 0x200 : 0)); // inf or nan
+        if (magnitude >= 0x477ff000) return static_cast<uint16_t>(sign | 0x7c00);                                         // overflows to inf
+        if (magnitude < 0x38800000)
+        {
+            // denormal half, shift the mantissa with its implicit bit into place and round
+            if (magnitude < 0x33000000) return static_cast<uint16_t>(sign);
+            uint32_t exponent = magnitude >> 23;
+            uint32_t mantissa = (magnitude & 0x7fffff) | 0x800000;
+            uint32_t shift = 126 - exponent;
+            uint32_t half = mantissa >> shift;
+            uint32_t remainder = mantissa & ((1u << shift) - 1);
+            uint32_t halfway = 1u << (shift - 1);
+            if (remainder > halfway || (remainder == halfway && (half & 1))) ++half;
+            return static_cast<uint16_t>(sign | half);
+        }
+
+        uint32_t half = (magnitude - 0x38000000) >> 13;
+        uint32_t remainder = magnitude & 0x1fff;
+        if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) ++half;
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    float halfToFloat(uint16_t value)
+    {
+        uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+        uint32_t exponent = (value >> 10) & 0x1f;
+        uint32_t mantissa = value & 0x3ff;
+
+        if (exponent == 0)
+        {
+            float magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+            return sign ? -magnitude : magnitude;
+        }
+
+        uint32_t bits = sign | ((exponent == 31 ? 255 : exponent + 112) << 23) | (mantissa << 13);
+        float result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    float snorm16ToFloat(int16_t value)
+    {
+        return std::max(static_cast<float>(value) / 32767.0f, -1.0f);
+    }
+
+    vsg::vec3 octahedralDecode(const vsg::vec2& e)
+    {
+        vsg::vec3 v(e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y));
+        if (v.z < 0.0f)
+        {
+            float x = v.x, y = v.y;
+            v.x = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+            v.y = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        }
+        return v;
+    }
+
+    // angle in degrees between two directions, 0 if either has no length
+    double angleBetween(const vsg::vec3& a, const vsg::vec3& b)
+    {
+        vsg::dvec3 da(a), db(b);
+        double lengths = vsg::length(da) * vsg::length(db);
+        if (lengths <= 0.0) return 0.0;
+        return std::acos(std::clamp(vsg::dot(da, db) / lengths, -1.0, 1.0)) * (180.0 / vsg::PI);
+    }
+
+    // project onto the octahedron and unfold its lower half, then pick whichever rounding of the snorm16 components decodes closest to the original direction
+    vsg::svec2 octahedralEncode(const vsg::vec3& n, double& error)
+    {
+        float sum = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+        if (sum <= 0.0f)
+        {
+            error = 0.0;
+            return vsg::svec2(0, 0);
+        }
+
+        vsg::vec2 e(n.x / sum, n.y / sum);
+        if (n.z < 0.0f)
+        {
+            float x = e.x, y = e.y;
+            e.x = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+            e.y = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        }
+
+        vsg::svec2 best;
+        error = std::numeric_limits<double>::max();
+        float fx = std::floor(e.x * 32767.0f), fy = std::floor(e.y * 32767.0f);
+        for (float qx = fx; qx <= fx + 1.0f; qx += 1.0f)
+        {
+            for (float qy = fy; qy <= fy + 1.0f; qy += 1.0f)
+            {
+                vsg::svec2 candidate(static_cast<int16_t>(std::clamp(qx, -32767.0f, 32767.0f)), static_cast<int16_t>(std::clamp(qy, -32767.0f, 32767.0f)));
+                double candidateError = angleBetween(n, octahedralDecode(vsg::vec2(snorm16ToFloat(candidate.x), snorm16ToFloat(candidate.y))));
+                if (candidateError < error)
+                {
+                    error = candidateError;
+                    best = candidate;
+                }
+            }
+        }
+        return best;
+    }
+
+    vsg::ref_ptr<vsg::Data> compressNormals(const vsg::vec3Array& normals, double& maxError)
+    {
+        auto compressed = vsg::svec2Array::create(normals.size());
+        compressed->properties.format = VK_FORMAT_R16G16_SNORM;
+        maxError = 0.0;
+        for (size_t i = 0; i < normals.size(); ++i)
+        {
+            double error;
+            compressed->at(i) = octahedralEncode(normals.at(i), error);
+            maxError = std::max(maxError, error);
+        }
+        return compressed;
+    }
+
+    vsg::ref_ptr<vsg::Data> compressTangents(const vsg::vec4Array& tangents, double& maxError)
+    {
+        auto compressed = vsg::svec4Array::create(tangents.size());
+        compressed->properties.format = VK_FORMAT_R16G16B16A16_SNORM;
+        maxError = 0.0;
+        for (size_t i = 0; i < tangents.size(); ++i)
+        {
+            auto& t = tangents.at(i);
+            double error;
+            auto e = octahedralEncode(vsg::vec3(t.x, t.y, t.z), error);
+            compressed->at(i) = vsg::svec4(e.x, e.y, static_cast<int16_t>(t.w < 0.0f ? -32767 : 32767), 0);
+            maxError = std::max(maxError, error);
+        }
+        return compressed;
+    }
+
+    vsg::ref_ptr<vsg::Data> compressColors(const vsg::vec4Array& colors, double& maxError)
+    {
+        auto compressed = vsg::ubvec4Array::create(colors.size());
+        compressed->properties.format = VK_FORMAT_R8G8B8A8_UNORM;
+        maxError = 0.0;
+        for (size_t i = 0; i < colors.size(); ++i)
+        {
+            auto& c = colors.at(i);
+            auto& out = compressed->at(i);
+            for (int k = 0; k < 4; ++k)
+            {
+                float quantized = std::round(std::clamp(c[k], 0.0f, 1.0f) * 255.0f);
+                out[k] = static_cast<uint8_t>(quantized);
+                maxError = std::max(maxError, static_cast<double>(std::abs(quantized / 255.0f - c[k])));
+            }
+        }
+        return compressed;
+    }
+
+    vsg::ref_ptr<vsg::Data> compressTexCoords(const vsg::vec2Array& texcoords, TexCoordCompression texCoordCompression, double& maxError, uint32_t& format)
+    {
+        bool normalized = texCoordCompression == TEXCOORD_COMPRESSION_UNORM16;
+        for (auto& tc : texcoords)
+        {
+            if (!(tc.x >= 0.0f && tc.x <= 1.0f && tc.y >= 0.0f && tc.y <= 1.0f)) normalized = false;
+        }
+
+        auto compressed = vsg::usvec2Array::create(texcoords.size());
+        compressed->properties.format = normalized ? VK_FORMAT_R16G16_UNORM : VK_FORMAT_R16G16_SFLOAT;
+        format = normalized ? TEXCOORD0_UNORM16 : TEXCOORD0_HALF;
+        maxError = 0.0;
+        for (size_t i = 0; i < texcoords.size(); ++i)
+        {
+            auto& tc = texcoords.at(i);
+            auto& out = compressed->at(i);
+            for (int k = 0; k < 2; ++k)
+            {
+                float decoded;
+                if (normalized)
+                {
+                    out[k] = static_cast<uint16_t>(std::round(tc[k] * 65535.0f));
+                    decoded = static_cast<float>(out[k]) / 65535.0f;
+                }
+                else
+                {
+                    out[k] = floatToHalf(tc[k]);
+                    decoded = halfToFloat(out[k]);
+                }
+                double error = std::isfinite(decoded) ? std::abs(static_cast<double>(decoded) - tc[k]) : std::numeric_limits<double>::max();
+                maxError = std::max(maxError, error);
+            }
+        }
+        return compressed;
+    }
+
+    bool compressPositions(vsg::ref_ptr<vsg::Data>& vertices, const VertexCompression& compression, VertexCompressionReport& report)
+    {
+        auto positions = vertices.cast<vsg::vec3Array>();
+        if (!positions || positions->size() == 0 || compression.positionCompression == POSITION_COMPRESSION_NONE) return false;
+
+        vsg::dbox bound;
+        for (auto& position : *positions) bound.add(vsg::dvec3(position));
+
+        // a single scale for all axes keeps the folded transform from skewing normals, the shaders transform normals by the modelview matrix and normalize them
+        auto extents = bound.max - bound.min;
+        double scale = std::max(std::max(extents.x, extents.y), extents.z);
+        if (scale <= 0.0) scale = 1.0;
+
+        // the vertex input stage reads unorm16 values as 0 to 1 and snorm16 as -1 to 1, so the transform maps those ranges onto the bounding box
+        bool snorm = compression.positionCompression == POSITION_COMPRESSION_SNORM16;
+        vsg::dvec3 origin = snorm ? (bound.min + bound.max) * 0.5 : bound.min;
+        if (snorm) scale *= 0.5;
+        double range = snorm ? 32767.0 : 65535.0;
+
+        vsg::ref_ptr<vsg::Data> compressed;
+        double maxError = 0.0;
+        auto quantize = [&](auto& outArray, double minValue) {
+            for (size_t i = 0; i < positions->size(); ++i)
+            {
+                vsg::dvec3 p(positions->at(i));
+                vsg::dvec3 normalized = (p - origin) / scale;
+                auto& out = outArray.at(i);
+                double decodedLengthSquared = 0.0;
+                for (int k = 0; k < 3; ++k)
+                {
+                    double q = std::clamp(std::round(normalized[k] * range), minValue, range);
+                    out[k] = static_cast<typename std::decay_t<decltype(out)>::value_type>(q);
+                    double difference = origin[k] + (q / range) * scale - p[k];
+                    decodedLengthSquared += difference * difference;
+                }
+                out[3] = 0;
+                maxError = std::max(maxError, std::sqrt(decodedLengthSquared));
+            }
+        };
+
+        if (snorm)
+        {
+            auto array = vsg::svec4Array::create(positions->size());
+            array->properties.format = VK_FORMAT_R16G16B16A16_SNORM;
+            quantize(*array, -range);
+            compressed = array;
+        }
+        else
+        {
+            auto array = vsg::usvec4Array::create(positions->size());
+            array->properties.format = VK_FORMAT_R16G16B16A16_UNORM;
+            quantize(*array, 0.0);
+            compressed = array;
+        }
 
+        report.positionError = static_cast<float>(maxError);
+        if (maxError > compression.positionTolerance)
+        {
+            ++report.numStreamsRejected;
+            return false;
+        }
+
+        vertices = compressed;
+        report.positionTransform = vsg::translate(origin) * vsg::scale(scale);
+        report.compressedAttributes |= snorm ? VERTEX_SNORM16 : VERTEX_UNORM16;
+        return true;
+    }
+
+    uint32_t compressVertexArrays(vsg::DataList& arrays, const std::vector<uint32_t>& attributeTypes, const VertexCompression& compression, VertexCompressionReport& report)
+    {
+        uint32_t compressedAttributes = 0;
+        for (size_t i = 0; i < arrays.size() && i < attributeTypes.size(); ++i)
+        {
+            auto& data = arrays[i];
+            if (!data) continue;
+
+            vsg::ref_ptr<vsg::Data> compressed;
+            double error = 0.0;
+            float tolerance = 0.0f;
+            float* reportedError = nullptr;
+            uint32_t format = 0;
+
+            switch (attributeTypes[i])
+            {
+            case NORMAL:
+                if (auto normals = data->cast<vsg::vec3Array>()) compressed = compressNormals(*normals, error);
+                tolerance = compression.normalTolerance;
+                reportedError = &report.normalError;
+                format = NORMAL_OCT16;
+                break;
+            case TANGENT:
+                if (auto tangents = data->cast<vsg::vec4Array>()) compressed = compressTangents(*tangents, error);
+                tolerance = compression.normalTolerance;
+                reportedError = &report.tangentError;
+                format = TANGENT_OCT16;
+                break;
+            case COLOR:
+                if (auto colors = data->cast<vsg::vec4Array>()) compressed = compressColors(*colors, error);
+                tolerance = compression.colorTolerance;
+                reportedError = &report.colorError;
+                format = COLOR_UNORM8;
+                break;
+            case TEXCOORD0:
+                if (auto texcoords = data->cast<vsg::vec2Array>()) compressed = compressTexCoords(*texcoords, compression.texCoordCompression, error, format);
+                tolerance = compression.texCoordTolerance;
+                reportedError = &report.texCoordError;
+                break;
+            default:
+                break;
+            }
+
+            if (!compressed) continue;
+
+            *reportedError = static_cast<float>(error);
+            if (compression.enforceTolerances && error > tolerance)
+            {
+                ++report.numStreamsRejected;
+                continue;
+            }
+
+            data = compressed;
+            compressedAttributes |= format;
+        }
+        return compressedAttributes;
+    }
+
+    void GeometryStatistics::add(const GeometryStatistics& other)
+    {
+        indexBytes += other.indexBytes;
+        indexBytesSaved += other.indexBytesSaved;
+        numMeshesSplit += other.numMeshesSplit;
+        stripBytesSaved += other.stripBytesSaved;
+        numMeshesStripped += other.numMeshesStripped;
+        vertexBytes += other.vertexBytes;
+        vertexBytesSaved += other.vertexBytesSaved;
+        numStreamsRejected += other.numStreamsRejected;
+        numMeshesSimplified += other.numMeshesSimplified;
+        simplifiedTriangles += other.simplifiedTriangles;
+        for (uint32_t level = 0; level < maxSimplifiedLevels; ++level) levelTriangles[level] += other.levelTriangles[level];
+        vertexBytesPruned += other.vertexBytesPruned;
+        numStreamsPruned += other.numStreamsPruned;
+    }
+
+    VkPrimitiveTopology getTopology(const vsg::StateGroup& stateGroup)
+    {
+        for (auto& stateCommand : stateGroup.stateCommands)
+        {
+            auto bindGraphicsPipeline = stateCommand->cast<vsg::BindGraphicsPipeline>();
+            if (!bindGraphicsPipeline || !bindGraphicsPipeline->pipeline) continue;
+
+            for (auto& pipelineState : bindGraphicsPipeline->pipeline->pipelineStates)
+            {
+                if (auto inputAssemblyState = pipelineState->cast<vsg::InputAssemblyState>()) return inputAssemblyState->topology;
+            }
+        }
+        return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    }
+
+    bool computePositionBound(const vsg::Data* vertices, const vsg::dmat4* positionTransform, vsg::dbox& bound)
+    {
+        if (!vertices) return false;
+
+        if (!positionTransform)
+        {
+            auto positions = vertices->cast<vsg::vec3Array>();
+            if (!positions) return false;
+
+            for (auto& vertex : *positions) bound.add(vsg::dvec3(vertex));
+            return true;
+        }
+
+        // compressed positions are normalized to [0, 1] or [-1, 1] within the geometry's bounding box
+        vsg::dbox normalized;
+        if (auto unorm = vertices->cast<vsg::usvec4Array>())
+        {
+            for (auto& vertex : *unorm) normalized.add(vsg::dvec3(vertex.x, vertex.y, vertex.z) / 65535.0);
+        }
+        else if (auto snorm = vertices->cast<vsg::svec4Array>())
+        {
+            for (auto& vertex : *snorm) normalized.add(vsg::dvec3(std::max(vertex.x / 32767.0, -1.0), std::max(vertex.y / 32767.0, -1.0), std::max(vertex.z / 32767.0, -1.0)));
+        }
+        else
+        {
+            return false;
+        }
+
+        // the transform only translates and scales, so the corners of the normalized bound map to those of the decoded bound
+        if (normalized.valid())
+        {
+            bound.add((*positionTransform) * normalized.min);
+            bound.add((*positionTransform) * normalized.max);
+        }
+        return true;
+    }
+
+    // split, strip and compress the triangles and vertex arrays of a converted geometry, then create the command drawing them according to geometryTarget
+    vsg::ref_ptr<vsg::Command> createDrawCommand(const std::string& name, vsg::DataList attributeArrays, const std::vector<uint32_t>& attributeTypes, std::vector<uint32_t> triangles, uint32_t instanceCount, GeometryTarget geometryTarget,
+                                                 bool splitLargeMeshes, GeometryStatistics* statistics, VkPrimitiveTopology* topology, const VertexCompression& compression, VertexCompressionReport* report)
+    {
         vsg::Geometry::DrawCommands drawCommands;
 
-        osg::TemplatePrimitiveIndexFunctor<ConvertPrimitives> collectPrimitives;
-        ingeometry->accept(collectPrimitives);
-#if 0
-        // TODO : need to add support for points and lines.
-        if (collectPrimitives.points.size()>0)
+        // use 16 bit indices whenever the largest index fits, larger meshes can be split into chunks of 65535 vertices drawn with their own vertexOffset so they can use 16 bit indices too
+        std::vector<IndexChunk> chunks;
+        uint32_t maxIndex = *std::max_element(triangles.begin(), triangles.end());
+        if (maxIndex > 65535 && splitLargeMeshes && instanceCount == 1 && splitIntoChunks(attributeArrays, triangles, 65535, chunks))
+        {
+            maxIndex = *std::max_element(triangles.begin(), triangles.end());
+            if (statistics) ++statistics->numMeshesSplit;
+        }
+        else
         {
-            std::cout<<"Warning: points not yet supported by vsgXchange/OSG loader."<<std::endl;
+            chunks.assign(1, IndexChunk{0, static_cast<uint32_t>(triangles.size()), 0});
         }
 
-        if (collectPrimitives.lines.size()>0)
+        // draw as triangle strips joined by primitive restart indices when that needs fewer index bytes than the triangle list, 0xffff is reserved for the restart so 16 bit strips can only index 65535 vertices
+        bool useStrips = false;
+        if (topology && *topology == VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP && chunks.size() == 1)
         {
-            std::cout<<"Warning: lines not yet supported by vsgXchange/OSG loader."<<std::endl;
+            std::vector<uint32_t> strips;
+            generateTriangleStrips(triangles, strips);
+
+            size_t listBytes = triangles.size() * (maxIndex > 65535 ? sizeof(uint32_t) : sizeof(uint16_t));
+            size_t stripBytes = strips.size() * (maxIndex >= 65535 ? sizeof(uint32_t) : sizeof(uint16_t));
+            if (stripBytes < listBytes)
+            {
+                useStrips = true;
+                triangles.swap(strips);
+                chunks.assign(1, IndexChunk{0, static_cast<uint32_t>(triangles.size()), 0});
+
+                if (statistics)
+                {
+                    statistics->stripBytesSaved += listBytes - stripBytes;
+                    ++statistics->numMeshesStripped;
+                }
+            }
         }
-#endif
-        auto& triangles = collectPrimitives.triangles;
-        auto& quads = collectPrimitives.quads;
+        if (topology) *topology = useStrips ? VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP : VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+        // compress the attributes last so welding and splitting work on the full precision values
+        VertexCompressionReport localReport;
+        if (!report) report = &localReport;
+        *report = VertexCompressionReport();
 
-        for (size_t i = 0; i < quads.size(); i += 4)
+        // instanced geometry is positioned by the per instance arrays, which the folded position transform would scale
+        bool compressPositionArray = compression.positionCompression != POSITION_COMPRESSION_NONE && instanceCount == 1;
+        if (compression.enabled || compressPositionArray)
         {
-            triangles.push_back(quads[i + 0]);
-            triangles.push_back(quads[i + 1]);
-            triangles.push_back(quads[i + 2]);
+            size_t uncompressedBytes = 0;
+            for (auto& array : attributeArrays) uncompressedBytes += array->dataSize();
+
+            if (compressPositionArray) compressPositions(attributeArrays.front(), compression, *report);
+            if (compression.enabled) report->compressedAttributes |= compressVertexArrays(attributeArrays, attributeTypes, compression, *report);
 
-            triangles.push_back(quads[i + 0]);
-            triangles.push_back(quads[i + 2]);
-            triangles.push_back(quads[i + 3]);
+            size_t compressedBytes = 0;
+            for (auto& array : attributeArrays) compressedBytes += array->dataSize();
+
+            vsg::debug("osg2vsg compressed vertices of geometry '", name, "' from ", uncompressedBytes, " to ", compressedBytes, " bytes, largest errors: position ", report->positionError, ", normal ", report->normalError,
+                       " degrees, tangent ", report->tangentError, " degrees, texcoord ", report->texCoordError, ", color ", report->colorError, ", streams rejected ", report->numStreamsRejected);
+
+            if (statistics)
+            {
+                statistics->vertexBytesSaved += uncompressedBytes - compressedBytes;
+                statistics->numStreamsRejected += report->numStreamsRejected;
+            }
         }
 
-        // nothing to draw so return a null ref_ptr<>
-        if (triangles.empty()) return {};
+        if (statistics)
+        {
+            for (auto& array : attributeArrays) statistics->vertexBytes += array->dataSize();
+        }
 
         vsg::ref_ptr<vsg::Data> vsgindices;
-        if (vertices->valueCount() > 16384)
+        if (maxIndex > 65535 || (useStrips && maxIndex == 65535))
         {
             auto indices = vsg::uintArray::create(triangles.size());
-            for (size_t i = 0; i < triangles.size(); ++i)
-            {
-                indices->set(i, triangles[i]);
-            }
+            std::memcpy(indices->dataPointer(), triangles.data(), triangles.size() * sizeof(uint32_t));
             vsgindices = indices;
         }
         else
         {
+            // the 32 bit restart index truncates to the 16 bit one
             auto indices = vsg::ushortArray::create(triangles.size());
-            for (size_t i = 0; i < triangles.size(); ++i)
-            {
-                indices->set(i, triangles[i]);
-            }
+            std::transform(triangles.begin(), triangles.end(), indices->begin(), [](uint32_t index) { return static_cast<uint16_t>(index); });
             vsgindices = indices;
+
+            if (statistics) statistics->indexBytesSaved += triangles.size() * (sizeof(uint32_t) - sizeof(uint16_t));
+        }
+        if (statistics) statistics->indexBytes += vsgindices->dataSize();
+
+        vsg::Geometry::DrawCommands indexedDraws;
+        for (auto& chunk : chunks)
+        {
+            indexedDraws.push_back(vsg::DrawIndexed::create(chunk.indexCount, instanceCount, chunk.firstIndex, chunk.vertexOffset, 0));
         }
 
         if (geometryTarget == VSG_COMMANDS)
@@ -426,12 +1024,12 @@ namespace osg2vsg
             if (vsgindices)
             {
                 commands->addChild(vsg::BindIndexBuffer::create(vsgindices));
-                commands->addChild(vsg::DrawIndexed::create(vsgindices->valueCount(), instanceCount, 0, 0, 0));
+                for (auto& draw : indexedDraws) commands->addChild(draw);
             }
 
             return commands;
         }
-        else if (geometryTarget == VSG_VERTEXINDEXDRAW && vsgindices && drawCommands.empty())
+        else if (geometryTarget == VSG_VERTEXINDEXDRAW && vsgindices && drawCommands.empty() && chunks.size() == 1)
         {
             vsg::ref_ptr<vsg::VertexIndexDraw> vid(new vsg::VertexIndexDraw());
 
@@ -456,7 +1054,7 @@ namespace osg2vsg
         {
             geometry->assignIndices(vsgindices);
 
-            drawCommands.push_back(vsg::DrawIndexed::create(vsgindices->valueCount(), instanceCount, 0, 0, 0));
+            drawCommands.insert(drawCommands.end(), indexedDraws.begin(), indexedDraws.end());
         }
 
         geometry->commands = drawCommands;
@@ -464,4 +1062,201 @@ namespace osg2vsg
         return geometry;
     }
 
+    // generate the reduced levels of the triangles and vertex arrays of a converted geometry, each level is simplified from the one before so their errors add up
+    void simplifyLevels(const std::string& name, const vsg::DataList& attributeArrays, const std::vector<uint32_t>& attributeTypes, const std::vector<uint32_t>& triangles, bool welded, GeometryTarget geometryTarget, bool splitLargeMeshes,
+                        GeometryStatistics* statistics, VkPrimitiveTopology topology, const VertexCompression& compression, const MeshSimplification& simplification, std::vector<GeometryLevel>& levels)
+    {
+        std::vector<size_t> perVertexArrays;
+        if (!attributeArrays.front()->cast<vsg::vec3Array>() || !getPerVertexArrays(attributeArrays, perVertexArrays)) return;
+
+        vsg::DataList levelArrays = attributeArrays;
+        std::vector<uint32_t> levelTriangles = triangles;
+
+        // vertices sharing a position are kept in place as seams, so the exact duplicates of geometry that hasn't been welded are merged first
+        if (!welded) weldVertices(levelArrays, nullptr, levelTriangles, VertexWelding{true});
+
+        auto vertices = levelArrays.front().cast<vsg::vec3Array>();
+        vsg::box bounds;
+        for (auto& vertex : *vertices) bounds.add(vertex);
+        float maxError = simplification.maxError * 0.5f * vsg::length(bounds.max - bounds.min);
+
+        size_t numTriangles = triangles.size() / 3;
+        size_t previousTriangles = numTriangles;
+        size_t firstLevel = levels.size();
+        float error = 0.0f;
+        uint32_t numLevels = std::min(simplification.numLevels, maxSimplifiedLevels);
+        for (uint32_t level = 0; level < numLevels; ++level)
+        {
+            size_t targetTriangles = static_cast<size_t>(static_cast<double>(previousTriangles) * simplification.levelRatio);
+            error += simplifyTriangles(levelTriangles, vertices->data(), vertices->size(), targetTriangles * 3, maxError - error);
+
+            // a level removing less than a fifth of the triangles, such as when the rest are locked by seams or the error allowed is used up, isn't worth drawing
+            size_t levelTriangleCount = levelTriangles.size() / 3;
+            if (levelTriangleCount == 0 || levelTriangleCount * 5 > previousTriangles * 4) break;
+
+            // each level keeps only the vertices it references
+            constexpr uint32_t unassigned = std::numeric_limits<uint32_t>::max();
+            std::vector<uint32_t> remap(vertices->size(), unassigned);
+            std::vector<uint32_t> sources;
+            std::vector<uint32_t> indices(levelTriangles.size());
+            for (size_t i = 0; i < levelTriangles.size(); ++i)
+            {
+                uint32_t v = levelTriangles[i];
+                if (remap[v] == unassigned)
+                {
+                    remap[v] = static_cast<uint32_t>(sources.size());
+                    sources.push_back(v);
+                }
+                indices[i] = remap[v];
+            }
+
+            vsg::DataList arrays = levelArrays;
+            gatherVertices(arrays, perVertexArrays, sources);
+
+            GeometryLevel geometryLevel;
+            geometryLevel.topology = topology;
+            geometryLevel.numTriangles = static_cast<uint32_t>(levelTriangleCount);
+            geometryLevel.error = error;
+            geometryLevel.command = createDrawCommand(name, arrays, attributeTypes, std::move(indices), 1, geometryTarget, splitLargeMeshes, statistics, &geometryLevel.topology, compression, &geometryLevel.compressionReport);
+            if (!geometryLevel.command) break;
+
+            vsg::debug("osg2vsg simplified geometry '", name, "' level ", level + 1, " from ", numTriangles, " to ", levelTriangleCount, " triangles (", 100.0 * static_cast<double>(levelTriangleCount) / static_cast<double>(numTriangles), "%), error ", error);
+
+            if (statistics) statistics->levelTriangles[level] += levelTriangleCount;
+            levels.push_back(geometryLevel);
+            previousTriangles = levelTriangleCount;
+        }
+
+        if (statistics && levels.size() > firstLevel)
+        {
+            ++statistics->numMeshesSimplified;
+            statistics->simplifiedTriangles += numTriangles;
+        }
+    }
+
+    vsg::ref_ptr<vsg::Data> generateTangents(const osg::Geometry* geometry)
+    {
+        auto vertices = dynamic_cast<const osg::Vec3Array*>(geometry->getVertexArray());
+        if (!vertices || vertices->empty()) return {};
+
+        // only per vertex normals and texcoords are used, generateTangents() falls back to triangle normals and to tangents perpendicular to the normals
+        size_t numVertices = vertices->size();
+        auto normals = dynamic_cast<const osg::Vec3Array*>(geometry->getNormalArray());
+        if (normals && normals->size() != numVertices) normals = nullptr;
+        auto texcoords = dynamic_cast<const osg::Vec2Array*>(geometry->getTexCoordArray(0));
+        if (texcoords && texcoords->size() != numVertices) texcoords = nullptr;
+
+        std::vector<uint32_t> triangles;
+        decodeTriangles(*geometry, triangles);
+
+        auto tangents = vsg::vec4Array::create(static_cast<uint32_t>(numVertices));
+        generateTangents(reinterpret_cast<const vsg::vec3*>(vertices->getDataPointer()), normals ? reinterpret_cast<const vsg::vec3*>(normals->getDataPointer()) : nullptr,
+                         texcoords ? reinterpret_cast<const vsg::vec2*>(texcoords->getDataPointer()) : nullptr, numVertices, triangles, tangents->data());
+        return tangents;
+    }
+
+    vsg::ref_ptr<vsg::Command> convertToVsg(osg::Geometry* ingeometry, uint32_t requiredAttributesMask, GeometryTarget geometryTarget, const GeometryConversionSettings& settings, GeometryConversionResult* result)
+    {
+        auto statistics = settings.statistics;
+
+        uint32_t instanceCount = 1;
+
+        // work out if we need to enable instancing by looking at BIND_OVERALL entries
+        // to see if any have more than one element which we'll interpret as requesting instancing, such as for our custom osg::Billboard handling.
+        {
+            osg::Geometry::ArrayList arrays;
+            if (ingeometry->getArrayList(arrays))
+            {
+                for (auto& array : arrays)
+                {
+                    if (array->getBinding() == osg::Array::BIND_OVERALL)
+                    {
+                        if (instanceCount < array->getNumElements()) instanceCount = array->getNumElements();
+                    }
+                }
+            }
+        }
+
+        uint32_t bindOverallPaddingCount = instanceCount;
+
+        // convert attribute arrays, create defaults for any requested attributes that don't exist for now to ensure pipeline gets required data
+        vsg::ref_ptr<vsg::Data> vertices(osg2vsg::convertToVsg(ingeometry->getVertexArray(), bindOverallPaddingCount));
+        if (!vertices.valid() || vertices->valueCount() == 0) return {};
+
+        // normals
+        vsg::ref_ptr<vsg::Data> normals(osg2vsg::convertToVsg(ingeometry->getNormalArray(), bindOverallPaddingCount));
+
+        // tangents, generated when required but missing, leaving the osg::Geometry unchanged as other threads may be converting it too
+        vsg::ref_ptr<vsg::Data> tangents(osg2vsg::convertToVsg(ingeometry->getVertexAttribArray(6), bindOverallPaddingCount));
+        if ((!tangents.valid() || tangents->valueCount() == 0) && (requiredAttributesMask & TANGENT))
+        {
+            tangents = settings.generatedTangents ? settings.generatedTangents : generateTangents(ingeometry);
+        }
+
+        // colors
+        vsg::ref_ptr<vsg::Data> colors(osg2vsg::convertToVsg(ingeometry->getColorArray(), bindOverallPaddingCount));
+
+        // tex0
+        vsg::ref_ptr<vsg::Data> texcoord0(osg2vsg::convertToVsg(ingeometry->getTexCoordArray(0), bindOverallPaddingCount));
+
+        vsg::ref_ptr<vsg::Data> translations(osg2vsg::convertToVsg(ingeometry->getVertexAttribArray(7), bindOverallPaddingCount));
+
+        // fill arrays data list THE ORDER HERE IS IMPORTANT
+        auto attributeArrays = vsg::DataList{vertices}; // always have vertices
+        std::vector<uint32_t> attributeTypes{VERTEX};
+        auto addAttributeArray = [&](const vsg::ref_ptr<vsg::Data>& array, uint32_t attributeType) {
+            if (!array.valid() || array->valueCount() == 0) return;
+
+            // arrays the pipeline doesn't read would shift the bindings of the arrays after them
+            if ((requiredAttributesMask & attributeType) == 0)
+            {
+                if (statistics)
+                {
+                    statistics->vertexBytesPruned += array->dataSize();
+                    ++statistics->numStreamsPruned;
+                }
+                return;
+            }
+
+            attributeArrays.push_back(array);
+            attributeTypes.push_back(attributeType);
+        };
+        addAttributeArray(normals, NORMAL);
+        addAttributeArray(tangents, TANGENT);
+        addAttributeArray(colors, COLOR);
+        addAttributeArray(texcoord0, TEXCOORD0);
+        addAttributeArray(translations, TRANSLATE);
+
+        // convert indices
+
+        // assume all the draw elements use the same primitive mode, copy all drawelements indices into one index array and use a single drawindexed command
+        // create a draw command per drawarrays primitive set
+
+        // TODO : need to add support for points and lines, only the triangles are decoded for now.
+        std::vector<uint32_t> triangles;
+        decodeTriangles(*ingeometry, triangles);
+
+        // nothing to draw so return a null ref_ptr<>
+        if (triangles.empty()) return {};
+
+        // instanced geometry has per instance arrays that can't be told apart from per vertex ones when the counts match, so isn't welded
+        if (settings.welding.enabled && instanceCount == 1)
+        {
+            weldVertices(attributeArrays, normals.get(), triangles, settings.welding);
+        }
+
+        // the reduced levels are simplified from the full precision vertices, before they are split, stripped or compressed. Per vertex translations offset the positions so their geometry isn't simplified
+        auto& simplification = settings.simplification;
+        if (result && simplification.enabled && instanceCount == 1 && triangles.size() / 3 >= simplification.minTriangles && std::find(attributeTypes.begin(), attributeTypes.end(), TRANSLATE) == attributeTypes.end())
+        {
+            simplifyLevels(ingeometry->getName(), attributeArrays, attributeTypes, triangles, settings.welding.enabled, geometryTarget, settings.splitLargeMeshes, statistics, settings.topology, settings.compression, simplification, result->levels);
+        }
+
+        VkPrimitiveTopology topology = settings.topology;
+        auto command = createDrawCommand(ingeometry->getName(), attributeArrays, attributeTypes, std::move(triangles), instanceCount, geometryTarget, settings.splitLargeMeshes, statistics, &topology, settings.compression,
+                                         result ? &result->compressionReport : nullptr);
+        if (result) result->topology = topology;
+        return command;
+    }
+
 } // namespace osg2vsg
@@ -6,6 +6,8 @@
 #include <osg/Geometry>
 #include <osg/Material>
 
+#include <atomic>
+
 namespace osg2vsg
 {
     enum GeometryAttributes : uint32_t
@@ -23,8 +25,18 @@ namespace osg2vsg
         TRANSLATE = 1024,
         TRANSLATE_OVERALL = 2048,
         AORM = 4096,
+        INSTANCE_TRANSFORM = 8192,       // per instance mat4, used by drawables instanced by InstanceGeometries
+        TRIANGLE_STRIP_TOPOLOGY = 16384, // not an attribute, selects the pipeline variant drawing triangle strips with primitive restart
+        NORMAL_OCT16 = 32768,            // normals octahedral encoded as R16G16_SNORM
+        TANGENT_OCT16 = 65536,           // tangents octahedral encoded as R16G16B16A16_SNORM, with the handedness in z
+        COLOR_UNORM8 = 131072,           // colours as R8G8B8A8_UNORM
+        TEXCOORD0_HALF = 262144,         // texcoords as R16G16_SFLOAT
+        TEXCOORD0_UNORM16 = 524288,      // texcoords in the 0 to 1 range as R16G16_UNORM
+        VERTEX_UNORM16 = 1048576,        // positions relative to their bounding box as R16G16B16A16_UNORM, dequantized by a parent MatrixTransform
+        VERTEX_SNORM16 = 2097152,        // positions relative to their bounding box as R16G16B16A16_SNORM, dequantized by a parent MatrixTransform
+        COMPRESSED_ATTS = NORMAL_OCT16 | TANGENT_OCT16 | COLOR_UNORM8 | TEXCOORD0_HALF | TEXCOORD0_UNORM16 | VERTEX_UNORM16 | VERTEX_SNORM16,
         STANDARD_ATTS = VERTEX | NORMAL | TANGENT | COLOR | TEXCOORD0,
-        ALL_ATTS = VERTEX | NORMAL | NORMAL_OVERALL | TANGENT | TANGENT_OVERALL | COLOR | COLOR_OVERALL | TEXCOORD0 | TEXCOORD1 | TEXCOORD2 | TRANSLATE | TRANSLATE_OVERALL | AORM
+        ALL_ATTS = VERTEX | NORMAL | NORMAL_OVERALL | TANGENT | TANGENT_OVERALL | COLOR | COLOR_OVERALL | TEXCOORD0 | TEXCOORD1 | TEXCOORD2 | TRANSLATE | TRANSLATE_OVERALL | AORM | INSTANCE_TRANSFORM | TRIANGLE_STRIP_TOPOLOGY | COMPRESSED_ATTS
     };
 
     enum AttributeChannels : uint32_t
@@ -37,7 +49,8 @@ namespace osg2vsg
         TEXCOORD1_CHANNEL = 5,
         TEXCOORD2_CHANNEL = 6,
         TRANSLATE_CHANNEL = 7,
-        AORM_CHANNEL = 8
+        AORM_CHANNEL = 8,
+        INSTANCE_TRANSFORM_CHANNEL = 9 // mat4 so occupies locations 9 to 12
     };
 
     enum GeometryTarget : uint32_t
@@ -65,6 +78,172 @@ namespace osg2vsg
 
     vsg::ref_ptr<vsg::materialValue> convertToMaterialValue(const osg::Material* material);
 
-    vsg::ref_ptr<vsg::Command> convertToVsg(osg::Geometry* geometry, uint32_t requiredAttributesMask, GeometryTarget geometryTarget);
+    /// settings for merging duplicate vertices as geometry is converted, vertices are merged when all their per vertex attributes are equal,
+    /// positions and normals are compared on grids of positionEpsilon and normalEpsilon spacing when those are non zero.
+    struct VertexWelding
+    {
+        bool enabled = false;
+        float positionEpsilon = 0.0f;
+        float normalEpsilon = 0.0f;
+    };
+
+    /// merge the duplicate vertices referenced by indices, replacing the per vertex arrays with arrays of the unique vertices in the order they are first referenced and remapping indices to match.
+    /// Arrays with a different number of values to arrays.front() are treated as per instance and left as they are. Returns false, leaving arrays and indices unchanged, if no vertices were merged.
+    bool weldVertices(vsg::DataList& arrays, const vsg::Data* normals, std::vector<uint32_t>& indices, const VertexWelding& welding);
+
+    enum TexCoordCompression : uint32_t
+    {
+        TEXCOORD_COMPRESSION_HALF,
+        TEXCOORD_COMPRESSION_UNORM16 // for texcoords in the 0 to 1 range, others fall back to half floats
+    };
+
+    enum PositionCompression : uint32_t
+    {
+        POSITION_COMPRESSION_NONE,
+        POSITION_COMPRESSION_UNORM16, // relative to the minimum corner of the bounding box
+        POSITION_COMPRESSION_SNORM16  // relative to the centre of the bounding box
+    };
+
+    /// settings for quantizing the vertex attributes of converted geometry. When enabled normals and tangents are octahedral encoded, texcoords stored as 16 bit values and colours as 8 bit unorm,
+    /// and when enforceTolerances is set an attribute stream whose largest error exceeds its tolerance is left uncompressed.
+    /// Positions are compressed separately, as 16 bit values relative to the bounding box that are only kept when within positionTolerance of the originals.
+    struct VertexCompression
+    {
+        bool enabled = false;
+        TexCoordCompression texCoordCompression = TEXCOORD_COMPRESSION_HALF;
+        float normalTolerance = 0.5f;             // degrees
+        float texCoordTolerance = 1.0f / 4096.0f; // texcoord units
+        float colorTolerance = 1.0f / 255.0f;
+        bool enforceTolerances = true;
+
+        PositionCompression positionCompression = POSITION_COMPRESSION_NONE;
+        float positionTolerance = 0.01f; // model units
+    };
+
+    /// result of compressing a geometry's vertex arrays, the largest error introduced into each stream is -1 for streams that weren't compressed.
+    struct VertexCompressionReport
+    {
+        uint32_t compressedAttributes = 0; // COMPRESSED_ATTS bits of the streams compressed
+        vsg::dmat4 positionTransform;      // maps compressed positions back to the original ones when VERTEX_UNORM16 or VERTEX_SNORM16 is set
+
+        float positionError = -1.0f;
+        float normalError = -1.0f;
+        float tangentError = -1.0f;
+        float texCoordError = -1.0f;
+        float colorError = -1.0f;
+        uint32_t numStreamsRejected = 0;
+    };
+
+    /// replace the vec3Array vertices with 16 bit values spanning their bounding box, uniformly scaled so the transform leaves normal directions unchanged.
+    /// Returns false, leaving vertices unchanged, if they aren't a vec3Array or the error exceeds compression.positionTolerance.
+    bool compressPositions(vsg::ref_ptr<vsg::Data>& vertices, const VertexCompression& compression, VertexCompressionReport& report);
+
+    /// replace the normal, tangent, colour and texcoord arrays, identified by the matching GeometryAttributes in attributeTypes, with their compressed equivalents.
+    /// Returns the COMPRESSED_ATTS bits of the streams compressed, which select the matching vertex formats and shader decoding in the pipeline.
+    uint32_t compressVertexArrays(vsg::DataList& arrays, const std::vector<uint32_t>& attributeTypes, const VertexCompression& compression, VertexCompressionReport& report);
+
+    /// maximum number of reduced levels convertToVsg() generates for a geometry
+    constexpr uint32_t maxSimplifiedLevels = 4;
+
+    /// settings for generating reduced levels of heavy geometry for a vsg::LOD. Each level targets levelRatio of the triangles of the previous one,
+    /// levels stop being generated once the error of the coarsest exceeds maxError, relative to the radius of the geometry, or a level removes too few triangles to be worth drawing.
+    struct MeshSimplification
+    {
+        bool enabled = false;
+        uint32_t minTriangles = 10000; // geometry with fewer triangles isn't simplified
+        uint32_t numLevels = 3;        // clamped to maxSimplifiedLevels
+        float levelRatio = 0.25f;
+        float maxError = 0.05f;
+        float pixelError = 1.0f; // error in pixels, on a 1080 pixel high screen, at which each reduced level is switched to
+    };
+
+    /// reduced level of a geometry generated by convertToVsg(), drawn with the pipeline variant matching its topology and compressed attributes
+    struct GeometryLevel
+    {
+        vsg::ref_ptr<vsg::Command> command;
+        VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        VertexCompressionReport compressionReport;
+        uint32_t numTriangles = 0;
+        float error = 0.0f; // largest distance of the reduced surface from the original, in model units
+    };
+
+    /// sizes of the index and vertex arrays created by convertToVsg(), accumulated across the geometries converted
+    struct GeometryStatistics
+    {
+        std::atomic<uint64_t> indexBytes = 0;
+        std::atomic<uint64_t> indexBytesSaved = 0; // saved by using 16 bit rather than 32 bit indices
+        std::atomic<uint64_t> numMeshesSplit = 0;  // meshes split into chunks of at most 65535 vertices to use 16 bit indices
+        std::atomic<uint64_t> stripBytesSaved = 0; // saved by drawing triangle strips rather than triangle lists
+        std::atomic<uint64_t> numMeshesStripped = 0;
+        std::atomic<uint64_t> vertexBytes = 0;
+        std::atomic<uint64_t> vertexBytesSaved = 0;   // saved by compressing vertex attributes
+        std::atomic<uint64_t> numStreamsRejected = 0; // attribute streams left uncompressed as their error exceeded the tolerance
+        std::atomic<uint64_t> numMeshesSimplified = 0;
+        std::atomic<uint64_t> simplifiedTriangles = 0;                  // triangles of the full resolution meshes simplified
+        std::atomic<uint64_t> levelTriangles[maxSimplifiedLevels] = {}; // triangles of each of their reduced levels
+        std::atomic<uint64_t> vertexBytesPruned = 0;                    // in attribute arrays left out as the pipeline doesn't read them
+        std::atomic<uint64_t> numStreamsPruned = 0;
+
+        /// add the statistics of other, such as those of a single conversion, to these totals
+        void add(const GeometryStatistics& other);
+    };
+
+    /// index that restarts a triangle strip, truncated to 0xffff for 16 bit indices.
+    constexpr uint32_t primitiveRestartIndex = 0xffffffff;
+
+    /// convert a triangle list into triangle strips separated by primitiveRestartIndex, with the same winding. Strips are grown greedily across shared edges starting from the triangles in list order.
+    void generateTriangleStrips(const std::vector<uint32_t>& triangles, std::vector<uint32_t>& strips);
+
+    /// topology of the graphics pipeline bound by stateGroup, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST if it doesn't bind one.
+    VkPrimitiveTopology getTopology(const vsg::StateGroup& stateGroup);
+
+    /// add the positions of a draw's vertex array to bound. Positions compressed by convertToVsg() are decoded with positionTransform, the matrix of the MatrixTransform placed above their StateGroup.
+    /// Returns false if vertices isn't a vec3Array, or the usvec4Array or svec4Array of compressed positions when positionTransform is set.
+    bool computePositionBound(const vsg::Data* vertices, const vsg::dmat4* positionTransform, vsg::dbox& bound);
+
+    /// generate per vertex tangents for geometry's triangles, a vec4Array matching its Vec3Array vertex array, from its per vertex normals and Vec2Array texcoord 0, see osg2vsg::generateTangents().
+    /// Returns null if the vertex array isn't a Vec3Array.
+    vsg::ref_ptr<vsg::Data> generateTangents(const osg::Geometry* geometry);
+
+    /// settings of the conversion of an osg::Geometry by convertToVsg()
+    struct GeometryConversionSettings
+    {
+        VertexWelding welding;
+
+        /// split meshes with more than 65536 vertices into chunks drawn with 16 bit indices by separate DrawIndexed commands, so they are converted to a vsg::Geometry or vsg::Commands
+        bool splitLargeMeshes = false;
+
+        /// VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP to draw the triangles as strips if that needs fewer index bytes than the triangle list
+        VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+        VertexCompression compression;
+
+        /// reduced levels are only generated when a GeometryConversionResult is provided to return them in
+        MeshSimplification simplification;
+
+        /// tangents used when TANGENT is required and the geometry has none, otherwise they are generated with generateTangents()
+        vsg::ref_ptr<vsg::Data> generatedTangents;
+
+        /// sizes of the arrays created are added to statistics when assigned
+        GeometryStatistics* statistics = nullptr;
+    };
+
+    /// how the geometry converted by convertToVsg() must be drawn
+    struct GeometryConversionResult
+    {
+        /// topology the indices are drawn with, which the pipeline must match, see TRIANGLE_STRIP_TOPOLOGY
+        VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+        /// the pipeline must include the report's compressedAttributes and the draw be placed under its positionTransform when positions are compressed
+        VertexCompressionReport compressionReport;
+
+        /// reduced levels generated for geometry with at least simplification.minTriangles triangles, coarsest last
+        std::vector<GeometryLevel> levels;
+    };
+
+    /// convert geometry to a VertexIndexDraw, vsg::Geometry or vsg::Commands according to geometryTarget, meshes with more than 65536 vertices are drawn with 32 bit indices unless settings.splitLargeMeshes is set.
+    /// Only the attribute arrays in requiredAttributesMask are converted, so the vertex buffers match the pipeline's vertex input state, see pruneGeometryAttributes(). The geometry isn't modified.
+    /// When the settings enable triangle strips, compression or simplification a result should be provided, as the draw's pipeline and parent transform depend on it.
+    vsg::ref_ptr<vsg::Command> convertToVsg(osg::Geometry* geometry, uint32_t requiredAttributesMask, GeometryTarget geometryTarget, const GeometryConversionSettings& settings = {}, GeometryConversionResult* result = nullptr);
 
 } // namespace osg2vsg
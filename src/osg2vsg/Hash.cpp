@@ -0,0 +1,156 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2026 the osg2vsg authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "Hash.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace osg2vsg;
+
+namespace
+{
+    constexpr uint64_t PRIME1 = 11400714785074694791ULL;
+    constexpr uint64_t PRIME2 = 14029467366897019727ULL;
+    constexpr uint64_t PRIME3 = 1609587929392839161ULL;
+    constexpr uint64_t PRIME4 = 9650029242287828579ULL;
+    constexpr uint64_t PRIME5 = 2870177450012600261ULL;
+
+    inline uint64_t rotl(uint64_t value, int bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    inline uint64_t read64(const unsigned char* ptr)
+    {
+        uint64_t value;
+        std::memcpy(&value, ptr, sizeof(value));
+        return value;
+    }
+
+    inline uint32_t read32(const unsigned char* ptr)
+    {
+        uint32_t value;
+        std::memcpy(&value, ptr, sizeof(value));
+        return value;
+    }
+
+    inline uint64_t round(uint64_t acc, uint64_t input)
+    {
+        acc += input * PRIME2;
+        acc = rotl(acc, 31);
+        return acc * PRIME1;
+    }
+
+    inline uint64_t mergeRound(uint64_t acc, uint64_t value)
+    {
+        acc ^= round(0, value);
+        return acc * PRIME1 + PRIME4;
+    }
+} // namespace
+
+Hash64::Hash64(uint64_t seed) :
+    _v1(seed + PRIME1 + PRIME2),
+    _v2(seed + PRIME2),
+    _v3(seed),
+    _v4(seed - PRIME1),
+    _seed(seed)
+{
+}
+
+void Hash64::update(const void* data, size_t size)
+{
+    auto ptr = static_cast<const unsigned char*>(data);
+    auto end = ptr + size;
+
+    _totalSize += size;
+
+    // complete a partially filled stripe first
+    if (_bufferSize > 0)
+    {
+        size_t count = std::min(size, sizeof(_buffer) - _bufferSize);
+        std::memcpy(_buffer + _bufferSize, ptr, count);
+        _bufferSize += count;
+        ptr += count;
+
+        if (_bufferSize < sizeof(_buffer)) return;
+
+        _v1 = round(_v1, read64(_buffer));
+        _v2 = round(_v2, read64(_buffer + 8));
+        _v3 = round(_v3, read64(_buffer + 16));
+        _v4 = round(_v4, read64(_buffer + 24));
+        _bufferSize = 0;
+    }
+
+    for (; ptr + 32 <= end; ptr += 32)
+    {
+        _v1 = round(_v1, read64(ptr));
+        _v2 = round(_v2, read64(ptr + 8));
+        _v3 = round(_v3, read64(ptr + 16));
+        _v4 = round(_v4, read64(ptr + 24));
+    }
+
+    if (ptr < end)
+    {
+        _bufferSize = end - ptr;
+        std::memcpy(_buffer, ptr, _bufferSize);
+    }
+}
+
+uint64_t Hash64::digest() const
+{
+    uint64_t h;
+    if (_totalSize >= 32)
+    {
+        h = rotl(_v1, 1) + rotl(_v2, 7) + rotl(_v3, 12) + rotl(_v4, 18);
+        h = mergeRound(h, _v1);
+        h = mergeRound(h, _v2);
+        h = mergeRound(h, _v3);
+        h = mergeRound(h, _v4);
+    }
+    else
+    {
+        h = _seed + PRIME5;
+    }
+
+    h += _totalSize;
+
+    const unsigned char* ptr = _buffer;
+    const unsigned char* end = _buffer + _bufferSize;
+
+    for (; ptr + 8 <= end; ptr += 8)
+    {
+        h ^= round(0, read64(ptr));
+        h = rotl(h, 27) * PRIME1 + PRIME4;
+    }
+
+    if (ptr + 4 <= end)
+    {
+        h ^= static_cast<uint64_t>(read32(ptr)) * PRIME1;
+        h = rotl(h, 23) * PRIME2 + PRIME3;
+        ptr += 4;
+    }
+
+    for (; ptr < end; ++ptr)
+    {
+        h ^= (*ptr) * PRIME5;
+        h = rotl(h, 11) * PRIME1;
+    }
+
+    h ^= h >> 33;
+    h *= PRIME2;
+    h ^= h >> 29;
+    h *= PRIME3;
+    h ^= h >> 32;
+
+    return h;
+}
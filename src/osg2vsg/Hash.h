@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace osg2vsg
+{
+    /// streaming 64 bit non-cryptographic hash, computes the same values as XXH64.
+    class Hash64
+    {
+    public:
+        explicit Hash64(uint64_t seed = 0);
+
+        void update(const void* data, size_t size);
+
+        template<typename T>
+        void update(const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Hash64::update(value) requires a trivially copyable type.");
+            update(&value, sizeof(T));
+        }
+
+        void update(const std::string& str) { update(str.data(), str.size()); }
+
+        uint64_t digest() const;
+
+    protected:
+        uint64_t _v1, _v2, _v3, _v4;
+        uint64_t _seed;
+        uint64_t _totalSize = 0;
+        unsigned char _buffer[32];
+        size_t _bufferSize = 0;
+    };
+
+    /// hash a block of memory in one call
+    inline uint64_t hash64(const void* data, size_t size, uint64_t seed = 0)
+    {
+        Hash64 hash(seed);
+        hash.update(data, size);
+        return hash.digest();
+    }
+
+} // namespace osg2vsg
@@ -0,0 +1,192 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2026 the osg2vsg authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "ImageKernels.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#    define OSG2VSG_X86 1
+#    include <tmmintrin.h>
+#    if defined(_MSC_VER)
+#        include <intrin.h>
+#        define OSG2VSG_TARGET_SSSE3
+#    else
+#        define OSG2VSG_TARGET_SSSE3 __attribute__((target("ssse3")))
+#    endif
+#endif
+
+using namespace osg2vsg;
+
+namespace
+{
+    // component order of each conversion, -1 fills the alpha channel with the maximum component value
+    struct SwizzleLayout
+    {
+        int numSrcComponents;
+        int numDstComponents;
+        int components[4];
+    };
+
+    constexpr SwizzleLayout swizzleLayout(PixelSwizzle swizzle)
+    {
+        switch (swizzle)
+        {
+        case (PixelSwizzle::RGB_TO_RGBA): return {3, 4, {0, 1, 2, -1}};
+        case (PixelSwizzle::BGR_TO_RGBA): return {3, 4, {2, 1, 0, -1}};
+        case (PixelSwizzle::BGRA_TO_RGBA): return {4, 4, {2, 1, 0, 3}};
+        case (PixelSwizzle::BGR_TO_RGB): return {3, 3, {2, 1, 0, -1}};
+        }
+        return {0, 0, {}};
+    }
+
+    template<typename T, PixelSwizzle swizzle>
+    void scalarRow(const uint8_t* src, uint8_t* dst, size_t numPixels)
+    {
+        constexpr SwizzleLayout layout = swizzleLayout(swizzle);
+        constexpr T fill = std::numeric_limits<T>::max();
+
+        auto in = reinterpret_cast<const T*>(src);
+        auto out = reinterpret_cast<T*>(dst);
+        for (size_t i = 0; i < numPixels; ++i)
+        {
+            out[0] = in[layout.components[0]];
+            out[1] = in[layout.components[1]];
+            out[2] = in[layout.components[2]];
+            if constexpr (layout.numDstComponents == 4) out[3] = (layout.components[3] >= 0) ? in[layout.components[3]] : fill;
+
+            in += layout.numSrcComponents;
+            out += layout.numDstComponents;
+        }
+    }
+
+    template<typename T>
+    RowKernel selectScalarKernel(PixelSwizzle swizzle)
+    {
+        switch (swizzle)
+        {
+        case (PixelSwizzle::RGB_TO_RGBA): return scalarRow<T, PixelSwizzle::RGB_TO_RGBA>;
+        case (PixelSwizzle::BGR_TO_RGBA): return scalarRow<T, PixelSwizzle::BGR_TO_RGBA>;
+        case (PixelSwizzle::BGRA_TO_RGBA): return scalarRow<T, PixelSwizzle::BGRA_TO_RGBA>;
+        case (PixelSwizzle::BGR_TO_RGB): return scalarRow<T, PixelSwizzle::BGR_TO_RGB>;
+        }
+        return {};
+    }
+
+#if defined(OSG2VSG_X86)
+    // pshufb control and alpha fill for converting as many whole pixels as fit in a 16 byte register
+    struct ShuffleMasks
+    {
+        uint8_t shuffle[16];
+        uint8_t alpha[16];
+        size_t pixelsPerStep;
+    };
+
+    ShuffleMasks computeShuffleMasks(PixelSwizzle swizzle, uint32_t componentSize)
+    {
+        SwizzleLayout layout = swizzleLayout(swizzle);
+        size_t srcPixelSize = layout.numSrcComponents * componentSize;
+        size_t dstPixelSize = layout.numDstComponents * componentSize;
+
+        ShuffleMasks masks = {};
+        masks.pixelsPerStep = std::min(size_t(16) / srcPixelSize, size_t(16) / dstPixelSize);
+
+        std::memset(masks.shuffle, 0x80, sizeof(masks.shuffle)); // high bit set writes zero
+        for (size_t p = 0; p < masks.pixelsPerStep; ++p)
+        {
+            for (int c = 0; c < layout.numDstComponents; ++c)
+            {
+                for (uint32_t b = 0; b < componentSize; ++b)
+                {
+                    size_t dstByte = p * dstPixelSize + c * componentSize + b;
+                    if (layout.components[c] >= 0)
+                    {
+                        masks.shuffle[dstByte] = static_cast<uint8_t>(p * srcPixelSize + layout.components[c] * componentSize + b);
+                    }
+                    else
+                    {
+                        masks.alpha[dstByte] = 0xff;
+                    }
+                }
+            }
+        }
+        return masks;
+    }
+
+    OSG2VSG_TARGET_SSSE3 void shuffleRow(const ShuffleMasks& masks, size_t srcPixelSize, size_t dstPixelSize, const uint8_t* src, uint8_t* dst, size_t numPixels, size_t& numProcessed)
+    {
+        const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(masks.shuffle));
+        const __m128i alpha = _mm_loadu_si128(reinterpret_cast<const __m128i*>(masks.alpha));
+
+        // each step loads and stores a full 16 bytes but only consumes and produces pixelsPerStep pixels,
+        // so stop while there is still 16 bytes left on both sides and leave the rest to the scalar kernel.
+        size_t i = 0;
+        while ((numPixels - i) * srcPixelSize >= 16 && (numPixels - i) * dstPixelSize >= 16)
+        {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * srcPixelSize));
+            pixels = _mm_or_si128(_mm_shuffle_epi8(pixels, shuffle), alpha);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * dstPixelSize), pixels);
+            i += masks.pixelsPerStep;
+        }
+        numProcessed = i;
+    }
+#endif
+} // namespace
+
+bool osg2vsg::supportsSSSE3()
+{
+#if defined(OSG2VSG_X86)
+#    if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    static const bool s_supported = (info[2] & (1 << 9)) != 0;
+#    else
+    static const bool s_supported = __builtin_cpu_supports("ssse3");
+#    endif
+    return s_supported;
+#else
+    return false;
+#endif
+}
+
+RowKernel osg2vsg::selectRowKernel(PixelSwizzle swizzle, uint32_t componentSize, bool allowSIMD)
+{
+    RowKernel scalar;
+    if (componentSize == 1)
+        scalar = selectScalarKernel<uint8_t>(swizzle);
+    else if (componentSize == 2)
+        scalar = selectScalarKernel<uint16_t>(swizzle);
+    else
+        return {};
+
+#if defined(OSG2VSG_X86)
+    if (allowSIMD && supportsSSSE3())
+    {
+        SwizzleLayout layout = swizzleLayout(swizzle);
+        size_t srcPixelSize = layout.numSrcComponents * componentSize;
+        size_t dstPixelSize = layout.numDstComponents * componentSize;
+        auto masks = computeShuffleMasks(swizzle, componentSize);
+
+        return [masks, srcPixelSize, dstPixelSize, scalar](const uint8_t* src, uint8_t* dst, size_t numPixels) {
+            size_t numProcessed = 0;
+            shuffleRow(masks, srcPixelSize, dstPixelSize, src, dst, numPixels, numProcessed);
+            if (numProcessed < numPixels) scalar(src + numProcessed * srcPixelSize, dst + numProcessed * dstPixelSize, numPixels - numProcessed);
+        };
+    }
+#else
+    (void)allowSIMD;
+#endif
+
+    return scalar;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace osg2vsg
+{
+    /// pixel format conversions that have dedicated row kernels, other conversions use the generic per component path in formatImage().
+    enum class PixelSwizzle
+    {
+        RGB_TO_RGBA,
+        BGR_TO_RGBA,
+        BGRA_TO_RGBA,
+        BGR_TO_RGB
+    };
+
+    /// convert numPixels contiguous pixels from src to dst
+    using RowKernel = std::function<void(const uint8_t* src, uint8_t* dst, size_t numPixels)>;
+
+    /// return true if the CPU supports the SSSE3 byte shuffle used by the SIMD kernels
+    bool supportsSSSE3();
+
+    /// return the kernel for converting pixels with 1 or 2 byte components, using SSSE3 when allowSIMD is true and the CPU supports it.
+    /// Returns an empty kernel for unsupported component sizes. Alpha channels added by the conversion are set to the maximum component value.
+    RowKernel selectRowKernel(PixelSwizzle swizzle, uint32_t componentSize, bool allowSIMD = true);
+
+} // namespace osg2vsg
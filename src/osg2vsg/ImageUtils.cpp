@@ -11,6 +11,9 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 </editor-fold> */
 
 #include "ImageUtils.h"
+#include "ImageKernels.h"
+
+#include <osgDB/FileNameUtils>
 
 #include <vsg/vk/CommandBuffer.h>
 
@@ -43,7 +46,7 @@ namespace osg2vsg
         }
     }
 
-    osg::ref_ptr<osg::Image> formatImage(const osg::Image* image, GLenum targetPixelFormat = GL_RGBA)
+    osg::ref_ptr<osg::Image> formatImage(const osg::Image* image, GLenum targetPixelFormat = GL_RGBA, TaskScheduler* scheduler = nullptr)
     {
         if (targetPixelFormat == image->getPixelFormat())
         {
@@ -52,7 +55,17 @@ namespace osg2vsg
 
         osg::ref_ptr<osg::Image> new_image(new osg::Image);
 
-        new_image->allocateImage(image->s(), image->t(), image->r(), targetPixelFormat, image->getDataType());
+        // allocate room for any mipmap levels so they are reformatted along with the base image
+        osg::Image::MipmapDataType mipmapOffsets;
+        unsigned int totalSize = 0;
+        for (unsigned int level = 0; level < image->getNumMipmapLevels(); ++level)
+        {
+            if (level > 0) mipmapOffsets.push_back(totalSize);
+            totalSize += osg::Image::computeImageSizeInBytes(std::max(image->s() >> level, 1), std::max(image->t() >> level, 1), std::max(image->r() >> level, 1), targetPixelFormat, image->getDataType(), 1);
+        }
+
+        new_image->setImage(image->s(), image->t(), image->r(), targetPixelFormat, targetPixelFormat, image->getDataType(), new unsigned char[totalSize], osg::Image::USE_NEW_DELETE, 1);
+        new_image->setMipmapLevels(mipmapOffsets);
 
         int numBytesPerComponent = 1;
         unsigned char component_default[8] = {255, 0, 0, 0, 0, 0, 0, 0};
@@ -87,8 +100,6 @@ namespace osg2vsg
             *reinterpret_cast<float*>(component_default) = 1.0f;
             break;
         case (GL_DOUBLE):
-            numBytesPerComponent = 8;
-            break;
             numBytesPerComponent = 8;
             *reinterpret_cast<double*>(component_default) = 1.0;
             break;
@@ -148,15 +159,28 @@ namespace osg2vsg
         }
         }
 
-        for (int r = 0; r < image->r(); ++r)
+        // use the dedicated, SIMD where available, kernels for the common swizzles of unsigned components, as they fill alpha with the maximum component value
+        RowKernel kernel;
+        if (image->getDataType() == GL_UNSIGNED_BYTE || image->getDataType() == GL_UNSIGNED_SHORT)
         {
-            for (int t = 0; t < image->t(); ++t)
-            {
-                for (int s = 0; s < image->s(); ++s)
-                {
-                    const unsigned char* src = image->data(s, t, r);
-                    unsigned char* dst = new_image->data(s, t, r);
+            GLenum sourcePixelFormat = image->getPixelFormat();
+            if (sourcePixelFormat == GL_RGB && targetPixelFormat == GL_RGBA)
+                kernel = selectRowKernel(PixelSwizzle::RGB_TO_RGBA, numBytesPerComponent);
+            else if (sourcePixelFormat == GL_BGR && targetPixelFormat == GL_RGBA)
+                kernel = selectRowKernel(PixelSwizzle::BGR_TO_RGBA, numBytesPerComponent);
+            else if (sourcePixelFormat == GL_BGRA && targetPixelFormat == GL_RGBA)
+                kernel = selectRowKernel(PixelSwizzle::BGRA_TO_RGBA, numBytesPerComponent);
+            else if (sourcePixelFormat == GL_BGR && targetPixelFormat == GL_RGB)
+                kernel = selectRowKernel(PixelSwizzle::BGR_TO_RGB, numBytesPerComponent);
+        }
 
+        if (!kernel)
+        {
+            // the kernel is called after this block closes, so the pixel size is captured by value
+            size_t srcPixelSize = image->getPixelSizeInBits() / 8;
+            kernel = [srcPixelSize, numComponents, numBytesPerComponent, &componentOffset, &component_default](const uint8_t* src, uint8_t* dst, size_t numPixels) {
+                for (size_t s = 0; s < numPixels; ++s, src += srcPixelSize)
+                {
                     for (int c = 0; c < numComponents; ++c)
                     {
                         int offset = componentOffset[c];
@@ -167,7 +191,29 @@ namespace osg2vsg
                         }
                     }
                 }
-            }
+            };
+        }
+
+        // convert row by row as source rows may be padded, large images are split into chunks of rows that are converted in parallel
+        constexpr size_t bytesPerTask = 256 * 1024;
+        for (unsigned int level = 0; level < image->getNumMipmapLevels(); ++level)
+        {
+            int width = std::max(image->s() >> level, 1);
+            size_t numRowsPerImage = std::max(image->t() >> level, 1);
+            size_t numRows = numRowsPerImage * std::max(image->r() >> level, 1);
+
+            const unsigned char* src = image->getMipmapData(level);
+            unsigned char* dst = new_image->getMipmapData(level);
+            size_t srcRowStep = (level == 0) ? image->getRowStepInBytes() : osg::Image::computeRowWidthInBytes(width, image->getPixelFormat(), image->getDataType(), image->getPacking());
+            size_t srcImageStep = (level == 0) ? image->getImageStepInBytes() : srcRowStep * numRowsPerImage;
+            size_t dstRowStep = osg::Image::computeRowWidthInBytes(width, targetPixelFormat, image->getDataType(), 1);
+            size_t dstImageStep = dstRowStep * numRowsPerImage;
+
+            parallel_for(scheduler, numRows, std::max(bytesPerTask / std::max(dstRowStep, size_t(1)), size_t(1)), [&](size_t row) {
+                size_t t = row % numRowsPerImage;
+                size_t r = row / numRowsPerImage;
+                kernel(src + r * srcImageStep + t * srcRowStep, dst + r * dstImageStep + t * dstRowStep, width);
+            });
         }
 
         return new_image;
@@ -342,7 +388,7 @@ namespace osg2vsg
         return vsg_data;
     }
 
-    vsg::ref_ptr<vsg::Data> convertToVsg(const osg::Image* image, bool mapRGBtoRGBAHint)
+    vsg::ref_ptr<vsg::Data> convertToVsg(const osg::Image* image, bool mapRGBtoRGBAHint, TaskScheduler* scheduler)
     {
         if (!image)
         {
@@ -375,7 +421,7 @@ namespace osg2vsg
             if (mapRGBtoRGBAHint)
             {
                 numComponents = 4;
-                new_image = formatImage(image, GL_RGBA);
+                new_image = formatImage(image, GL_RGBA, scheduler);
             }
             else
             {
@@ -388,12 +434,12 @@ namespace osg2vsg
             if (mapRGBtoRGBAHint)
             {
                 numComponents = 4;
-                new_image = formatImage(image, GL_RGBA);
+                new_image = formatImage(image, GL_RGBA, scheduler);
             }
             else
             {
                 numComponents = 3;
-                new_image = formatImage(image, GL_RGB);
+                new_image = formatImage(image, GL_RGB, scheduler);
             }
             break;
 
@@ -404,7 +450,7 @@ namespace osg2vsg
 
         case (GL_BGRA):
             numComponents = 4;
-            new_image = formatImage(image, GL_RGBA);
+            new_image = formatImage(image, GL_RGBA, scheduler);
             break;
 
         default:
@@ -482,4 +528,21 @@ namespace osg2vsg
         return vsg_data;
     }
 
+    std::string siblingImageFileName(const std::string& filePath, const std::string& diffuseImageFileName, const std::string& suffix)
+    {
+        std::string directory = filePath.substr(0, filePath.find_last_of('\\'));
+
+        std::string base = osgDB::getNameLessExtension(diffuseImageFileName);
+        for (auto diffuse : {"_diffuse", "_Diffuse", "_DIFFUSE"})
+        {
+            if (auto pos = base.rfind(diffuse); pos != std::string::npos)
+            {
+                base.erase(pos);
+                break;
+            }
+        }
+
+        return directory + "\\" + base + suffix + osgDB::getFileExtension(diffuseImageFileName);
+    }
+
 } // namespace osg2vsg
@@ -20,11 +20,18 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/vk/Device.h>
 #include <vsg/vk/PhysicalDevice.h>
 
+#include "TaskScheduler.h"
+
 namespace osg2vsg
 {
     VkFormat convertGLImageFormatToVulkan(GLenum dataType, GLenum pixelFormat);
 
     osg::ref_ptr<osg::Image> formatImageToRGBA(const osg::Image* image);
 
-    vsg::ref_ptr<vsg::Data> convertToVsg(const osg::Image* image, bool mapRGBtoRGBAHint);
+    /// convert osg::Image to vsg::Data, when a scheduler is provided large images that require reformatting are converted in parallel.
+    vsg::ref_ptr<vsg::Data> convertToVsg(const osg::Image* image, bool mapRGBtoRGBAHint, TaskScheduler* scheduler = nullptr);
+
+    /// file name of the map with suffix, such as "_NML." or "_AORM.", that osg2vsg::convert() loads alongside the diffuse image of the model at filePath,
+    /// found in the model's directory with the diffuse image's name less any _diffuse suffix.
+    std::string siblingImageFileName(const std::string& filePath, const std::string& diffuseImageFileName, const std::string& suffix);
 } // namespace osg2vsg
@@ -0,0 +1,338 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2026 the osg2vsg authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "InstanceGeometries.h"
+#include "GeometryUtils.h"
+
+#include <algorithm>
+#include <typeinfo>
+
+using namespace osg2vsg;
+
+namespace
+{
+    struct Draw
+    {
+        bool culled = false;
+        vsg::StateGroup* stateGroup = nullptr;
+        vsg::VertexIndexDraw* vertexIndexDraw = nullptr;
+        vsg::BindGraphicsPipeline* bindGraphicsPipeline = nullptr;
+        vsg::dsphere bound;
+        const vsg::MatrixTransform* positionTransform = nullptr;
+    };
+
+    struct Instance
+    {
+        vsg::ref_ptr<vsg::Node> node;
+        vsg::dmat4 matrix;
+        size_t index = 0; // position in the group's children
+        uint64_t mortonCode = 0;
+    };
+
+    struct Instances
+    {
+        std::vector<Draw> draws;
+        std::vector<Instance> instances;
+    };
+
+    // match the CullNode/StateGroup/VertexIndexDraw or StateGroup/VertexIndexDraw subgraphs ConvertToVsg::apply(osg::Geometry&) creates, when all their arrays are per vertex,
+    // with the MatrixTransform decoding compressed positions above the StateGroup when there is one
+    bool getDraw(vsg::Node* node, Draw& draw)
+    {
+        vsg::Node* child = node;
+        if (auto cullNode = node->cast<vsg::CullNode>())
+        {
+            child = cullNode->child.get();
+            draw.culled = true;
+            draw.bound = cullNode->bound;
+        }
+
+        if (auto transform = child ? child->cast<vsg::MatrixTransform>() : nullptr)
+        {
+            if (transform->children.size() != 1) return false;
+            draw.positionTransform = transform;
+            child = transform->children.front().get();
+        }
+
+        auto stateGroup = child ? child->cast<vsg::StateGroup>() : nullptr;
+        if (!stateGroup || stateGroup->children.size() != 1) return false;
+
+        auto vertexIndexDraw = stateGroup->children.front()->cast<vsg::VertexIndexDraw>();
+        if (!vertexIndexDraw || vertexIndexDraw->arrays.empty() || !vertexIndexDraw->indices || vertexIndexDraw->instanceCount != 1) return false;
+
+        // positions under a transform are only accepted if they are compressed, so transforms other than the one decoding them are left in place
+        auto& vertices = vertexIndexDraw->arrays.front()->data;
+        vsg::dbox bound;
+        if (!computePositionBound(vertices.get(), draw.positionTransform ? &draw.positionTransform->matrix : nullptr, bound)) return false;
+
+        // instance rate arrays, such as BIND_OVERALL colours, only have a value for the first instance
+        for (auto& array : vertexIndexDraw->arrays)
+        {
+            if (!array->data || array->data->valueCount() != vertices->valueCount()) return false;
+        }
+
+        for (auto& stateCommand : stateGroup->stateCommands)
+        {
+            if (auto bindGraphicsPipeline = stateCommand->cast<vsg::BindGraphicsPipeline>()) draw.bindGraphicsPipeline = bindGraphicsPipeline;
+        }
+        if (!draw.bindGraphicsPipeline) return false;
+
+        if (!draw.culled)
+        {
+            auto center = (bound.min + bound.max) * 0.5;
+            draw.bound.set(center.x, center.y, center.z, vsg::length(bound.max - bound.min) * 0.5);
+        }
+
+        draw.stateGroup = stateGroup;
+        draw.vertexIndexDraw = vertexIndexDraw;
+        return true;
+    }
+
+    // a single draw, or a plain Group of draws as created for an osg::Geode
+    bool getDraws(vsg::Node* node, std::vector<Draw>& draws)
+    {
+        Draw draw;
+        if (getDraw(node, draw))
+        {
+            draws.push_back(draw);
+            return true;
+        }
+
+        if (typeid(*node) != typeid(vsg::Group)) return false;
+
+        auto group = static_cast<vsg::Group*>(node);
+        if (group->children.empty()) return false;
+
+        for (auto& child : group->children)
+        {
+            Draw childDraw;
+            if (!getDraw(child.get(), childDraw)) return false;
+            draws.push_back(childDraw);
+        }
+        return true;
+    }
+
+    // bound of the instances of a draw's bound
+    vsg::dsphere computeInstancedBound(const vsg::dsphere& bound, const std::vector<Instance>& instances)
+    {
+        vsg::dbox box;
+        for (auto& instance : instances)
+        {
+            auto& m = instance.matrix;
+            double scale = std::max({vsg::length(vsg::dvec3(m[0][0], m[0][1], m[0][2])), vsg::length(vsg::dvec3(m[1][0], m[1][1], m[1][2])), vsg::length(vsg::dvec3(m[2][0], m[2][1], m[2][2]))});
+            double radius = bound.radius * scale;
+            auto center = m * bound.center;
+            box.add(center - vsg::dvec3(radius, radius, radius));
+            box.add(center + vsg::dvec3(radius, radius, radius));
+        }
+        auto center = (box.min + box.max) * 0.5;
+        return vsg::dsphere(center.x, center.y, center.z, vsg::length(box.max - box.min) * 0.5);
+    }
+
+    // spread the bits of a 21 bit value so three can be interleaved into a 63 bit Morton code
+    uint64_t expandBits(uint64_t value)
+    {
+        value &= 0x1fffff;
+        value = (value | (value << 32)) & 0x1f00000000ffffULL;
+        value = (value | (value << 16)) & 0x1f0000ff0000ffULL;
+        value = (value | (value << 8)) & 0x100f00f00f00f00fULL;
+        value = (value | (value << 4)) & 0x10c30c30c30c30c3ULL;
+        value = (value | (value << 2)) & 0x1249249249249249ULL;
+        return value;
+    }
+
+    // split the instances into spatially close clusters of at most maxInstances, ordering them along a Morton curve of their origins and dividing them evenly
+    std::vector<std::vector<Instance>> clusterInstances(std::vector<Instance> instances, uint32_t maxInstances)
+    {
+        vsg::dbox extents;
+        for (auto& instance : instances) extents.add(vsg::dvec3(instance.matrix[3][0], instance.matrix[3][1], instance.matrix[3][2]));
+
+        auto size = extents.max - extents.min;
+        auto scale = vsg::dvec3(size.x > 0.0 ? 2097151.0 / size.x : 0.0, size.y > 0.0 ? 2097151.0 / size.y : 0.0, size.z > 0.0 ? 2097151.0 / size.z : 0.0);
+        for (auto& instance : instances)
+        {
+            auto position = (vsg::dvec3(instance.matrix[3][0], instance.matrix[3][1], instance.matrix[3][2]) - extents.min) * scale;
+            instance.mortonCode = expandBits(static_cast<uint64_t>(position.x)) | (expandBits(static_cast<uint64_t>(position.y)) << 1) | (expandBits(static_cast<uint64_t>(position.z)) << 2);
+        }
+        std::stable_sort(instances.begin(), instances.end(), [](const Instance& lhs, const Instance& rhs) { return lhs.mortonCode < rhs.mortonCode; });
+
+        size_t numClusters = (maxInstances > 0) ? (instances.size() + maxInstances - 1) / maxInstances : 1;
+        std::vector<std::vector<Instance>> clusters;
+        for (size_t i = 0; i < numClusters; ++i)
+        {
+            auto begin = instances.begin() + (i * instances.size()) / numClusters;
+            auto end = instances.begin() + ((i + 1) * instances.size()) / numClusters;
+            clusters.emplace_back(begin, end);
+        }
+        return clusters;
+    }
+
+    // a single instanced draw for each of the draws, drawing them at each of the instances' matrices
+    vsg::ref_ptr<vsg::Node> createInstancedDraws(const std::vector<Draw>& draws, const std::vector<vsg::ref_ptr<vsg::BindGraphicsPipeline>>& instancedPipelines, const std::vector<Instance>& instances)
+    {
+        auto matrices = vsg::mat4Array::create(static_cast<uint32_t>(instances.size()));
+        for (size_t i = 0; i < instances.size(); ++i) matrices->set(i, vsg::mat4(instances[i].matrix));
+
+        vsg::Group::Children instancedDraws;
+        for (size_t d = 0; d < draws.size(); ++d)
+        {
+            auto& draw = draws[d];
+
+            // the transform decoding compressed positions is folded into each instance's matrix
+            auto drawMatrices = matrices;
+            if (draw.positionTransform)
+            {
+                drawMatrices = vsg::mat4Array::create(static_cast<uint32_t>(instances.size()));
+                for (size_t i = 0; i < instances.size(); ++i) drawMatrices->set(i, vsg::mat4(instances[i].matrix * draw.positionTransform->matrix));
+            }
+
+            vsg::DataList arrays;
+            for (auto& array : draw.vertexIndexDraw->arrays) arrays.push_back(array->data);
+            arrays.push_back(drawMatrices);
+
+            auto vertexIndexDraw = vsg::VertexIndexDraw::create();
+            vertexIndexDraw->assignArrays(arrays);
+            vertexIndexDraw->assignIndices(draw.vertexIndexDraw->indices->data);
+            vertexIndexDraw->indexCount = draw.vertexIndexDraw->indexCount;
+            vertexIndexDraw->instanceCount = static_cast<uint32_t>(instances.size());
+            vertexIndexDraw->firstIndex = draw.vertexIndexDraw->firstIndex;
+            vertexIndexDraw->vertexOffset = draw.vertexIndexDraw->vertexOffset;
+            vertexIndexDraw->firstInstance = 0;
+
+            auto stateGroup = vsg::StateGroup::create();
+            stateGroup->stateCommands = draw.stateGroup->stateCommands;
+            std::replace(stateGroup->stateCommands.begin(), stateGroup->stateCommands.end(), vsg::ref_ptr<vsg::StateCommand>(draw.bindGraphicsPipeline), vsg::ref_ptr<vsg::StateCommand>(instancedPipelines[d]));
+            stateGroup->addChild(vertexIndexDraw);
+
+            if (draw.culled) instancedDraws.push_back(vsg::CullNode::create(computeInstancedBound(draw.bound, instances), stateGroup));
+            else instancedDraws.push_back(stateGroup);
+        }
+
+        if (instancedDraws.size() == 1) return instancedDraws.front();
+
+        auto instancedGroup = vsg::Group::create();
+        instancedGroup->children = instancedDraws;
+        return instancedGroup;
+    }
+} // namespace
+
+InstanceGeometries::InstanceGeometries(vsg::ref_ptr<const BuildOptions> in_buildOptions, uint32_t in_minInstances, uint32_t in_maxInstances) :
+    buildOptions(in_buildOptions),
+    minInstances(in_minInstances),
+    maxInstances(in_maxInstances)
+{
+}
+
+void InstanceGeometries::apply(vsg::Node& node)
+{
+    node.traverse(*this);
+}
+
+void InstanceGeometries::apply(vsg::Group& group)
+{
+    // subgraphs shared between parents are only instanced once
+    if (!_instanced.insert(&group).second) return;
+
+    group.traverse(*this);
+
+    instance(group);
+}
+
+vsg::ref_ptr<vsg::BindGraphicsPipeline> InstanceGeometries::getOrCreateInstancedPipeline(const vsg::BindGraphicsPipeline* bindGraphicsPipeline)
+{
+    if (auto itr = _instancedPipelines.find(bindGraphicsPipeline); itr != _instancedPipelines.end()) return itr->second;
+
+    auto instancedPipeline = buildOptions->pipelineCache->getOrCreateBindGraphicsPipelineVariant(bindGraphicsPipeline, INSTANCE_TRANSFORM, buildOptions->options);
+    _instancedPipelines[bindGraphicsPipeline] = instancedPipeline;
+    return instancedPipeline;
+}
+
+void InstanceGeometries::instance(vsg::Group& group)
+{
+    if (group.children.size() < minInstances) return;
+
+    // collect the children that are chains of single child MatrixTransforms leading to drawables that can be instanced, keyed by the shared drawable subgraph
+    std::map<const vsg::Node*, size_t> leafIndices;
+    std::vector<Instances> leaves;
+
+    for (size_t index = 0; index < group.children.size(); ++index)
+    {
+        auto& child = group.children[index];
+        vsg::dmat4 matrix;
+        vsg::Node* leaf = child.get();
+        bool transformed = false;
+        for (auto transform = leaf ? leaf->cast<vsg::MatrixTransform>() : nullptr; transform && transform->children.size() == 1; transform = leaf ? leaf->cast<vsg::MatrixTransform>() : nullptr)
+        {
+            matrix = matrix * transform->matrix;
+            leaf = transform->children.front().get();
+            transformed = true;
+        }
+
+        if (!transformed || !leaf) continue;
+
+        auto [itr, inserted] = leafIndices.emplace(leaf, leaves.size());
+        if (inserted)
+        {
+            leaves.emplace_back();
+            if (!getDraws(leaf, leaves.back().draws)) leaves.back().draws.clear();
+        }
+
+        auto& leafInstances = leaves[itr->second];
+        if (!leafInstances.draws.empty()) leafInstances.instances.push_back(Instance{child, matrix, index});
+    }
+
+    // each instanced draw takes the place of the first of its instances in the children, the slots of the other instances are removed, so the order of the remaining children is kept
+    std::vector<vsg::ref_ptr<vsg::Node>> slots(group.children.begin(), group.children.end());
+    std::vector<bool> removed(slots.size(), false);
+
+    bool instanced = false;
+    for (auto& [draws, instances] : leaves)
+    {
+        if (instances.size() < minInstances) continue;
+
+        std::vector<vsg::ref_ptr<vsg::BindGraphicsPipeline>> instancedPipelines;
+        for (auto& draw : draws)
+        {
+            auto instancedPipeline = getOrCreateInstancedPipeline(draw.bindGraphicsPipeline);
+            if (!instancedPipeline) break;
+            instancedPipelines.push_back(instancedPipeline);
+        }
+        if (instancedPipelines.size() != draws.size()) continue;
+
+        for (auto& cluster : clusterInstances(instances, std::max(maxInstances, minInstances)))
+        {
+            if (cluster.size() < minInstances) continue;
+
+            size_t first = cluster.front().index;
+            for (auto& instance : cluster)
+            {
+                first = std::min(first, instance.index);
+                removed[instance.index] = true;
+            }
+            slots[first] = createInstancedDraws(draws, instancedPipelines, cluster);
+            removed[first] = false;
+
+            numInstancedDraws += static_cast<uint32_t>(draws.size());
+            numDrawsEliminated += static_cast<uint32_t>((cluster.size() - 1) * draws.size());
+            instanced = true;
+        }
+    }
+
+    if (!instanced) return;
+
+    vsg::Group::Children children;
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+        if (!removed[i]) children.push_back(slots[i]);
+    }
+    group.children = children;
+}
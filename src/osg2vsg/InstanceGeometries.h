@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <map>
+#include <set>
+
+#include "BuildOptions.h"
+
+namespace osg2vsg
+{
+    /// replace drawables that are repeated under sibling MatrixTransforms with a single instanced draw, passing the per instance matrices in an instance rate vertex array.
+    /// Subgraphs shared by ConvertToVsg for osg::Geometry and osg::Geode referenced from many transforms are instanced when they are referenced at least minInstances times,
+    /// the instanced pipeline variant enables the INSTANCE_TRANSFORM geometry attribute of the original pipeline, so only pipelines created by buildOptions->pipelineCache can be instanced.
+    /// The MatrixTransform decoding compressed positions is folded into each instance's matrix. Each instanced draw takes the place of the first of its instances, the other children keep their order.
+    /// Instances are split into spatially close clusters of at most maxInstances, each with its own instanced draw and CullNode bound, so scattered instances can still be culled,
+    /// smaller values of maxInstances cull more tightly at the cost of recording more draws.
+    class InstanceGeometries : public vsg::Visitor
+    {
+    public:
+        explicit InstanceGeometries(vsg::ref_ptr<const BuildOptions> in_buildOptions, uint32_t in_minInstances = 4, uint32_t in_maxInstances = 64);
+
+        vsg::ref_ptr<const BuildOptions> buildOptions;
+        uint32_t minInstances;
+        uint32_t maxInstances;
+
+        uint32_t numInstancedDraws = 0;
+        uint32_t numDrawsEliminated = 0;
+
+        void apply(vsg::Node& node) override;
+        void apply(vsg::Group& group) override;
+
+    protected:
+        void instance(vsg::Group& group);
+        vsg::ref_ptr<vsg::BindGraphicsPipeline> getOrCreateInstancedPipeline(const vsg::BindGraphicsPipeline* bindGraphicsPipeline);
+
+        std::set<const vsg::Group*> _instanced;
+        std::map<const vsg::BindGraphicsPipeline*, vsg::ref_ptr<vsg::BindGraphicsPipeline>> _instancedPipelines;
+    };
+
+} // namespace osg2vsg
@@ -0,0 +1,352 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2026 the osg2vsg authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "MergeGeometries.h"
+#include "GeometryUtils.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <map>
+
+using namespace osg2vsg;
+
+namespace
+{
+    struct Candidate
+    {
+        vsg::ref_ptr<vsg::Node> node;
+        vsg::StateGroup* stateGroup = nullptr;
+        vsg::VertexIndexDraw* draw = nullptr;
+        const vsg::MatrixTransform* positionTransform = nullptr;
+        bool culled = false;
+        bool triangleStrips = false;
+        uint32_t numVertices = 0;
+        vsg::dbox bound;
+        uint64_t mortonCode = 0;
+        size_t index = 0; // position in the group's children
+    };
+
+    // state commands bound, whether culled, the transform of compressed positions and the value size of each array, siblings with the same signature can share a draw
+    using Signature = std::vector<uint64_t>;
+
+    bool isMergeableArray(const vsg::BufferInfo* bufferInfo, uint32_t numVertices)
+    {
+        const vsg::Data* data = bufferInfo ? bufferInfo->data.get() : nullptr;
+        if (!data || bufferInfo->offset != 0 || data->valueCount() != numVertices) return false;
+        if (data->dataSize() != data->valueCount() * data->valueSize()) return false;
+        return data->cast<vsg::vec2Array>() || data->cast<vsg::vec3Array>() || data->cast<vsg::vec4Array>() ||
+               data->cast<vsg::svec2Array>() || data->cast<vsg::svec4Array>() || data->cast<vsg::usvec2Array>() || data->cast<vsg::usvec4Array>() || data->cast<vsg::ubvec4Array>(); // compressed attributes
+    }
+
+    vsg::ref_ptr<vsg::Data> createArray(const vsg::Data* prototype, uint32_t numVertices)
+    {
+        vsg::ref_ptr<vsg::Data> array;
+        if (prototype->cast<vsg::vec2Array>()) array = vsg::vec2Array::create(numVertices);
+        else if (prototype->cast<vsg::vec3Array>()) array = vsg::vec3Array::create(numVertices);
+        else if (prototype->cast<vsg::vec4Array>()) array = vsg::vec4Array::create(numVertices);
+        else if (prototype->cast<vsg::svec2Array>()) array = vsg::svec2Array::create(numVertices);
+        else if (prototype->cast<vsg::svec4Array>()) array = vsg::svec4Array::create(numVertices);
+        else if (prototype->cast<vsg::usvec2Array>()) array = vsg::usvec2Array::create(numVertices);
+        else if (prototype->cast<vsg::usvec4Array>()) array = vsg::usvec4Array::create(numVertices);
+        else array = vsg::ubvec4Array::create(numVertices);
+        array->properties.format = prototype->properties.format;
+        return array;
+    }
+
+    // match the CullNode/StateGroup/VertexIndexDraw or StateGroup/VertexIndexDraw subgraphs ConvertToVsg::apply(osg::Geometry&) creates,
+    // with the MatrixTransform decoding compressed positions above the StateGroup when there is one
+    bool getCandidate(const vsg::ref_ptr<vsg::Node>& node, Candidate& candidate)
+    {
+        vsg::Node* child = node.get();
+        if (auto cullNode = node->cast<vsg::CullNode>())
+        {
+            child = cullNode->child.get();
+            candidate.culled = true;
+        }
+
+        if (auto transform = child ? child->cast<vsg::MatrixTransform>() : nullptr)
+        {
+            if (transform->children.size() != 1) return false;
+            candidate.positionTransform = transform;
+            child = transform->children.front().get();
+        }
+
+        auto stateGroup = child ? child->cast<vsg::StateGroup>() : nullptr;
+        if (!stateGroup || stateGroup->children.size() != 1) return false;
+
+        auto draw = stateGroup->children.front()->cast<vsg::VertexIndexDraw>();
+        if (!draw || draw->arrays.empty() || !draw->indices || !draw->indices->data) return false;
+        if (draw->instanceCount != 1 || draw->firstIndex != 0 || draw->vertexOffset != 0 || draw->firstInstance != 0) return false;
+
+        auto& indices = draw->indices->data;
+        if (draw->indices->offset != 0 || draw->indexCount != indices->valueCount()) return false;
+        if (!indices->cast<vsg::ushortArray>() && !indices->cast<vsg::uintArray>()) return false;
+
+        // positions under a transform are only accepted if they are compressed, so transforms other than the one decoding them are left in place
+        auto& vertices = draw->arrays.front()->data;
+        if (!computePositionBound(vertices.get(), candidate.positionTransform ? &candidate.positionTransform->matrix : nullptr, candidate.bound)) return false;
+
+        candidate.numVertices = static_cast<uint32_t>(vertices->valueCount());
+        for (auto& array : draw->arrays)
+        {
+            if (!isMergeableArray(array.get(), candidate.numVertices)) return false;
+        }
+
+        candidate.triangleStrips = getTopology(*stateGroup) == VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+        candidate.node = node;
+        candidate.stateGroup = stateGroup;
+        candidate.draw = draw;
+        return true;
+    }
+
+    Signature computeSignature(const Candidate& candidate)
+    {
+        Signature signature;
+        for (auto& stateCommand : candidate.stateGroup->stateCommands) signature.push_back(reinterpret_cast<uintptr_t>(stateCommand.get()));
+        signature.push_back(candidate.culled ? 1 : 0);
+
+        // compressed positions can only share a draw with those decoded by the same transform
+        signature.push_back(candidate.positionTransform ? 1 : 0);
+        if (candidate.positionTransform)
+        {
+            auto& matrix = candidate.positionTransform->matrix;
+            for (int c = 0; c < 4; ++c)
+            {
+                for (int r = 0; r < 4; ++r)
+                {
+                    uint64_t bits;
+                    std::memcpy(&bits, &matrix[c][r], sizeof(bits));
+                    signature.push_back(bits);
+                }
+            }
+        }
+
+        for (auto& array : candidate.draw->arrays)
+        {
+            signature.push_back(array->data->valueSize());
+            signature.push_back(array->data->properties.format);
+        }
+        return signature;
+    }
+
+    // spread the lower 21 bits of value so they occupy every third bit
+    uint64_t expandBits(uint64_t value)
+    {
+        value &= 0x1fffff;
+        value = (value | (value << 32)) & 0x1f00000000ffffULL;
+        value = (value | (value << 16)) & 0x1f0000ff0000ffULL;
+        value = (value | (value << 8)) & 0x100f00f00f00f00fULL;
+        value = (value | (value << 4)) & 0x10c30c30c30c30c3ULL;
+        value = (value | (value << 2)) & 0x1249249249249249ULL;
+        return value;
+    }
+
+    // triangle strips are joined with primitive restart indices, which are copied as they are rather than offset
+    template<typename T>
+    vsg::ref_ptr<vsg::Data> mergeIndices(const std::vector<Candidate*>& batch, uint32_t numIndices)
+    {
+        constexpr T restart = std::numeric_limits<T>::max();
+        bool triangleStrips = batch.front()->triangleStrips;
+
+        auto indices = vsg::Array<T>::create(numIndices);
+        T* out = indices->data();
+        uint32_t baseVertex = 0;
+        for (auto candidate : batch)
+        {
+            if (triangleStrips && baseVertex > 0) *(out++) = restart;
+
+            auto& data = candidate->draw->indices->data;
+            if (auto ushortIndices = data->cast<vsg::ushortArray>())
+            {
+                for (auto index : *ushortIndices) *(out++) = (triangleStrips && index == 0xffff) ? restart : static_cast<T>(index + baseVertex);
+            }
+            else if (auto uintIndices = data->cast<vsg::uintArray>())
+            {
+                for (auto index : *uintIndices) *(out++) = (triangleStrips && index == 0xffffffff) ? restart : static_cast<T>(index + baseVertex);
+            }
+            baseVertex += candidate->numVertices;
+        }
+        return indices;
+    }
+
+    vsg::ref_ptr<vsg::Node> createBatch(const std::vector<Candidate*>& batch)
+    {
+        auto& first = *batch.front();
+
+        uint32_t numVertices = 0;
+        uint32_t numIndices = 0;
+        vsg::dbox bound;
+        for (auto candidate : batch)
+        {
+            numVertices += candidate->numVertices;
+            numIndices += candidate->draw->indexCount;
+            bound.add(candidate->bound.min);
+            bound.add(candidate->bound.max);
+        }
+
+        vsg::DataList arrays;
+        for (size_t i = 0; i < first.draw->arrays.size(); ++i)
+        {
+            auto array = createArray(first.draw->arrays[i]->data.get(), numVertices);
+
+            auto ptr = static_cast<uint8_t*>(array->dataPointer());
+            for (auto candidate : batch)
+            {
+                auto& data = candidate->draw->arrays[i]->data;
+                std::memcpy(ptr, data->dataPointer(), data->dataSize());
+                ptr += data->dataSize();
+            }
+            arrays.push_back(array);
+        }
+
+        if (first.triangleStrips) numIndices += static_cast<uint32_t>(batch.size()) - 1; // restart indices between the candidates' strips
+
+        // 0xffff is the 16 bit restart index so can't be used as a vertex index by strips
+        uint32_t max16BitVertices = first.triangleStrips ? 65535 : 65536;
+        auto indices = (numVertices <= max16BitVertices) ? mergeIndices<uint16_t>(batch, numIndices) : mergeIndices<uint32_t>(batch, numIndices);
+
+        auto draw = vsg::VertexIndexDraw::create();
+        draw->assignArrays(arrays);
+        draw->assignIndices(indices);
+        draw->indexCount = numIndices;
+        draw->instanceCount = 1;
+        draw->firstIndex = 0;
+        draw->vertexOffset = 0;
+        draw->firstInstance = 0;
+
+        auto stateGroup = vsg::StateGroup::create();
+        stateGroup->stateCommands = first.stateGroup->stateCommands;
+        stateGroup->addChild(draw);
+
+        // the batch shares its candidates' transform decoding compressed positions, the bound of the decoded positions stays above it
+        vsg::ref_ptr<vsg::Node> subgraph = stateGroup;
+        if (first.positionTransform)
+        {
+            auto transform = vsg::MatrixTransform::create(first.positionTransform->matrix);
+            transform->subgraphRequiresLocalFrustum = false;
+            transform->addChild(stateGroup);
+            subgraph = transform;
+        }
+
+        if (!first.culled) return subgraph;
+
+        auto center = (bound.min + bound.max) * 0.5;
+        auto radius = vsg::length(bound.max - bound.min) * 0.5;
+        return vsg::CullNode::create(vsg::dsphere(center.x, center.y, center.z, radius), subgraph);
+    }
+} // namespace
+
+MergeGeometries::MergeGeometries(uint32_t in_maxVertices) :
+    maxVertices(in_maxVertices)
+{
+}
+
+void MergeGeometries::apply(vsg::Node& node)
+{
+    node.traverse(*this);
+}
+
+void MergeGeometries::apply(vsg::Group& group)
+{
+    // subgraphs shared between parents are only merged once
+    if (!_merged.insert(&group).second) return;
+
+    group.traverse(*this);
+
+    merge(group);
+}
+
+void MergeGeometries::merge(vsg::Group& group)
+{
+    if (group.children.size() < 2) return;
+
+    // group the candidates by signature, in the order they are first encountered so the merged output is deterministic
+    std::map<Signature, size_t> signatureIndices;
+    std::vector<std::vector<Candidate>> candidateLists;
+    vsg::dbox extents;
+
+    for (size_t i = 0; i < group.children.size(); ++i)
+    {
+        auto& child = group.children[i];
+        Candidate candidate;
+        if (child && getCandidate(child, candidate))
+        {
+            auto [itr, inserted] = signatureIndices.emplace(computeSignature(candidate), candidateLists.size());
+            if (inserted) candidateLists.emplace_back();
+
+            candidate.index = i;
+            extents.add((candidate.bound.min + candidate.bound.max) * 0.5);
+            candidateLists[itr->second].push_back(candidate);
+        }
+    }
+
+    // each batch replaces the first of its candidates in the children, the slots of the other candidates are removed, so the order of the remaining children is kept for blended and coplanar geometry
+    std::vector<vsg::ref_ptr<vsg::Node>> slots(group.children.begin(), group.children.end());
+    std::vector<bool> removed(slots.size(), false);
+
+    // order the candidates along a Morton curve so consecutive draws, and the batches made from them, are spatially close
+    auto size = extents.max - extents.min;
+    auto scale = vsg::dvec3(size.x > 0.0 ? 2097151.0 / size.x : 0.0, size.y > 0.0 ? 2097151.0 / size.y : 0.0, size.z > 0.0 ? 2097151.0 / size.z : 0.0);
+
+    bool merged = false;
+    for (auto& candidates : candidateLists)
+    {
+        if (candidates.size() < 2) continue;
+
+        for (auto& candidate : candidates)
+        {
+            auto position = ((candidate.bound.min + candidate.bound.max) * 0.5 - extents.min) * scale;
+            candidate.mortonCode = expandBits(static_cast<uint64_t>(position.x)) | (expandBits(static_cast<uint64_t>(position.y)) << 1) | (expandBits(static_cast<uint64_t>(position.z)) << 2);
+        }
+        std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& lhs, const Candidate& rhs) { return lhs.mortonCode < rhs.mortonCode; });
+
+        std::vector<Candidate*> batch;
+        uint32_t batchVertices = 0;
+        auto flush = [&]() {
+            if (batch.size() > 1)
+            {
+                size_t first = batch.front()->index;
+                for (auto candidate : batch)
+                {
+                    first = std::min(first, candidate->index);
+                    removed[candidate->index] = true;
+                }
+                slots[first] = createBatch(batch);
+                removed[first] = false;
+
+                numDrawsMerged += static_cast<uint32_t>(batch.size());
+                ++numBatches;
+                merged = true;
+            }
+            batch.clear();
+            batchVertices = 0;
+        };
+
+        for (auto& candidate : candidates)
+        {
+            if (!batch.empty() && batchVertices + candidate.numVertices > maxVertices) flush();
+            batch.push_back(&candidate);
+            batchVertices += candidate.numVertices;
+        }
+        flush();
+    }
+
+    if (!merged) return;
+
+    vsg::Group::Children children;
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+        if (!removed[i]) children.push_back(slots[i]);
+    }
+    group.children = children;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <set>
+
+namespace osg2vsg
+{
+    /// merge the sibling draws of each group that bind the same state into shared vertex and index arrays, so models made of many small geometries record far fewer draws.
+    /// Merges the CullNode/StateGroup/VertexIndexDraw subgraphs ConvertToVsg creates for each osg::Geometry when all their arrays are per vertex vec2, vec3, vec4 or compressed attribute arrays,
+    /// compressed positions are only merged with those decoded by an identical MatrixTransform, and blended geometries under DepthSorted nodes are left as they are. Siblings are ordered along a Morton curve before being split into batches of at most maxVertices,
+    /// so each batch stays spatially compact and keeps a tight CullNode bound. Each batch takes the place of the first of its draws, the other children keep their order.
+    class MergeGeometries : public vsg::Visitor
+    {
+    public:
+        explicit MergeGeometries(uint32_t in_maxVertices = 65536);
+
+        uint32_t maxVertices;
+
+        uint32_t numDrawsMerged = 0;
+        uint32_t numBatches = 0;
+
+        void apply(vsg::Node& node) override;
+        void apply(vsg::Group& group) override;
+
+    protected:
+        void merge(vsg::Group& group);
+
+        std::set<const vsg::Group*> _merged;
+    };
+
+} // namespace osg2vsg
@@ -0,0 +1,393 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2026 the osg2vsg authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "Meshlets.h"
+#include "BoundingSphere.h"
+#include "GeometryUtils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace osg2vsg;
+
+namespace
+{
+    constexpr uint32_t unassigned = std::numeric_limits<uint32_t>::max();
+
+    // normals spreading further than this from the cone axis leave too little of the view directions culled to be worth testing
+    constexpr float minimumConeDot = 0.1f;
+
+    template<typename T>
+    bool readIndices(const vsg::Data* data, std::vector<uint32_t>& indices)
+    {
+        auto array = data->cast<vsg::Array<T>>();
+        if (!array) return false;
+
+        indices.assign(array->begin(), array->end());
+        return true;
+    }
+
+    template<typename T>
+    bool writeIndices(vsg::Data* data, const std::vector<uint32_t>& indices)
+    {
+        auto array = data->cast<vsg::Array<T>>();
+        if (!array) return false;
+
+        std::copy(indices.begin(), indices.end(), array->begin());
+        return true;
+    }
+
+    // positions of the draw's vertex array, decoding the 16 bit formats written by compressPositions(), in the space the draw's vertices are transformed from
+    bool readPositions(const vsg::Data* data, std::vector<vsg::vec3>& positions)
+    {
+        if (auto vertices = data->cast<vsg::vec3Array>())
+        {
+            positions.assign(vertices->begin(), vertices->end());
+            return true;
+        }
+        if (auto vertices = data->cast<vsg::usvec4Array>(); vertices && data->properties.format == VK_FORMAT_R16G16B16A16_UNORM)
+        {
+            positions.clear();
+            for (auto& v : *vertices) positions.push_back(vsg::vec3(v.x, v.y, v.z) / 65535.0f);
+            return true;
+        }
+        if (auto vertices = data->cast<vsg::svec4Array>(); vertices && data->properties.format == VK_FORMAT_R16G16B16A16_SNORM)
+        {
+            positions.clear();
+            for (auto& v : *vertices) positions.push_back(vsg::vec3(std::max(v.x / 32767.0f, -1.0f), std::max(v.y / 32767.0f, -1.0f), std::max(v.z / 32767.0f, -1.0f)));
+            return true;
+        }
+        return false;
+    }
+
+    void computeBoundsAndCone(const MeshletData& meshletData, const Meshlet& meshlet, const vsg::vec3* vertices, vsg::vec4& bound, vsg::vec4& cone)
+    {
+        std::vector<vsg::vec3> points(meshlet.vertexCount);
+        for (uint32_t i = 0; i < meshlet.vertexCount; ++i) points[i] = vertices[meshletData.vertices[meshlet.vertexOffset + i]];
+
+        auto sphere = computeBoundingSphere(points.data(), points.size(), BOUNDING_SPHERE_RITTER);
+        bound.set(static_cast<float>(sphere.center.x), static_cast<float>(sphere.center.y), static_cast<float>(sphere.center.z), static_cast<float>(sphere.radius));
+
+        std::vector<vsg::vec3> normals;
+        vsg::vec3 axis;
+        for (uint32_t t = meshlet.triangleOffset; t < meshlet.triangleOffset + meshlet.triangleCount; ++t)
+        {
+            auto& p0 = points[meshletData.triangles[t * 3]];
+            auto& p1 = points[meshletData.triangles[t * 3 + 1]];
+            auto& p2 = points[meshletData.triangles[t * 3 + 2]];
+            auto n = vsg::cross(p1 - p0, p2 - p0);
+            float length = vsg::length(n);
+            if (length == 0.0f) continue;
+
+            normals.push_back(n / length);
+            axis += normals.back();
+        }
+
+        cone.set(0.0f, 0.0f, 0.0f, 1.0f);
+
+        float axisLength = vsg::length(axis);
+        if (normals.empty() || axisLength == 0.0f) return;
+        axis = axis / axisLength;
+
+        float minDot = 1.0f;
+        for (auto& n : normals) minDot = std::min(minDot, vsg::dot(n, axis));
+        if (minDot <= minimumConeDot) return;
+
+        // the sine of the cone's half angle, view directions within the complementary cone around the axis see only back faces
+        cone.set(axis.x, axis.y, axis.z, std::sqrt(1.0f - minDot * minDot));
+    }
+} // namespace
+
+void osg2vsg::buildMeshlets(std::vector<uint32_t>& indices, const vsg::vec3* vertices, size_t numVertices, uint32_t maxVertices, uint32_t maxTriangles, bool reorderTriangles, MeshletData& meshletData)
+{
+    meshletData = MeshletData();
+
+    // local indices are 8 bit and a triangle needs up to 3 new vertices
+    maxVertices = std::clamp(maxVertices, 3u, 256u);
+    maxTriangles = std::max(maxTriangles, 1u);
+
+    size_t numTriangles = indices.size() / 3;
+    if (numTriangles == 0) return;
+
+    // triangles adjacent to each vertex
+    std::vector<uint32_t> offsets(numVertices + 1, 0);
+    std::vector<uint32_t> adjacency;
+    if (reorderTriangles)
+    {
+        for (size_t i = 0; i < numTriangles * 3; ++i) ++offsets[indices[i] + 1];
+        for (size_t v = 0; v < numVertices; ++v) offsets[v + 1] += offsets[v];
+
+        adjacency.resize(numTriangles * 3);
+        std::vector<uint32_t> positions(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < numTriangles * 3; ++i) adjacency[positions[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+
+    std::vector<uint32_t> meshletOf(numVertices, unassigned);
+    std::vector<uint8_t> localIndex(numVertices, 0);
+    std::vector<bool> emitted(numTriangles, false);
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> order;
+    order.reserve(numTriangles);
+
+    Meshlet meshlet;
+    vsg::vec3 centroidSum;
+    uint32_t meshletNumber = 0;
+
+    auto newVertices = [&](uint32_t t) {
+        uint32_t count = 0;
+        for (size_t k = 0; k < 3; ++k)
+        {
+            uint32_t v = indices[t * 3 + k];
+            bool repeated = (k > 0 && indices[t * 3] == v) || (k > 1 && indices[t * 3 + 1] == v);
+            if (meshletOf[v] != meshletNumber && !repeated) ++count;
+        }
+        return count;
+    };
+
+    auto centroid = [&](uint32_t t) {
+        return (vertices[indices[t * 3]] + vertices[indices[t * 3 + 1]] + vertices[indices[t * 3 + 2]]) / 3.0f;
+    };
+
+    auto finishMeshlet = [&]() {
+        if (meshlet.triangleCount == 0) return;
+
+        meshletData.meshlets.push_back(meshlet);
+        meshlet.vertexOffset = static_cast<uint32_t>(meshletData.vertices.size());
+        meshlet.vertexCount = 0;
+        meshlet.triangleOffset = static_cast<uint32_t>(meshletData.triangles.size() / 3);
+        meshlet.triangleCount = 0;
+        centroidSum = vsg::vec3();
+        candidates.clear();
+        ++meshletNumber;
+    };
+
+    auto addTriangle = [&](uint32_t t) {
+        for (size_t k = 0; k < 3; ++k)
+        {
+            uint32_t v = indices[t * 3 + k];
+            if (meshletOf[v] != meshletNumber)
+            {
+                meshletOf[v] = meshletNumber;
+                localIndex[v] = static_cast<uint8_t>(meshlet.vertexCount++);
+                meshletData.vertices.push_back(v);
+
+                if (reorderTriangles)
+                {
+                    for (uint32_t a = offsets[v]; a < offsets[v + 1]; ++a)
+                    {
+                        if (!emitted[adjacency[a]]) candidates.push_back(adjacency[a]);
+                    }
+                }
+            }
+            meshletData.triangles.push_back(localIndex[v]);
+        }
+        ++meshlet.triangleCount;
+        emitted[t] = true;
+        order.push_back(t);
+        centroidSum += centroid(t);
+    };
+
+    size_t cursor = 0;
+    while (order.size() < numTriangles)
+    {
+        // grow the meshlet across the candidates adding the fewest vertices, nearest its centre, falling back to the next triangle in order for meshlets with no neighbours left
+        uint32_t next = unassigned;
+        if (reorderTriangles && meshlet.triangleCount > 0)
+        {
+            vsg::vec3 meshletCentre = centroidSum / static_cast<float>(meshlet.triangleCount);
+            uint32_t bestNewVertices = 4;
+            float bestDistance2 = std::numeric_limits<float>::max();
+
+            size_t numCandidates = 0;
+            for (auto t : candidates)
+            {
+                if (emitted[t]) continue;
+                candidates[numCandidates++] = t;
+
+                uint32_t count = newVertices(t);
+                if (meshlet.vertexCount + count > maxVertices) continue;
+
+                auto offset = centroid(t) - meshletCentre;
+                float distance2 = vsg::dot(offset, offset);
+                if (count < bestNewVertices || (count == bestNewVertices && (distance2 < bestDistance2 || (distance2 == bestDistance2 && t < next))))
+                {
+                    next = t;
+                    bestNewVertices = count;
+                    bestDistance2 = distance2;
+                }
+            }
+            candidates.resize(numCandidates);
+        }
+
+        if (next == unassigned)
+        {
+            while (emitted[cursor]) ++cursor;
+            next = static_cast<uint32_t>(cursor);
+        }
+
+        if (meshlet.vertexCount + newVertices(next) > maxVertices) finishMeshlet();
+
+        addTriangle(next);
+
+        if (meshlet.triangleCount >= maxTriangles) finishMeshlet();
+    }
+    finishMeshlet();
+
+    if (reorderTriangles)
+    {
+        std::vector<uint32_t> reordered(numTriangles * 3);
+        for (size_t i = 0; i < numTriangles; ++i)
+        {
+            for (size_t k = 0; k < 3; ++k) reordered[i * 3 + k] = indices[order[i] * 3 + k];
+        }
+        std::copy(reordered.begin(), reordered.end(), indices.begin());
+    }
+
+    meshletData.bounds.resize(meshletData.meshlets.size());
+    meshletData.cones.resize(meshletData.meshlets.size());
+    for (size_t m = 0; m < meshletData.meshlets.size(); ++m)
+    {
+        computeBoundsAndCone(meshletData, meshletData.meshlets[m], vertices, meshletData.bounds[m], meshletData.cones[m]);
+    }
+}
+
+BuildMeshlets::BuildMeshlets(TaskScheduler* in_scheduler, uint32_t in_maxVertices, uint32_t in_maxTriangles) :
+    scheduler(in_scheduler),
+    maxVertices(in_maxVertices),
+    maxTriangles(in_maxTriangles)
+{
+}
+
+void BuildMeshlets::apply(vsg::Node& node)
+{
+    node.traverse(*this);
+}
+
+void BuildMeshlets::apply(vsg::Group& group)
+{
+    if (!_visited.insert(&group).second) return;
+
+    group.traverse(*this);
+}
+
+void BuildMeshlets::apply(vsg::DepthSorted& depthSorted)
+{
+    bool previous = _depthSorted;
+    _depthSorted = true;
+    depthSorted.traverse(*this);
+    _depthSorted = previous;
+}
+
+void BuildMeshlets::apply(vsg::StateGroup& stateGroup)
+{
+    if (!_visited.insert(&stateGroup).second) return;
+
+    bool previous = _triangleStrips;
+    if (getTopology(stateGroup) == VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP) _triangleStrips = true;
+    stateGroup.traverse(*this);
+    _triangleStrips = previous;
+}
+
+void BuildMeshlets::apply(vsg::VertexIndexDraw& vid)
+{
+    // meshlets are built from triangle lists
+    if (_triangleStrips || !_visitedDraws.insert(&vid).second) return;
+    if (!vid.indices || !vid.indices->data) return;
+
+    // draws sharing an index array, such as instanced copies, share its meshlets
+    auto& draw = _draws[vid.indices->data.get()];
+    draw.vids.emplace_back(&vid);
+    if (_depthSorted) draw.reorderTriangles = false;
+}
+
+void BuildMeshlets::build()
+{
+    std::vector<Draw> draws;
+    for (auto& [ptr, draw] : _draws)
+    {
+        bool suitable = true;
+        auto& front = draw.vids.front();
+        for (auto& vid : draw.vids)
+        {
+            suitable = suitable && !vid->arrays.empty() && vid->arrays.front() && vid->arrays.front()->data && vid->arrays.front()->data == front->arrays.front()->data;
+            suitable = suitable && vid->firstIndex == 0 && vid->vertexOffset == 0 && vid->indices->offset == 0 && vid->indexCount == vid->indices->data->valueCount() && vid->indexCount % 3 == 0;
+        }
+        if (suitable) draws.push_back(draw);
+    }
+    _draws.clear();
+
+    std::vector<uint32_t> drawMeshlets(draws.size(), 0);
+
+    parallel_for(scheduler, draws.size(), 1, [&](size_t i) {
+        auto& draw = draws[i];
+        auto indexData = draw.vids.front()->indices->data;
+
+        std::vector<vsg::vec3> positions;
+        if (!readPositions(draw.vids.front()->arrays.front()->data.get(), positions)) return;
+
+        std::vector<uint32_t> indices;
+        if (!readIndices<uint16_t>(indexData.get(), indices) && !readIndices<uint32_t>(indexData.get(), indices)) return;
+        for (auto index : indices)
+        {
+            if (index >= positions.size()) return;
+        }
+
+        MeshletData meshletData;
+        buildMeshlets(indices, positions.data(), positions.size(), maxVertices, maxTriangles, draw.reorderTriangles, meshletData);
+        if (meshletData.meshlets.empty()) return;
+
+        if (draw.reorderTriangles)
+        {
+            if (!writeIndices<uint16_t>(indexData.get(), indices)) writeIndices<uint32_t>(indexData.get(), indices);
+            indexData->dirty();
+        }
+
+        auto meshlets = vsg::uivec4Array::create(static_cast<uint32_t>(meshletData.meshlets.size()));
+        for (size_t m = 0; m < meshletData.meshlets.size(); ++m)
+        {
+            auto& meshlet = meshletData.meshlets[m];
+            meshlets->set(m, vsg::uivec4(meshlet.vertexOffset, meshlet.vertexCount, meshlet.triangleOffset, meshlet.triangleCount));
+        }
+
+        auto meshletVertices = vsg::uintArray::create(static_cast<uint32_t>(meshletData.vertices.size()));
+        std::copy(meshletData.vertices.begin(), meshletData.vertices.end(), meshletVertices->begin());
+
+        auto meshletTriangles = vsg::ubyteArray::create(static_cast<uint32_t>(meshletData.triangles.size()));
+        std::copy(meshletData.triangles.begin(), meshletData.triangles.end(), meshletTriangles->begin());
+
+        auto meshletBounds = vsg::vec4Array::create(static_cast<uint32_t>(meshletData.bounds.size()));
+        std::copy(meshletData.bounds.begin(), meshletData.bounds.end(), meshletBounds->begin());
+
+        auto meshletCones = vsg::vec4Array::create(static_cast<uint32_t>(meshletData.cones.size()));
+        std::copy(meshletData.cones.begin(), meshletData.cones.end(), meshletCones->begin());
+
+        for (auto& vid : draw.vids)
+        {
+            vid->setObject("Meshlets", meshlets);
+            vid->setObject("MeshletVertices", meshletVertices);
+            vid->setObject("MeshletTriangles", meshletTriangles);
+            vid->setObject("MeshletBounds", meshletBounds);
+            vid->setObject("MeshletCones", meshletCones);
+        }
+
+        drawMeshlets[i] = static_cast<uint32_t>(meshletData.meshlets.size());
+    });
+
+    for (auto count : drawMeshlets)
+    {
+        if (count == 0) continue;
+
+        ++numDraws;
+        numMeshlets += count;
+    }
+}
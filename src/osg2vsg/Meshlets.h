@@ -0,0 +1,75 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "TaskScheduler.h"
+
+namespace osg2vsg
+{
+    /// range of a meshlet's vertices in MeshletData::vertices and of its triangles, which are the same triangles in the draw's reordered index array and in MeshletData::triangles.
+    struct Meshlet
+    {
+        uint32_t vertexOffset = 0;
+        uint32_t vertexCount = 0;
+        uint32_t triangleOffset = 0;
+        uint32_t triangleCount = 0;
+    };
+
+    /// meshlets of a triangle list, with the bounding sphere (centre, radius) and backface cone (axis, cutoff) of each. A meshlet faces away from the eye,
+    /// so can be culled, when dot(normalize(centre - eye), axis) >= cutoff + radius / length(centre - eye), meshlets whose normals spread too far have a zero axis and a cutoff of 1.
+    struct MeshletData
+    {
+        std::vector<Meshlet> meshlets;
+        std::vector<uint32_t> vertices; // index of each meshlet vertex in the draw's vertex arrays
+        std::vector<uint8_t> triangles; // three meshlet local vertex indices per triangle
+        std::vector<vsg::vec4> bounds;
+        std::vector<vsg::vec4> cones;
+    };
+
+    /// partition the triangle list indices into meshlets of at most maxVertices vertices and maxTriangles triangles. When reorderTriangles is set each meshlet is grown across
+    /// the triangles sharing its vertices, nearest its centre first, and indices reordered so each meshlet's triangles are contiguous, otherwise triangles are taken in their existing order.
+    extern void buildMeshlets(std::vector<uint32_t>& indices, const vsg::vec3* vertices, size_t numVertices, uint32_t maxVertices, uint32_t maxTriangles, bool reorderTriangles, MeshletData& meshletData);
+
+    /// partition the triangle lists of VertexIndexDraw into meshlets for GPU driven rendering, attaching the descriptors to each draw as the "Meshlets" uivec4Array (vertexOffset, vertexCount,
+    /// triangleOffset, triangleCount), "MeshletVertices" uintArray, "MeshletTriangles" ubyteArray, "MeshletBounds" vec4Array and "MeshletCones" vec4Array objects, see MeshletData.
+    /// Usage is to accept() the visitor to collect the draws then call build(), which builds each draw's meshlets as a separate task when a scheduler is assigned.
+    /// Draws under DepthSorted nodes keep their triangle order, draws using triangle strips are left as they are.
+    class BuildMeshlets : public vsg::Visitor
+    {
+    public:
+        explicit BuildMeshlets(TaskScheduler* in_scheduler = nullptr, uint32_t in_maxVertices = 64, uint32_t in_maxTriangles = 124);
+
+        TaskScheduler* scheduler;
+        uint32_t maxVertices;
+        uint32_t maxTriangles;
+
+        uint32_t numDraws = 0;
+        uint64_t numMeshlets = 0;
+
+        void apply(vsg::Node& node) override;
+        void apply(vsg::Group& group) override;
+        void apply(vsg::DepthSorted& depthSorted) override;
+        void apply(vsg::StateGroup& stateGroup) override;
+        void apply(vsg::VertexIndexDraw& vid) override;
+
+        void build();
+
+    protected:
+        struct Draw
+        {
+            std::vector<vsg::ref_ptr<vsg::VertexIndexDraw>> vids; // draws sharing the index array
+            bool reorderTriangles = true;
+        };
+
+        bool _depthSorted = false;
+        bool _triangleStrips = false;
+        std::set<const vsg::Group*> _visited;
+        std::set<const vsg::VertexIndexDraw*> _visitedDraws;
+        std::map<const vsg::Data*, Draw> _draws;
+    };
+
+} // namespace osg2vsg
@@ -0,0 +1,373 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2026 the osg2vsg authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "Mipmaps.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#    define OSG2VSG_SSE2 1
+#    include <emmintrin.h>
+#endif
+
+using namespace osg2vsg;
+
+namespace
+{
+    struct Level
+    {
+        uint32_t width;
+        uint32_t height;
+        size_t offset;
+        size_t rowSize;
+    };
+
+    // rows of output per task
+    constexpr size_t bytesPerTask = 256 * 1024;
+
+    size_t rowsPerTask(const Level& level)
+    {
+        return std::max(bytesPerTask / std::max(level.rowSize, size_t(1)), size_t(1));
+    }
+
+    float sRGBToLinear(float value)
+    {
+        return (value <= 0.04045f) ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+    }
+
+    float linearToSRGB(float value)
+    {
+        return (value <= 0.0031308f) ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+    }
+
+    /// lookup tables for converting 8 bit sRGB values to and from linear values
+    struct SRGBTables
+    {
+        static constexpr uint32_t linearSize = 16384;
+
+        float toLinear[256];
+        uint8_t fromLinear[linearSize];
+
+        SRGBTables()
+        {
+            for (uint32_t i = 0; i < 256; ++i) toLinear[i] = sRGBToLinear(i / 255.0f);
+            for (uint32_t i = 0; i < linearSize; ++i) fromLinear[i] = static_cast<uint8_t>(std::lround(linearToSRGB(i / float(linearSize - 1)) * 255.0f));
+        }
+
+        static const SRGBTables& instance()
+        {
+            static SRGBTables s_tables;
+            return s_tables;
+        }
+    };
+
+    /// decodes components to linear values, 8 bit components use lookup tables
+    template<typename T>
+    struct Decoder
+    {
+        uint32_t numSRGBComponents;
+
+        float operator()(T value, uint32_t component) const
+        {
+            float normalized = std::is_floating_point_v<T> ? float(value) : float(value) / float(std::numeric_limits<T>::max());
+            return (component < numSRGBComponents) ? sRGBToLinear(normalized) : normalized;
+        }
+    };
+
+    template<>
+    struct Decoder<uint8_t>
+    {
+        const float* tables[4];
+
+        explicit Decoder(uint32_t numSRGBComponents)
+        {
+            static const auto s_linear = []() {
+                std::array<float, 256> table;
+                for (uint32_t i = 0; i < 256; ++i) table[i] = i / 255.0f;
+                return table;
+            }();
+            for (uint32_t c = 0; c < 4; ++c) tables[c] = (c < numSRGBComponents) ? SRGBTables::instance().toLinear : s_linear.data();
+        }
+
+        float operator()(uint8_t value, uint32_t component) const { return tables[component][value]; }
+    };
+
+    template<typename T>
+    T encode(float value, bool sRGB)
+    {
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            return sRGB ? linearToSRGB(std::max(value, 0.0f)) : value;
+        }
+        else
+        {
+            value = std::min(std::max(value, 0.0f), 1.0f);
+            if constexpr (sizeof(T) == 1)
+            {
+                if (sRGB) return SRGBTables::instance().fromLinear[static_cast<uint32_t>(value * (SRGBTables::linearSize - 1) + 0.5f)];
+            }
+            else if (sRGB)
+            {
+                value = linearToSRGB(value);
+            }
+            return static_cast<T>(value * float(std::numeric_limits<T>::max()) + 0.5f);
+        }
+    }
+
+    /// source indices and weights contributing to each destination texel along one axis, numTaps entries per texel
+    struct Taps
+    {
+        uint32_t numTaps = 0;
+        std::vector<uint32_t> indices;
+        std::vector<float> weights;
+    };
+
+    double besselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 32; ++k)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+            if (term < sum * 1e-12) break;
+        }
+        return sum;
+    }
+
+    Taps computeTaps(uint32_t srcSize, uint32_t dstSize, MipmapFilter filter, bool repeat)
+    {
+        constexpr double alpha = 4.0;  // Kaiser window shape
+        constexpr double pi = 3.14159265358979323846;
+
+        // filter radius in destination texels
+        double radius = (filter == MIPMAP_FILTER_KAISER) ? 2.0 : 0.5;
+        double scale = double(srcSize) / double(dstSize);
+        double support = radius * scale;
+
+        Taps taps;
+        taps.numTaps = static_cast<uint32_t>(std::ceil(support * 2.0)) + 1;
+        taps.indices.resize(size_t(dstSize) * taps.numTaps);
+        taps.weights.resize(size_t(dstSize) * taps.numTaps);
+
+        for (uint32_t x = 0; x < dstSize; ++x)
+        {
+            double center = (x + 0.5) * scale;
+            auto first = static_cast<int64_t>(std::floor(center - support));
+
+            double total = 0.0;
+            std::vector<double> weights(taps.numTaps);
+            for (uint32_t k = 0; k < taps.numTaps; ++k)
+            {
+                int64_t i = first + k;
+                double d = (i + 0.5 - center) / scale;
+
+                double weight = 0.0;
+                if (filter == MIPMAP_FILTER_KAISER)
+                {
+                    if (std::abs(d) < radius)
+                    {
+                        double sinc = (d == 0.0) ? 1.0 : std::sin(pi * d) / (pi * d);
+                        double u = d / radius;
+                        weight = sinc * besselI0(alpha * std::sqrt(1.0 - u * u)) / besselI0(alpha);
+                    }
+                }
+                else if (std::abs(d) < 0.5)
+                {
+                    weight = 1.0;
+                }
+
+                weights[k] = weight;
+                total += weight;
+
+                int64_t size = srcSize;
+                int64_t index = repeat ? ((i % size) + size) % size : std::min(std::max(i, int64_t(0)), size - 1);
+                taps.indices[x * taps.numTaps + k] = static_cast<uint32_t>(index);
+            }
+
+            for (uint32_t k = 0; k < taps.numTaps; ++k)
+            {
+                taps.weights[x * taps.numTaps + k] = static_cast<float>(weights[k] / total);
+            }
+        }
+
+        return taps;
+    }
+
+    /// filter src level into dst level, vertically into a row of linear values and then horizontally into the destination row
+    template<typename T>
+    void filterLevel(const uint8_t* src, const Level& s, uint8_t* dst, const Level& d, uint32_t numComponents, uint32_t numSRGBComponents, MipmapFilter filter, bool repeatS, bool repeatT, TaskScheduler* scheduler)
+    {
+        auto tapsS = computeTaps(s.width, d.width, filter, repeatS);
+        auto tapsT = computeTaps(s.height, d.height, filter, repeatT);
+
+        size_t numValues = size_t(s.width) * numComponents;
+        Decoder<T> decoder{numSRGBComponents};
+
+        parallel_for(scheduler, d.height, rowsPerTask(d), [&](size_t y) {
+            thread_local std::vector<float> accumulated;
+            accumulated.assign(numValues, 0.0f);
+
+            for (uint32_t k = 0; k < tapsT.numTaps; ++k)
+            {
+                float weight = tapsT.weights[y * tapsT.numTaps + k];
+                if (weight == 0.0f) continue;
+
+                auto row = reinterpret_cast<const T*>(src + tapsT.indices[y * tapsT.numTaps + k] * s.rowSize);
+                float* values = accumulated.data();
+                for (uint32_t x = 0; x < s.width; ++x)
+                {
+                    for (uint32_t c = 0; c < numComponents; ++c) *(values++) += weight * decoder(*(row++), c);
+                }
+            }
+
+            auto out = reinterpret_cast<T*>(dst + y * d.rowSize);
+            for (uint32_t x = 0; x < d.width; ++x)
+            {
+                const uint32_t* indices = &tapsS.indices[x * tapsS.numTaps];
+                const float* weights = &tapsS.weights[x * tapsS.numTaps];
+
+                float values[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+                for (uint32_t k = 0; k < tapsS.numTaps; ++k)
+                {
+                    const float* texel = &accumulated[indices[k] * numComponents];
+                    for (uint32_t c = 0; c < numComponents; ++c) values[c] += weights[k] * texel[c];
+                }
+
+                for (uint32_t c = 0; c < numComponents; ++c) *(out++) = encode<T>(values[c], c < numSRGBComponents);
+            }
+        });
+    }
+
+    /// average 2x2 blocks of 8 bit texels, requires the source level to have even dimensions
+    void boxFilterLevel(const uint8_t* src, const Level& s, uint8_t* dst, const Level& d, uint32_t numComponents, TaskScheduler* scheduler)
+    {
+        parallel_for(scheduler, d.height, rowsPerTask(d), [&](size_t y) {
+            const uint8_t* r0 = src + (y * 2) * s.rowSize;
+            const uint8_t* r1 = r0 + s.rowSize;
+            uint8_t* out = dst + y * d.rowSize;
+
+            uint32_t x = 0;
+#if defined(OSG2VSG_SSE2)
+            if (numComponents == 4)
+            {
+                // 4 destination RGBA texels per iteration, summing vertically then adding neighbouring texels in 16 bit lanes
+                const __m128i zero = _mm_setzero_si128();
+                const __m128i rounding = _mm_set1_epi16(2);
+                auto sumPair = [&](__m128i a, __m128i b, __m128i& first, __m128i& second) {
+                    __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero)); // texels 0, 1
+                    __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero)); // texels 2, 3
+                    first = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+                    second = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+                };
+
+                for (; x + 4 <= d.width; x += 4)
+                {
+                    const uint8_t* p0 = r0 + x * 8;
+                    const uint8_t* p1 = r1 + x * 8;
+                    __m128i s0, s1, s2, s3;
+                    sumPair(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p0)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(p1)), s0, s1);
+                    sumPair(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p0 + 16)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(p1 + 16)), s2, s3);
+
+                    __m128i t01 = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(s0, s1), rounding), 2);
+                    __m128i t23 = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(s2, s3), rounding), 2);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x * 4), _mm_packus_epi16(t01, t23));
+                }
+            }
+#endif
+            for (; x < d.width; ++x)
+            {
+                size_t i0 = size_t(x) * 2 * numComponents;
+                size_t i1 = i0 + numComponents;
+                for (uint32_t c = 0; c < numComponents; ++c)
+                {
+                    out[x * numComponents + c] = static_cast<uint8_t>((r0[i0 + c] + r0[i1 + c] + r1[i0 + c] + r1[i1 + c] + 2) >> 2);
+                }
+            }
+        });
+    }
+} // namespace
+
+osg::ref_ptr<osg::Image> osg2vsg::generateMipmaps(const osg::Image* image, MipmapFilter filter, bool sRGB, bool repeatS, bool repeatT, TaskScheduler* scheduler)
+{
+    if (!image || filter == MIPMAP_FILTER_NONE) return {};
+    if (image->isCompressed() || image->isMipmap() || image->r() != 1 || image->s() <= 0 || image->t() <= 0) return {};
+
+    GLenum pixelFormat = image->getPixelFormat();
+    GLenum dataType = image->getDataType();
+    if (dataType != GL_UNSIGNED_BYTE && dataType != GL_UNSIGNED_SHORT && dataType != GL_FLOAT) return {};
+
+    uint32_t numComponents = osg::Image::computeNumComponents(pixelFormat);
+    if (numComponents < 1 || numComponents > 4) return {};
+
+    uint32_t numLevels = osg::Image::computeNumberOfMipmapLevels(image->s(), image->t(), 1);
+    if (numLevels <= 1) return {};
+
+    // the colour components filtered in linear space, alpha is never sRGB encoded
+    uint32_t numSRGBComponents = 0;
+    if (sRGB)
+    {
+        if (pixelFormat == GL_RGB || pixelFormat == GL_RGBA || pixelFormat == GL_BGR || pixelFormat == GL_BGRA) numSRGBComponents = 3;
+        else if (pixelFormat == GL_LUMINANCE || pixelFormat == GL_LUMINANCE_ALPHA) numSRGBComponents = 1;
+    }
+
+    // tightly packed levels, one after the other, as vsg expects
+    size_t pixelSize = osg::Image::computePixelSizeInBits(pixelFormat, dataType) / 8;
+    std::vector<Level> levels(numLevels);
+    osg::Image::MipmapDataType mipmapOffsets;
+    size_t totalSize = 0;
+    for (uint32_t i = 0; i < numLevels; ++i)
+    {
+        auto& level = levels[i];
+        level.width = std::max(static_cast<uint32_t>(image->s()) >> i, 1u);
+        level.height = std::max(static_cast<uint32_t>(image->t()) >> i, 1u);
+        level.rowSize = level.width * pixelSize;
+        level.offset = totalSize;
+        if (i > 0) mipmapOffsets.push_back(static_cast<unsigned int>(totalSize));
+        totalSize += level.rowSize * level.height;
+    }
+
+    auto data = new unsigned char[totalSize];
+    for (uint32_t t = 0; t < levels[0].height; ++t)
+    {
+        std::memcpy(data + t * levels[0].rowSize, image->data(0, t), levels[0].rowSize);
+    }
+
+    for (uint32_t i = 1; i < numLevels; ++i)
+    {
+        const Level& s = levels[i - 1];
+        const Level& d = levels[i];
+        const uint8_t* src = data + s.offset;
+        uint8_t* dst = data + d.offset;
+
+        if (filter == MIPMAP_FILTER_BOX && dataType == GL_UNSIGNED_BYTE && numSRGBComponents == 0 && (s.width % 2) == 0 && (s.height % 2) == 0)
+            boxFilterLevel(src, s, dst, d, numComponents, scheduler);
+        else if (dataType == GL_UNSIGNED_BYTE)
+            filterLevel<uint8_t>(src, s, dst, d, numComponents, numSRGBComponents, filter, repeatS, repeatT, scheduler);
+        else if (dataType == GL_UNSIGNED_SHORT)
+            filterLevel<uint16_t>(src, s, dst, d, numComponents, numSRGBComponents, filter, repeatS, repeatT, scheduler);
+        else
+            filterLevel<float>(src, s, dst, d, numComponents, numSRGBComponents, filter, repeatS, repeatT, scheduler);
+    }
+
+    osg::ref_ptr<osg::Image> mipmapped = new osg::Image;
+    mipmapped->setImage(image->s(), image->t(), 1, image->getInternalTextureFormat(), pixelFormat, dataType, data, osg::Image::USE_NEW_DELETE, 1);
+    mipmapped->setMipmapLevels(mipmapOffsets);
+    mipmapped->setOrigin(image->getOrigin());
+    mipmapped->setFileName(image->getFileName());
+    return mipmapped;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <osg/Image>
+
+#include "TaskScheduler.h"
+
+namespace osg2vsg
+{
+    enum MipmapFilter : uint32_t
+    {
+        MIPMAP_FILTER_NONE, // leave mipmap generation to vsg, which generates them on the GPU when the texture is compiled
+        MIPMAP_FILTER_BOX,  // average of each 2x2 block of texels
+        MIPMAP_FILTER_KAISER // Kaiser windowed sinc, sharper than the box filter with less aliasing
+    };
+
+    /// return a copy of a 2D image with the full mipmap chain generated by filtering each level down from the one above.
+    /// sRGB treats the RGB or luminance components as sRGB encoded so they're filtered in linear space, alpha is always filtered linearly.
+    /// repeatS and repeatT wrap the filter kernel around the image edges rather than clamping it, matching REPEAT texture wrap modes.
+    /// Supports unsigned byte, unsigned short and float data with one to four components, returns null for other images and images that already have mipmaps.
+    /// Rows of each level are filtered in parallel when a scheduler is provided.
+    osg::ref_ptr<osg::Image> generateMipmaps(const osg::Image* image, MipmapFilter filter, bool sRGB, bool repeatS, bool repeatT, TaskScheduler* scheduler = nullptr);
+
+} // namespace osg2vsg
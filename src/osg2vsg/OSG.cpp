@@ -23,6 +23,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <osgUtil/Optimizer>
 
 #include "ConvertToVsg.h"
+#include "DiskCache.h"
 #include "ImageUtils.h"
 #include "Optimize.h"
 #include "SceneBuilder.h"
@@ -31,7 +32,8 @@ using namespace osg2vsg;
 
 OSG::OSG()
 {
-    pipelineCache = osg2vsg::PipelineCache::create();
+    // share the process wide pipeline cache used by osg2vsg::convert() when no vsg::Options::sharedObjects are assigned
+    pipelineCache = osg2vsg::PipelineCache::instance();
 }
 
 OSG::~OSG()
@@ -75,6 +77,49 @@ bool OSG::getFeatures(Features& features) const
     features.optionNameTypeMap[OSG::original_converter] = vsg::type_name<bool>();
     features.optionNameTypeMap[OSG::read_build_options] = vsg::type_name<std::string>();
     features.optionNameTypeMap[OSG::write_build_options] = vsg::type_name<std::string>();
+    features.optionNameTypeMap[OSG::num_threads] = vsg::type_name<uint32_t>();
+    features.optionNameTypeMap[OSG::cache_directory] = vsg::type_name<vsg::Path>();
+    features.optionNameTypeMap[OSG::cache_max_megabytes] = vsg::type_name<uint32_t>();
+    features.optionNameTypeMap[OSG::texture_compression] = vsg::type_name<std::string>();
+    features.optionNameTypeMap[OSG::texture_compression_quality] = vsg::type_name<uint32_t>();
+    features.optionNameTypeMap[OSG::compress_normal_maps] = vsg::type_name<bool>();
+    features.optionNameTypeMap[OSG::mipmap_filter] = vsg::type_name<std::string>();
+    features.optionNameTypeMap[OSG::srgb_mipmaps] = vsg::type_name<bool>();
+    features.optionNameTypeMap[OSG::texture_deduplication] = vsg::type_name<std::string>();
+    features.optionNameTypeMap[OSG::merge_geometries] = vsg::type_name<bool>();
+    features.optionNameTypeMap[OSG::max_merged_vertices] = vsg::type_name<uint32_t>();
+    features.optionNameTypeMap[OSG::instance_geometries] = vsg::type_name<bool>();
+    features.optionNameTypeMap[OSG::min_instances] = vsg::type_name<uint32_t>();
+    features.optionNameTypeMap[OSG::max_instances] = vsg::type_name<uint32_t>();
+    features.optionNameTypeMap[OSG::cull_group_hierarchy] = vsg::type_name<bool>();
+    features.optionNameTypeMap[OSG::hierarchy_fan_out] = vsg::type_name<uint32_t>();
+    features.optionNameTypeMap[OSG::hierarchy_leaf_size] = vsg::type_name<uint32_t>();
+    features.optionNameTypeMap[OSG::bounding_sphere] = vsg::type_name<std::string>();
+    features.optionNameTypeMap[OSG::optimize_meshes] = vsg::type_name<bool>();
+    features.optionNameTypeMap[OSG::vertex_cache_size] = vsg::type_name<uint32_t>();
+    features.optionNameTypeMap[OSG::weld_vertices] = vsg::type_name<bool>();
+    features.optionNameTypeMap[OSG::weld_position_epsilon] = vsg::type_name<float>();
+    features.optionNameTypeMap[OSG::weld_normal_epsilon] = vsg::type_name<float>();
+    features.optionNameTypeMap[OSG::split_large_meshes] = vsg::type_name<bool>();
+    features.optionNameTypeMap[OSG::triangle_strips] = vsg::type_name<bool>();
+    features.optionNameTypeMap[OSG::compress_vertices] = vsg::type_name<bool>();
+    features.optionNameTypeMap[OSG::texcoord_compression] = vsg::type_name<std::string>();
+    features.optionNameTypeMap[OSG::compression_normal_tolerance] = vsg::type_name<float>();
+    features.optionNameTypeMap[OSG::compression_texcoord_tolerance] = vsg::type_name<float>();
+    features.optionNameTypeMap[OSG::compression_color_tolerance] = vsg::type_name<float>();
+    features.optionNameTypeMap[OSG::enforce_compression_tolerances] = vsg::type_name<bool>();
+    features.optionNameTypeMap[OSG::position_compression] = vsg::type_name<std::string>();
+    features.optionNameTypeMap[OSG::position_tolerance] = vsg::type_name<float>();
+    features.optionNameTypeMap[OSG::simplify_meshes] = vsg::type_name<bool>();
+    features.optionNameTypeMap[OSG::simplify_min_triangles] = vsg::type_name<uint32_t>();
+    features.optionNameTypeMap[OSG::simplify_levels] = vsg::type_name<uint32_t>();
+    features.optionNameTypeMap[OSG::simplify_level_ratio] = vsg::type_name<float>();
+    features.optionNameTypeMap[OSG::simplify_max_error] = vsg::type_name<float>();
+    features.optionNameTypeMap[OSG::simplify_pixel_error] = vsg::type_name<float>();
+    features.optionNameTypeMap[OSG::build_meshlets] = vsg::type_name<bool>();
+    features.optionNameTypeMap[OSG::max_meshlet_vertices] = vsg::type_name<uint32_t>();
+    features.optionNameTypeMap[OSG::max_meshlet_triangles] = vsg::type_name<uint32_t>();
+    features.optionNameTypeMap[OSG::prune_vertex_attributes] = vsg::type_name<bool>();
 
     return true;
 }
@@ -85,6 +130,49 @@ bool OSG::readOptions(vsg::Options& options, vsg::CommandLine& arguments) const
     bool result = arguments.readAndAssign<bool>(OSG::original_converter, &options);
     result = arguments.readAndAssign<std::string>(OSG::read_build_options, &options) || result;
     result = arguments.readAndAssign<std::string>(OSG::write_build_options, &options) || result;
+    result = arguments.readAndAssign<uint32_t>(OSG::num_threads, &options) || result;
+    result = arguments.readAndAssign<vsg::Path>(OSG::cache_directory, &options) || result;
+    result = arguments.readAndAssign<uint32_t>(OSG::cache_max_megabytes, &options) || result;
+    result = arguments.readAndAssign<std::string>(OSG::texture_compression, &options) || result;
+    result = arguments.readAndAssign<uint32_t>(OSG::texture_compression_quality, &options) || result;
+    result = arguments.readAndAssign<bool>(OSG::compress_normal_maps, &options) || result;
+    result = arguments.readAndAssign<std::string>(OSG::mipmap_filter, &options) || result;
+    result = arguments.readAndAssign<bool>(OSG::srgb_mipmaps, &options) || result;
+    result = arguments.readAndAssign<std::string>(OSG::texture_deduplication, &options) || result;
+    result = arguments.readAndAssign<bool>(OSG::merge_geometries, &options) || result;
+    result = arguments.readAndAssign<uint32_t>(OSG::max_merged_vertices, &options) || result;
+    result = arguments.readAndAssign<bool>(OSG::instance_geometries, &options) || result;
+    result = arguments.readAndAssign<uint32_t>(OSG::min_instances, &options) || result;
+    result = arguments.readAndAssign<uint32_t>(OSG::max_instances, &options) || result;
+    result = arguments.readAndAssign<bool>(OSG::cull_group_hierarchy, &options) || result;
+    result = arguments.readAndAssign<uint32_t>(OSG::hierarchy_fan_out, &options) || result;
+    result = arguments.readAndAssign<uint32_t>(OSG::hierarchy_leaf_size, &options) || result;
+    result = arguments.readAndAssign<std::string>(OSG::bounding_sphere, &options) || result;
+    result = arguments.readAndAssign<bool>(OSG::optimize_meshes, &options) || result;
+    result = arguments.readAndAssign<uint32_t>(OSG::vertex_cache_size, &options) || result;
+    result = arguments.readAndAssign<bool>(OSG::weld_vertices, &options) || result;
+    result = arguments.readAndAssign<float>(OSG::weld_position_epsilon, &options) || result;
+    result = arguments.readAndAssign<float>(OSG::weld_normal_epsilon, &options) || result;
+    result = arguments.readAndAssign<bool>(OSG::split_large_meshes, &options) || result;
+    result = arguments.readAndAssign<bool>(OSG::triangle_strips, &options) || result;
+    result = arguments.readAndAssign<bool>(OSG::compress_vertices, &options) || result;
+    result = arguments.readAndAssign<std::string>(OSG::texcoord_compression, &options) || result;
+    result = arguments.readAndAssign<float>(OSG::compression_normal_tolerance, &options) || result;
+    result = arguments.readAndAssign<float>(OSG::compression_texcoord_tolerance, &options) || result;
+    result = arguments.readAndAssign<float>(OSG::compression_color_tolerance, &options) || result;
+    result = arguments.readAndAssign<bool>(OSG::enforce_compression_tolerances, &options) || result;
+    result = arguments.readAndAssign<std::string>(OSG::position_compression, &options) || result;
+    result = arguments.readAndAssign<float>(OSG::position_tolerance, &options) || result;
+    result = arguments.readAndAssign<bool>(OSG::simplify_meshes, &options) || result;
+    result = arguments.readAndAssign<uint32_t>(OSG::simplify_min_triangles, &options) || result;
+    result = arguments.readAndAssign<uint32_t>(OSG::simplify_levels, &options) || result;
+    result = arguments.readAndAssign<float>(OSG::simplify_level_ratio, &options) || result;
+    result = arguments.readAndAssign<float>(OSG::simplify_max_error, &options) || result;
+    result = arguments.readAndAssign<float>(OSG::simplify_pixel_error, &options) || result;
+    result = arguments.readAndAssign<bool>(OSG::build_meshlets, &options) || result;
+    result = arguments.readAndAssign<uint32_t>(OSG::max_meshlet_vertices, &options) || result;
+    result = arguments.readAndAssign<uint32_t>(OSG::max_meshlet_triangles, &options) || result;
+    result = arguments.readAndAssign<bool>(OSG::prune_vertex_attributes, &options) || result;
     return result;
 }
 
@@ -148,6 +236,20 @@ vsg::ref_ptr<vsg::Object> OSG::read(const vsg::Path& filename, vsg::ref_ptr<cons
         return {};
     }
 
+    // return the result of a previous conversion if neither the source file, the images it references nor the BuildOptions have changed since
+    vsg::ref_ptr<DiskCache> diskCache;
+    DiskCache::Key cacheKey;
+    if (auto cacheDirectory = vsg::value<vsg::Path>({}, OSG::cache_directory, options))
+    {
+        auto sourceFile = vsg::findFile(filename, options);
+        if (sourceFile && DiskCache::computeKey(sourceFile, *readBuildOptions(options), options, cacheKey))
+        {
+            uint64_t maxSize = static_cast<uint64_t>(vsg::value<uint32_t>(1024, OSG::cache_max_megabytes, options)) * 1024 * 1024;
+            diskCache = DiskCache::create(cacheDirectory, maxSize);
+            if (auto object = diskCache->read(cacheKey, options)) return object;
+        }
+    }
+
     osgDB::ReaderWriter::ReadResult rr = osgDB::Registry::instance()->readObject(filename.string(), osg_options.get());
     // if (!rr.success()) OSG_WARN << "Error reading file " << filename << ": " << rr.statusMessage() << std::endl;
     if (!rr.validObject()) return {};
@@ -157,7 +259,9 @@ vsg::ref_ptr<vsg::Object> OSG::read(const vsg::Path& filename, vsg::ref_ptr<cons
     osg::ref_ptr<osg::Object> object = rr.takeObject();
     if (osg::Node* osg_scene = object->asNode(); osg_scene != nullptr)
     {
-        return osg2vsg::convert(*osg_scene, options, filename);
+        auto vsg_scene = osg2vsg::convert(*osg_scene, options, filename);
+        if (vsg_scene && diskCache) diskCache->write(cacheKey, vsg_scene, DiskCache::collectDependencies(*osg_scene, filename), options);
+        return vsg_scene;
     }
     else if (osg::Image* osg_image = dynamic_cast<osg::Image*>(object.get()); osg_image != nullptr)
     {
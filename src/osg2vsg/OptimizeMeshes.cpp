@@ -0,0 +1,453 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2026 the osg2vsg authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "OptimizeMeshes.h"
+#include "GeometryUtils.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+using namespace osg2vsg;
+
+namespace
+{
+    constexpr uint32_t unassigned = std::numeric_limits<uint32_t>::max();
+
+    // FIFO cache of cacheSize entries, vertices are in the cache while fewer than cacheSize other vertices have been transformed since they were
+    struct VertexCache
+    {
+        VertexCache(size_t numVertices, uint32_t in_cacheSize) :
+            cacheSize(in_cacheSize),
+            timestamps(numVertices, 0),
+            timestamp(in_cacheSize + 1) {}
+
+        uint32_t cacheSize;
+        std::vector<uint32_t> timestamps;
+        uint32_t timestamp;
+
+        // return the number of the triangle's vertices that had to be transformed
+        uint32_t add(uint32_t a, uint32_t b, uint32_t c)
+        {
+            uint32_t misses = 0;
+            for (auto v : {a, b, c})
+            {
+                if (timestamp - timestamps[v] > cacheSize)
+                {
+                    timestamps[v] = timestamp++;
+                    ++misses;
+                }
+            }
+            return misses;
+        }
+
+        void flush() { timestamp += cacheSize + 1; }
+    };
+
+    template<typename T>
+    bool readIndices(const vsg::Data* data, std::vector<uint32_t>& indices)
+    {
+        auto array = data->cast<vsg::Array<T>>();
+        if (!array) return false;
+
+        indices.assign(array->begin(), array->end());
+        return true;
+    }
+
+    template<typename T>
+    bool writeIndices(vsg::Data* data, const std::vector<uint32_t>& indices)
+    {
+        auto array = data->cast<vsg::Array<T>>();
+        if (!array) return false;
+
+        std::copy(indices.begin(), indices.end(), array->begin());
+        return true;
+    }
+
+    bool isPerVertexArray(const vsg::BufferInfo* bufferInfo, size_t numVertices)
+    {
+        const vsg::Data* data = bufferInfo ? bufferInfo->data.get() : nullptr;
+        if (!data || data->valueCount() != numVertices) return false;
+        return data->dataSize() == data->valueCount() * data->valueSize();
+    }
+
+    void remapArray(vsg::Data& data, const std::vector<uint32_t>& remap)
+    {
+        size_t valueSize = data.valueSize();
+        auto ptr = static_cast<uint8_t*>(data.dataPointer());
+        std::vector<uint8_t> original(ptr, ptr + data.dataSize());
+        for (size_t v = 0; v < remap.size(); ++v)
+        {
+            std::memcpy(ptr + remap[v] * valueSize, original.data() + v * valueSize, valueSize);
+        }
+        data.dirty();
+    }
+} // namespace
+
+VertexCacheStatistics osg2vsg::analyzeVertexCache(const std::vector<uint32_t>& indices, size_t numVertices, uint32_t cacheSize)
+{
+    VertexCacheStatistics statistics;
+    statistics.numTriangles = indices.size() / 3;
+
+    std::vector<bool> referenced(numVertices, false);
+    for (auto index : indices)
+    {
+        if (!referenced[index])
+        {
+            referenced[index] = true;
+            ++statistics.numVertices;
+        }
+    }
+
+    VertexCache cache(numVertices, cacheSize);
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        statistics.numTransformed += cache.add(indices[i], indices[i + 1], indices[i + 2]);
+    }
+    return statistics;
+}
+
+void osg2vsg::optimizeVertexCache(std::vector<uint32_t>& indices, size_t numVertices, uint32_t cacheSize)
+{
+    size_t numTriangles = indices.size() / 3;
+    if (numTriangles < 2) return;
+
+    // triangles adjacent to each vertex, liveTriangles counts those not yet emitted
+    std::vector<uint32_t> liveTriangles(numVertices, 0);
+    for (size_t i = 0; i < numTriangles * 3; ++i) ++liveTriangles[indices[i]];
+
+    std::vector<uint32_t> offsets(numVertices + 1, 0);
+    for (size_t v = 0; v < numVertices; ++v) offsets[v + 1] = offsets[v] + liveTriangles[v];
+
+    std::vector<uint32_t> adjacency(numTriangles * 3);
+    {
+        std::vector<uint32_t> positions(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < numTriangles * 3; ++i) adjacency[positions[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+
+    std::vector<uint32_t> timestamps(numVertices, 0);
+    uint32_t timestamp = cacheSize + 1;
+
+    std::vector<bool> emitted(numTriangles, false);
+    std::vector<uint32_t> deadEnds;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> result;
+    result.reserve(numTriangles * 3);
+    deadEnds.reserve(numTriangles * 3);
+
+    size_t cursor = 0;
+    auto skipDeadEnd = [&]() -> int64_t {
+        // prefer recently emitted vertices that still have triangles, then fall back to the next vertex in input order
+        while (!deadEnds.empty())
+        {
+            uint32_t v = deadEnds.back();
+            deadEnds.pop_back();
+            if (liveTriangles[v] > 0) return v;
+        }
+        for (; cursor < numVertices; ++cursor)
+        {
+            if (liveTriangles[cursor] > 0) return static_cast<int64_t>(cursor);
+        }
+        return -1;
+    };
+
+    int64_t fanning = skipDeadEnd();
+    while (fanning >= 0)
+    {
+        candidates.clear();
+        for (uint32_t a = offsets[fanning]; a < offsets[fanning + 1]; ++a)
+        {
+            uint32_t t = adjacency[a];
+            if (emitted[t]) continue;
+
+            for (size_t k = 0; k < 3; ++k)
+            {
+                uint32_t v = indices[t * 3 + k];
+                result.push_back(v);
+                deadEnds.push_back(v);
+                candidates.push_back(v);
+                --liveTriangles[v];
+                if (timestamp - timestamps[v] > cacheSize) timestamps[v] = timestamp++;
+            }
+            emitted[t] = true;
+        }
+
+        // fan next around the candidate that will still be in the cache once its remaining triangles are emitted, preferring the oldest
+        int64_t next = -1;
+        int64_t bestPriority = -1;
+        for (auto v : candidates)
+        {
+            if (liveTriangles[v] == 0) continue;
+
+            int64_t priority = 0;
+            if (timestamp - timestamps[v] + 2 * liveTriangles[v] <= cacheSize) priority = timestamp - timestamps[v];
+            if (priority > bestPriority)
+            {
+                bestPriority = priority;
+                next = v;
+            }
+        }
+
+        fanning = (next >= 0) ? next : skipDeadEnd();
+    }
+
+    std::copy(result.begin(), result.end(), indices.begin());
+}
+
+void osg2vsg::optimizeOverdraw(std::vector<uint32_t>& indices, const vsg::vec3* vertices, size_t numVertices, uint32_t cacheSize, float threshold)
+{
+    size_t numTriangles = indices.size() / 3;
+    if (numTriangles < 2) return;
+
+    // hard boundaries where the cache has been flushed, so clusters can be reordered without losing the locality within them
+    std::vector<size_t> hardBoundaries;
+    {
+        VertexCache cache(numVertices, cacheSize);
+        for (size_t t = 0; t < numTriangles; ++t)
+        {
+            if (cache.add(indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2]) == 3) hardBoundaries.push_back(t);
+        }
+        hardBoundaries.push_back(numTriangles);
+    }
+
+    // split each hard cluster further once its running ACMR is within threshold of the whole cluster's
+    std::vector<size_t> boundaries;
+    {
+        VertexCache cache(numVertices, cacheSize);
+        for (size_t h = 0; h + 1 < hardBoundaries.size(); ++h)
+        {
+            size_t start = hardBoundaries[h];
+            size_t end = hardBoundaries[h + 1];
+
+            cache.flush();
+            uint32_t clusterMisses = 0;
+            for (size_t t = start; t < end; ++t) clusterMisses += cache.add(indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2]);
+            float clusterThreshold = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - start);
+
+            boundaries.push_back(start);
+
+            cache.flush();
+            uint32_t runningMisses = 0;
+            uint32_t runningTriangles = 0;
+            for (size_t t = start; t < end; ++t)
+            {
+                runningMisses += cache.add(indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2]);
+                ++runningTriangles;
+                if (static_cast<float>(runningMisses) <= clusterThreshold * static_cast<float>(runningTriangles))
+                {
+                    boundaries.push_back(t + 1);
+                    cache.flush();
+                    runningMisses = 0;
+                    runningTriangles = 0;
+                }
+            }
+
+            // the last split leaves a poor tail cluster, so merge it with the one before
+            if (boundaries.back() != start) boundaries.pop_back();
+        }
+        boundaries.push_back(numTriangles);
+    }
+
+    size_t numClusters = boundaries.size() - 1;
+    if (numClusters < 2) return;
+
+    // area weighted centroid and normal of each cluster, and the centroid of the whole mesh
+    std::vector<vsg::vec3> centroids(numClusters);
+    std::vector<vsg::vec3> normals(numClusters);
+    vsg::vec3 meshCentroid;
+    float meshArea = 0.0f;
+    for (size_t c = 0; c < numClusters; ++c)
+    {
+        vsg::vec3 centroid;
+        vsg::vec3 normal;
+        float area = 0.0f;
+        for (size_t t = boundaries[c]; t < boundaries[c + 1]; ++t)
+        {
+            auto& p0 = vertices[indices[t * 3]];
+            auto& p1 = vertices[indices[t * 3 + 1]];
+            auto& p2 = vertices[indices[t * 3 + 2]];
+            auto n = vsg::cross(p1 - p0, p2 - p0);
+            float a = vsg::length(n);
+
+            centroid += (p0 + p1 + p2) * (a / 3.0f);
+            normal += n;
+            area += a;
+        }
+
+        meshCentroid += centroid;
+        meshArea += area;
+        centroids[c] = (area > 0.0f) ? centroid / area : vertices[indices[boundaries[c] * 3]];
+        float length = vsg::length(normal);
+        normals[c] = (length > 0.0f) ? normal / length : vsg::vec3();
+    }
+    if (meshArea > 0.0f) meshCentroid /= meshArea;
+
+    std::vector<float> sortKeys(numClusters);
+    std::vector<size_t> order(numClusters);
+    for (size_t c = 0; c < numClusters; ++c)
+    {
+        sortKeys[c] = vsg::dot(centroids[c] - meshCentroid, normals[c]);
+        order[c] = c;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) { return sortKeys[lhs] > sortKeys[rhs]; });
+
+    std::vector<uint32_t> result;
+    result.reserve(numTriangles * 3);
+    for (auto c : order)
+    {
+        result.insert(result.end(), indices.begin() + boundaries[c] * 3, indices.begin() + boundaries[c + 1] * 3);
+    }
+    std::copy(result.begin(), result.end(), indices.begin());
+}
+
+std::vector<uint32_t> osg2vsg::optimizeVertexFetch(std::vector<uint32_t>& indices, size_t numVertices)
+{
+    std::vector<uint32_t> remap(numVertices, unassigned);
+    uint32_t next = 0;
+    for (auto& index : indices)
+    {
+        if (remap[index] == unassigned) remap[index] = next++;
+        index = remap[index];
+    }
+
+    // vertices that aren't referenced keep their relative order at the end
+    for (auto& value : remap)
+    {
+        if (value == unassigned) value = next++;
+    }
+    return remap;
+}
+
+OptimizeMeshes::OptimizeMeshes(TaskScheduler* in_scheduler, uint32_t in_cacheSize) :
+    scheduler(in_scheduler),
+    cacheSize(in_cacheSize)
+{
+}
+
+void OptimizeMeshes::apply(vsg::Node& node)
+{
+    node.traverse(*this);
+}
+
+void OptimizeMeshes::apply(vsg::Group& group)
+{
+    if (!_visited.insert(&group).second) return;
+
+    group.traverse(*this);
+}
+
+void OptimizeMeshes::apply(vsg::DepthSorted& depthSorted)
+{
+    bool previous = _depthSorted;
+    _depthSorted = true;
+    depthSorted.traverse(*this);
+    _depthSorted = previous;
+}
+
+void OptimizeMeshes::apply(vsg::StateGroup& stateGroup)
+{
+    if (!_visited.insert(&stateGroup).second) return;
+
+    bool previous = _triangleStrips;
+    if (getTopology(stateGroup) == VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP) _triangleStrips = true;
+    stateGroup.traverse(*this);
+    _triangleStrips = previous;
+}
+
+void OptimizeMeshes::apply(vsg::VertexIndexDraw& vid)
+{
+    // the optimizations only apply to triangle lists
+    if (_triangleStrips) return;
+
+    auto& draw = _draws[&vid];
+    if (!draw.vid) draw.vid = &vid;
+    if (_depthSorted) draw.reorderTriangles = false;
+}
+
+void OptimizeMeshes::optimize()
+{
+    // arrays shared between draws would be reordered once for each of them, so leave those draws as they are
+    std::map<const vsg::Data*, uint32_t> references;
+    for (auto& [ptr, draw] : _draws)
+    {
+        for (auto& array : draw.vid->arrays)
+        {
+            if (array && array->data) ++references[array->data.get()];
+        }
+        if (draw.vid->indices && draw.vid->indices->data) ++references[draw.vid->indices->data.get()];
+    }
+
+    std::vector<Draw> draws;
+    for (auto& [ptr, draw] : _draws)
+    {
+        auto& vid = draw.vid;
+        if (vid->arrays.empty() || !vid->arrays.front() || !vid->arrays.front()->data || !vid->indices || !vid->indices->data) continue;
+        if (vid->instanceCount != 1 || vid->firstIndex != 0 || vid->vertexOffset != 0 || vid->indices->offset != 0) continue;
+        if (vid->indexCount != vid->indices->data->valueCount() || vid->indexCount % 3 != 0) continue;
+
+        size_t numVertices = vid->arrays.front()->data->valueCount();
+        bool suitable = references[vid->indices->data.get()] == 1;
+        for (auto& array : vid->arrays)
+        {
+            suitable = suitable && isPerVertexArray(array.get(), numVertices) && array->offset == 0 && references[array->data.get()] == 1;
+        }
+        if (suitable) draws.push_back(draw);
+    }
+    _draws.clear();
+
+    std::vector<VertexCacheStatistics> drawsBefore(draws.size());
+    std::vector<VertexCacheStatistics> drawsAfter(draws.size());
+    std::vector<uint8_t> optimized(draws.size(), 0);
+
+    parallel_for(scheduler, draws.size(), 1, [&](size_t i) {
+        auto& draw = draws[i];
+        auto& vid = draw.vid;
+        auto indexData = vid->indices->data;
+        size_t numVertices = vid->arrays.front()->data->valueCount();
+
+        std::vector<uint32_t> indices;
+        if (!readIndices<uint16_t>(indexData.get(), indices) && !readIndices<uint32_t>(indexData.get(), indices)) return;
+        for (auto index : indices)
+        {
+            if (index >= numVertices) return;
+        }
+
+        drawsBefore[i] = analyzeVertexCache(indices, numVertices, cacheSize);
+
+        if (draw.reorderTriangles)
+        {
+            optimizeVertexCache(indices, numVertices, cacheSize);
+            if (auto vertices = vid->arrays.front()->data.cast<vsg::vec3Array>())
+            {
+                optimizeOverdraw(indices, vertices->data(), numVertices, cacheSize);
+            }
+        }
+
+        auto remap = optimizeVertexFetch(indices, numVertices);
+        for (auto& array : vid->arrays) remapArray(*array->data, remap);
+
+        if (!writeIndices<uint16_t>(indexData.get(), indices)) writeIndices<uint32_t>(indexData.get(), indices);
+        indexData->dirty();
+
+        drawsAfter[i] = analyzeVertexCache(indices, numVertices, cacheSize);
+        optimized[i] = 1;
+    });
+
+    for (size_t i = 0; i < draws.size(); ++i)
+    {
+        if (!optimized[i]) continue;
+
+        before.add(drawsBefore[i]);
+        after.add(drawsAfter[i]);
+        ++numDrawsOptimized;
+    }
+}
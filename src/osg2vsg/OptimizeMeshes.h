@@ -0,0 +1,80 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "TaskScheduler.h"
+
+namespace osg2vsg
+{
+    /// post transform vertex cache efficiency of a triangle list, ACMR is the number of vertices transformed per triangle and ATVR the number transformed per vertex referenced.
+    struct VertexCacheStatistics
+    {
+        uint64_t numTriangles = 0;
+        uint64_t numVertices = 0;
+        uint64_t numTransformed = 0;
+
+        double acmr() const { return numTriangles > 0 ? static_cast<double>(numTransformed) / static_cast<double>(numTriangles) : 0.0; }
+        double atvr() const { return numVertices > 0 ? static_cast<double>(numTransformed) / static_cast<double>(numVertices) : 0.0; }
+
+        void add(const VertexCacheStatistics& rhs)
+        {
+            numTriangles += rhs.numTriangles;
+            numVertices += rhs.numVertices;
+            numTransformed += rhs.numTransformed;
+        }
+    };
+
+    /// simulate drawing the triangle list indices through a FIFO vertex cache of cacheSize entries.
+    extern VertexCacheStatistics analyzeVertexCache(const std::vector<uint32_t>& indices, size_t numVertices, uint32_t cacheSize);
+
+    /// reorder the triangles for vertex cache locality using Tipsify (Sander et al. 2007), fanning around recently used vertices.
+    extern void optimizeVertexCache(std::vector<uint32_t>& indices, size_t numVertices, uint32_t cacheSize);
+
+    /// split the cache optimized triangles into clusters where the cache efficiency allows, then order the clusters so those facing away from the centre of the mesh are drawn first, reducing overdraw.
+    /// threshold is the ACMR, relative to the unsplit cluster, each cluster may degrade to.
+    extern void optimizeOverdraw(std::vector<uint32_t>& indices, const vsg::vec3* vertices, size_t numVertices, uint32_t cacheSize, float threshold = 1.05f);
+
+    /// renumber the vertices in the order they are first referenced by indices, returning the new index of each original vertex.
+    extern std::vector<uint32_t> optimizeVertexFetch(std::vector<uint32_t>& indices, size_t numVertices);
+
+    /// optimize the index and vertex arrays of the VertexIndexDraw produced by convertToVsg(osg::Geometry*, ..) for the post transform vertex cache, overdraw and vertex fetch.
+    /// Usage is to accept() the visitor to collect the draws then call optimize(), which optimizes each draw as a separate task when a scheduler is assigned.
+    /// Draws under DepthSorted nodes keep their triangle order as blending depends on it, only their vertices are reordered. Draws using triangle strips are left as they are.
+    class OptimizeMeshes : public vsg::Visitor
+    {
+    public:
+        explicit OptimizeMeshes(TaskScheduler* in_scheduler = nullptr, uint32_t in_cacheSize = 16);
+
+        TaskScheduler* scheduler;
+        uint32_t cacheSize;
+
+        uint32_t numDrawsOptimized = 0;
+        VertexCacheStatistics before;
+        VertexCacheStatistics after;
+
+        void apply(vsg::Node& node) override;
+        void apply(vsg::Group& group) override;
+        void apply(vsg::DepthSorted& depthSorted) override;
+        void apply(vsg::StateGroup& stateGroup) override;
+        void apply(vsg::VertexIndexDraw& vid) override;
+
+        void optimize();
+
+    protected:
+        struct Draw
+        {
+            vsg::ref_ptr<vsg::VertexIndexDraw> vid;
+            bool reorderTriangles = true;
+        };
+
+        bool _depthSorted = false;
+        bool _triangleStrips = false;
+        std::set<const vsg::Group*> _visited;
+        std::map<const vsg::VertexIndexDraw*, Draw> _draws;
+    };
+
+} // namespace osg2vsg
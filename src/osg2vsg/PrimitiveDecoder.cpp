@@ -0,0 +1,196 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2026 the osg2vsg authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "PrimitiveDecoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+using namespace osg2vsg;
+
+namespace
+{
+    // triangle list indices a primitive of count vertices decodes to, those of quads and quad strips counted separately as they are placed after the other triangles
+    void countIndices(GLenum mode, size_t count, size_t& numTriangleIndices, size_t& numQuadIndices)
+    {
+        switch (mode)
+        {
+        case GL_TRIANGLES:
+            numTriangleIndices += (count / 3) * 3;
+            break;
+        case GL_TRIANGLE_STRIP:
+        case GL_TRIANGLE_FAN:
+        case GL_POLYGON:
+            if (count >= 3) numTriangleIndices += (count - 2) * 3;
+            break;
+        case GL_QUADS:
+            numQuadIndices += (count / 4) * 6;
+            break;
+        case GL_QUAD_STRIP:
+            if (count >= 4) numQuadIndices += ((count - 2) / 2) * 6;
+            break;
+        default:
+            break;
+        }
+    }
+
+    // write the triangles of a primitive, index(i) returning the vertex index of its i'th vertex, following osg::TemplatePrimitiveIndexFunctor
+    template<typename F>
+    void decodePrimitive(GLenum mode, size_t count, F index, uint32_t*& triangles, uint32_t*& quads)
+    {
+        auto addTriangle = [](uint32_t*& ptr, uint32_t i0, uint32_t i1, uint32_t i2) {
+            ptr[0] = i0;
+            ptr[1] = i1;
+            ptr[2] = i2;
+            ptr += 3;
+        };
+
+        switch (mode)
+        {
+        case GL_TRIANGLES:
+            for (size_t i = 2; i < count; i += 3) addTriangle(triangles, index(i - 2), index(i - 1), index(i));
+            break;
+        case GL_TRIANGLE_STRIP:
+            // odd triangles swap their last two vertices to keep the winding consistent
+            for (size_t i = 2; i < count; ++i)
+            {
+                if (i % 2)
+                    addTriangle(triangles, index(i - 2), index(i), index(i - 1));
+                else
+                    addTriangle(triangles, index(i - 2), index(i - 1), index(i));
+            }
+            break;
+        case GL_TRIANGLE_FAN:
+        case GL_POLYGON:
+            for (size_t i = 2; i < count; ++i) addTriangle(triangles, index(0), index(i - 1), index(i));
+            break;
+        case GL_QUADS:
+            for (size_t i = 3; i < count; i += 4)
+            {
+                addTriangle(quads, index(i - 3), index(i - 2), index(i - 1));
+                addTriangle(quads, index(i - 3), index(i - 1), index(i));
+            }
+            break;
+        case GL_QUAD_STRIP:
+            // each quad is (0, 1, 3, 2) of the four vertices it adds
+            for (size_t i = 3; i < count; i += 2)
+            {
+                addTriangle(quads, index(i - 3), index(i - 2), index(i));
+                addTriangle(quads, index(i - 3), index(i), index(i - 1));
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    // counts the indices of the primitive sets when constructed without output, otherwise writes them to the triangles and quads output positions
+    class TriangleDecoder : public osg::PrimitiveIndexFunctor
+    {
+    public:
+        uint32_t* triangles = nullptr;
+        uint32_t* quads = nullptr;
+
+        size_t numTriangleIndices = 0;
+        size_t numQuadIndices = 0;
+
+        void setVertexArray(unsigned int, const osg::Vec2*) override {}
+        void setVertexArray(unsigned int, const osg::Vec3*) override {}
+        void setVertexArray(unsigned int, const osg::Vec4*) override {}
+        void setVertexArray(unsigned int, const osg::Vec2d*) override {}
+        void setVertexArray(unsigned int, const osg::Vec3d*) override {}
+        void setVertexArray(unsigned int, const osg::Vec4d*) override {}
+
+        void drawArrays(GLenum mode, GLint first, GLsizei count) override
+        {
+            if (count <= 0) return;
+
+            if (!triangles)
+            {
+                countIndices(mode, count, numTriangleIndices, numQuadIndices);
+            }
+            else if (mode == GL_TRIANGLES)
+            {
+                size_t numIndices = (static_cast<size_t>(count) / 3) * 3;
+                std::iota(triangles, triangles + numIndices, static_cast<uint32_t>(first));
+                triangles += numIndices;
+            }
+            else
+            {
+                decodePrimitive(mode, count, [first](size_t i) { return static_cast<uint32_t>(first + i); }, triangles, quads);
+            }
+        }
+
+        template<typename T>
+        void decodeElements(GLenum mode, GLsizei count, const T* indices)
+        {
+            if (count <= 0 || !indices) return;
+
+            if (!triangles)
+            {
+                countIndices(mode, count, numTriangleIndices, numQuadIndices);
+            }
+            else if (mode == GL_TRIANGLES)
+            {
+                // triangle lists are already in the decoded layout so are copied as a block, widening 8 and 16 bit indices
+                size_t numIndices = (static_cast<size_t>(count) / 3) * 3;
+                if constexpr (sizeof(T) == sizeof(uint32_t))
+                    std::memcpy(triangles, indices, numIndices * sizeof(uint32_t));
+                else
+                    std::copy(indices, indices + numIndices, triangles);
+                triangles += numIndices;
+            }
+            else
+            {
+                decodePrimitive(mode, count, [indices](size_t i) { return static_cast<uint32_t>(indices[i]); }, triangles, quads);
+            }
+        }
+
+        void drawElements(GLenum mode, GLsizei count, const GLubyte* indices) override { decodeElements(mode, count, indices); }
+        void drawElements(GLenum mode, GLsizei count, const GLushort* indices) override { decodeElements(mode, count, indices); }
+        void drawElements(GLenum mode, GLsizei count, const GLuint* indices) override { decodeElements(mode, count, indices); }
+
+        void begin(GLenum mode) override
+        {
+            _mode = mode;
+            _vertices.clear();
+        }
+        void vertex(unsigned int pos) override { _vertices.push_back(pos); }
+        void end() override
+        {
+            if (!_vertices.empty()) decodeElements(_mode, static_cast<GLsizei>(_vertices.size()), _vertices.data());
+        }
+
+    protected:
+        GLenum _mode = 0;
+        std::vector<GLuint> _vertices;
+    };
+} // namespace
+
+void osg2vsg::decodeTriangles(const osg::Geometry& geometry, std::vector<uint32_t>& triangles)
+{
+    triangles.clear();
+
+    TriangleDecoder counter;
+    geometry.accept(counter);
+
+    size_t numIndices = counter.numTriangleIndices + counter.numQuadIndices;
+    if (numIndices == 0) return;
+
+    triangles.resize(numIndices);
+
+    TriangleDecoder decoder;
+    decoder.triangles = triangles.data();
+    decoder.quads = triangles.data() + counter.numTriangleIndices;
+    geometry.accept(decoder);
+}
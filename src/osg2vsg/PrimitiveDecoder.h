@@ -0,0 +1,15 @@
+#pragma once
+
+#include <osg/Geometry>
+
+#include <cstdint>
+#include <vector>
+
+namespace osg2vsg
+{
+    /// decode the triangles, triangle strips, triangle fans, polygons, quads and quad strips of the geometry's primitive sets into a triangle list, in the same order as
+    /// osg::TemplatePrimitiveIndexFunctor visits them with the triangles split from quads placed after all the other triangles. The indices are counted first so triangles
+    /// is sized once and each primitive set written straight into it, DrawElementsUInt and DrawElementsUShort triangle lists are copied as a block. Points and lines aren't decoded.
+    extern void decodeTriangles(const osg::Geometry& geometry, std::vector<uint32_t>& triangles);
+
+} // namespace osg2vsg
@@ -13,6 +13,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include "SceneBuilder.h"
 
 #include "GeometryUtils.h"
+#include "Hash.h"
 #include "ImageUtils.h"
 #include "Optimize.h"
 #include "ShaderUtils.h"
@@ -85,51 +86,162 @@ SceneBuilderBase::StatePair SceneBuilderBase::computeStatePair(osg::StateSet* st
     return StatePair(uniqueState(programState, true), uniqueState(dataState, false));
 }
 
-SceneBuilderBase::StatePair& SceneBuilderBase::getStatePair()
+SceneBuilderBase::StatePair SceneBuilderBase::createStatePair(const StateStack& stack)
 {
-    auto& statepair = stateMap[statestack];
+    if (stack.empty()) return StatePair();
 
-    if (!statestack.empty() && (!statepair.first || !statepair.second))
+    osg::ref_ptr<osg::StateSet> combined;
+    if (stack.size() == 1)
     {
-        osg::ref_ptr<osg::StateSet> combined;
-        if (statestack.size() == 1)
-        {
-            combined = statestack.back();
-        }
-        else
+        combined = stack.back();
+    }
+    else
+    {
+        combined = new osg::StateSet;
+        for (auto& stateset : stack)
         {
-            combined = new osg::StateSet;
-            for (auto& stateset : statestack)
-            {
-                combined->merge(*stateset);
-            }
+            combined->merge(*stateset);
         }
+    }
+
+    return computeStatePair(combined);
+}
+
+SceneBuilderBase::StatePair SceneBuilderBase::getStatePair()
+{
+    return getStatePair(statestack);
+}
 
-        statepair = computeStatePair(combined);
+SceneBuilderBase::StatePair SceneBuilderBase::getStatePair(const StateStack& stack)
+{
+    auto& statepair = stateMap[stack];
+
+    if (!stack.empty() && (!statepair.first || !statepair.second))
+    {
+        statepair = createStatePair(stack);
     }
     return statepair;
 }
 
-vsg::ref_ptr<vsg::DescriptorImage> SceneBuilderBase::convertToVsgTexture(const osg::Texture* osgtexture)
+vsg::ref_ptr<vsg::DescriptorImage> SceneBuilderBase::createVsgTexture(const osg::Texture* osgtexture, bool normalMap)
 {
-    if (auto itr = texturesMap.find(osgtexture); itr != texturesMap.end()) return itr->second;
+    osg::ref_ptr<const osg::Image> image = osgtexture ? osgtexture->getImage(0) : nullptr;
 
-    const osg::Image* image = osgtexture ? osgtexture->getImage(0) : nullptr;
-    auto textureData = convertToVsg(image, buildOptions->mapRGBtoRGBAHint);
+    // generate the mipmaps up front, vsg would otherwise generate them on the GPU as the texture is compiled, and can't for compressed textures
+    auto minFilter = osgtexture ? osgtexture->getFilter(osg::Texture::MIN_FILTER) : osg::Texture::LINEAR;
+    if (buildOptions->mipmapFilter != MIPMAP_FILTER_NONE && minFilter != osg::Texture::LINEAR && minFilter != osg::Texture::NEAREST)
+    {
+        bool repeatS = osgtexture->getWrap(osg::Texture::WRAP_S) == osg::Texture::REPEAT;
+        bool repeatT = osgtexture->getWrap(osg::Texture::WRAP_T) == osg::Texture::REPEAT;
+        bool sRGB = buildOptions->sRGBMipmaps && !normalMap;
+        if (auto mipmapped = generateMipmaps(image.get(), buildOptions->mipmapFilter, sRGB, repeatS, repeatT, buildOptions->scheduler.get())) image = mipmapped;
+    }
+
+    vsg::ref_ptr<vsg::Data> textureData;
+    if (buildOptions->textureCompression != TEXTURE_COMPRESSION_NONE && (!normalMap || buildOptions->compressNormalMaps))
+    {
+        textureData = compressImage(image.get(), buildOptions->textureCompression, buildOptions->textureCompressionQuality, buildOptions->scheduler.get());
+    }
+
+    // images that can't be block compressed are converted uncompressed
+    if (!textureData) textureData = convertToVsg(image.get(), buildOptions->mapRGBtoRGBAHint, buildOptions->scheduler.get());
     if (!textureData)
     {
         // DEBUG_OUTPUT << "Could not convert osg image data" << std::endl;
         return vsg::ref_ptr<vsg::DescriptorImage>();
     }
 
-    vsg::ref_ptr<vsg::Sampler> sampler = convertToSampler(osgtexture);
+    vsg::ref_ptr<vsg::Sampler> sampler = uniqueSampler(convertToSampler(osgtexture));
+
+    return vsg::DescriptorImage::create(sampler, textureData, 0, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+}
+
+vsg::ref_ptr<vsg::DescriptorImage> SceneBuilderBase::convertToVsgTexture(const osg::Texture* osgtexture, bool normalMap)
+{
+    if (auto itr = texturesMap.find({osgtexture, normalMap}); itr != texturesMap.end()) return itr->second;
 
-    auto texture = vsg::DescriptorImage::create(sampler, textureData, 0, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
-    texturesMap[osgtexture] = texture;
+    auto texture = createOrShareVsgTexture(osgtexture, normalMap);
+    if (texture) texturesMap[{osgtexture, normalMap}] = texture;
 
     return texture;
 }
 
+bool SceneBuilderBase::computeTextureContentKey(const osg::Texture* osgtexture, bool normalMap, TextureContentKey& key) const
+{
+    const osg::Image* image = osgtexture ? osgtexture->getImage(0) : nullptr;
+    if (!image || !image->data()) return false;
+
+    // the layout is kept along with the data so images that only differ in their dimensions or format don't match
+    key.image.clear();
+    appendValueKey(key.image, image->s());
+    appendValueKey(key.image, image->t());
+    appendValueKey(key.image, image->r());
+    appendValueKey(key.image, image->getInternalTextureFormat());
+    appendValueKey(key.image, image->getPixelFormat());
+    appendValueKey(key.image, image->getDataType());
+    appendValueKey(key.image, image->getPacking());
+    appendValueKey(key.image, image->getRowLength());
+    appendValueKey(key.image, image->getOrigin());
+    for (auto offset : image->getMipmapLevels()) appendValueKey(key.image, offset);
+    key.image.append(reinterpret_cast<const char*>(image->data()), image->getTotalSizeInBytesIncludingMipmaps());
+    key.imageHash = hash64(key.image.data(), key.image.size());
+
+    // the sampler settings and every build setting that createVsgTexture() uses
+    key.settings.clear();
+    appendValueKey(key.settings, osgtexture->getTextureTarget());
+    appendValueKey(key.settings, osgtexture->getFilter(osg::Texture::MIN_FILTER));
+    appendValueKey(key.settings, osgtexture->getFilter(osg::Texture::MAG_FILTER));
+    appendValueKey(key.settings, osgtexture->getWrap(osg::Texture::WRAP_S));
+    appendValueKey(key.settings, osgtexture->getWrap(osg::Texture::WRAP_T));
+    appendValueKey(key.settings, osgtexture->getWrap(osg::Texture::WRAP_R));
+    appendValueKey(key.settings, osgtexture->getMaxAnisotropy());
+    appendValueKey(key.settings, osg::Vec4f(osgtexture->getBorderColor()));
+    appendValueKey(key.settings, normalMap);
+    appendValueKey(key.settings, buildOptions->mapRGBtoRGBAHint);
+    appendValueKey(key.settings, buildOptions->textureCompression);
+    appendValueKey(key.settings, buildOptions->textureCompressionQuality);
+    appendValueKey(key.settings, buildOptions->compressNormalMaps);
+    appendValueKey(key.settings, buildOptions->mipmapFilter);
+    appendValueKey(key.settings, buildOptions->sRGBMipmaps);
+
+    return true;
+}
+
+vsg::ref_ptr<vsg::DescriptorImage> SceneBuilderBase::createOrShareVsgTexture(const osg::Texture* osgtexture, bool normalMap)
+{
+    TextureContentKey key;
+    auto& textureContentCache = buildOptions->textureContentCache;
+    if (!textureContentCache || !computeTextureContentKey(osgtexture, normalMap, key)) return createVsgTexture(osgtexture, normalMap);
+
+    bool duplicate = false;
+    auto texture = textureContentCache->getOrCreate(key, [&]() { return createVsgTexture(osgtexture, normalMap); }, duplicate);
+    if (duplicate) sharedTexture(*texture);
+    return texture;
+}
+
+vsg::dsphere SceneBuilderBase::computeBound(const osg::Geometry& geometry, uint32_t geometryMask)
+{
+    // billboards are rotated or translated in the vertex shader and geometry with a bound callback or initial bound has its own idea of its extents, so keep the OSG bound for them
+    auto vertices = dynamic_cast<const osg::Vec3Array*>(geometry.getVertexArray());
+    bool useVertices = buildOptions->boundingSphereMethod != BOUNDING_SPHERE_OSG && vertices && !vertices->empty() &&
+                       (geometryMask & TRANSLATE) == 0 && (nodeShaderModeMasks & (BILLBOARD | SHADER_TRANSLATE)) == 0 &&
+                       !geometry.getComputeBoundingBoxCallback() && !geometry.getInitialBound().valid();
+
+    if (!useVertices)
+    {
+        const osg::BoundingSphere& bs = geometry.getBound();
+        return vsg::dsphere(bs.center().x(), bs.center().y(), bs.center().z(), bs.radius());
+    }
+
+    return computeVertexBound(*vertices);
+}
+
+vsg::dsphere SceneBuilderBase::computeVertexBound(const osg::Vec3Array& vertices)
+{
+    static_assert(sizeof(osg::Vec3) == sizeof(vsg::vec3), "osg::Vec3 and vsg::vec3 must have the same layout.");
+    return computeBoundingSphere(reinterpret_cast<const vsg::vec3*>(vertices.getDataPointer()), vertices.size(), buildOptions->boundingSphereMethod);
+}
+
 vsg::ref_ptr<vsg::DescriptorSet> SceneBuilderBase::createVsgStateSet(vsg::ref_ptr<vsg::DescriptorSetLayout> descriptorSetLayout, const osg::StateSet* stateset, uint32_t shaderModeMask)
 {
     if (!stateset) return vsg::ref_ptr<vsg::DescriptorSet>();
@@ -141,11 +253,11 @@ vsg::ref_ptr<vsg::DescriptorSet> SceneBuilderBase::createVsgStateSet(vsg::ref_pt
         const osg::Texture* osgtex = dynamic_cast<const osg::Texture*>(texatt);
         if (osgtex)
         {
-            auto vsgtex = convertToVsgTexture(osgtex);
+            auto vsgtex = convertToVsgTexture(osgtex, i == NORMAL_TEXTURE_UNIT);
             if (vsgtex)
             {
-                // shaders are looking for textures in original units
-                vsgtex->dstBinding = i;
+                // shaders are looking for textures in original units, the converted texture may be shared with other threads so bind its image through a new descriptor rather than modifying it
+                if (vsgtex->dstBinding != i) vsgtex = vsg::DescriptorImage::create(vsgtex->imageInfoList, i, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
                 descriptors.push_back(vsgtex);
             }
             else
@@ -160,7 +272,7 @@ vsg::ref_ptr<vsg::DescriptorSet> SceneBuilderBase::createVsgStateSet(vsg::ref_pt
     if ((shaderModeMask & ShaderModeMask::MATERIAL) && (osg_material != nullptr) /*&& stateset->getMode(GL_COLOR_MATERIAL) == osg::StateAttribute::Values::ON*/)
     {
         auto matdata = convertToMaterialValue(osg_material);
-        auto vsg_materialUniform = vsg::DescriptorBuffer::create(matdata, MATERIAL_BINDING); // just use high value for now, should maybe put uniforms into a different descriptor set to simplify binding indexes
+        auto vsg_materialUniform = uniqueMaterial(matdata, MATERIAL_BINDING); // just use high value for now, should maybe put uniforms into a different descriptor set to simplify binding indexes
         descriptors.push_back(vsg_materialUniform);
     }
 
@@ -174,9 +286,7 @@ vsg::ref_ptr<vsg::DescriptorSet> SceneBuilderBase::createVsgStateSet(vsg::ref_pt
 
     if (descriptors.size() == 0) return vsg::ref_ptr<vsg::DescriptorSet>();
 
-    auto descriptorSet = vsg::DescriptorSet::create(descriptorSetLayout, descriptors);
-
-    return descriptorSet;
+    return uniqueDescriptorSet(vsg::DescriptorSet::create(descriptorSetLayout, descriptors));
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -350,7 +460,7 @@ void SceneBuilder::apply(osg::Geometry& geometry)
 
     if (geometry.getStateSet()) pushStateSet(*geometry.getStateSet());
 
-    StatePair& statePair = getStatePair();
+    StatePair statePair = getStatePair();
 
     osg::Matrix matrix;
     if (!matrixstack.empty()) matrix = matrixstack.back();
@@ -566,6 +676,16 @@ vsg::ref_ptr<vsg::Node> SceneBuilder::createTransformGeometryGraphVSG(TransformG
                 vsg::dvec3 bb_max(overall_bb.xMax(), overall_bb.yMax(), overall_bb.zMax());
                 vsg::dsphere boundingSphere((bb_min + bb_max) * 0.5, vsg::length(bb_max - bb_min) * 0.5);
 
+                // the spheres of the geometries transformed into the parent's frame are often tighter than the sphere around the transformed boxes
+                if (buildOptions->boundingSphereMethod != BOUNDING_SPHERE_OSG)
+                {
+                    std::vector<vsg::dsphere> spheres;
+                    for (auto& geometry : geometries) spheres.push_back(transformBoundingSphere(computeBound(*geometry, requiredGeomAttributesMask), vsgmatrix));
+
+                    auto enclosingSphere = computeBoundingSphere(spheres);
+                    if (enclosingSphere.valid() && enclosingSphere.radius < boundingSphere.radius) boundingSphere = enclosingSphere;
+                }
+
                 if (buildOptions->insertCullNodes)
                 {
                     group->addChild(vsg::CullNode::create(boundingSphere, transform));
@@ -633,7 +753,10 @@ vsg::ref_ptr<vsg::Node> SceneBuilder::createTransformGeometryGraphVSG(TransformG
             }
             else
             {
-                leaf = convertToVsg(geometry, requiredGeomAttributesMask, buildOptions->geometryTarget);
+                GeometryConversionSettings settings;
+                settings.welding = buildOptions->vertexWelding;
+                settings.splitLargeMeshes = buildOptions->splitLargeMeshes;
+                leaf = convertToVsg(geometry, requiredGeomAttributesMask, buildOptions->geometryTarget, settings);
                 if (leaf)
                 {
                     geometriesMap[geometry] = leaf;
@@ -644,11 +767,7 @@ vsg::ref_ptr<vsg::Node> SceneBuilder::createTransformGeometryGraphVSG(TransformG
 
             if (requiresLeafCullGroup)
             {
-                osg::BoundingBox bb = geometry->getBoundingBox();
-                vsg::dvec3 bb_min(bb.xMin(), bb.yMin(), bb.zMin());
-                vsg::dvec3 bb_max(bb.xMax(), bb.yMax(), bb.zMax());
-
-                vsg::dsphere boundingSphere((bb_min + bb_max) * 0.5, vsg::length(bb_max - bb_min) * 0.5);
+                vsg::dsphere boundingSphere = computeBound(*geometry, requiredGeomAttributesMask);
                 if (buildOptions->insertCullNodes)
                 {
                     DEBUG_OUTPUT << "Using CullNode" << std::endl;
@@ -740,6 +859,7 @@ vsg::ref_ptr<vsg::Node> SceneBuilder::createVSG(vsg::Paths& searchPaths)
         uint32_t geometrymask = (masks.second | buildOptions->overrideGeomAttributes) & buildOptions->supportedGeometryAttributes;
         uint32_t shaderModeMask = (masks.first | buildOptions->overrideShaderModeMask) & buildOptions->supportedShaderModeMask;
         if (shaderModeMask & NORMAL_MAP) geometrymask |= TANGENT; // mesh probably won't have tangents so force them on if we want Normal mapping
+        if (buildOptions->pruneVertexAttributes) geometrymask = pruneGeometryAttributes(shaderModeMask, geometrymask);
 
         DEBUG_OUTPUT << "  about to call createStateSetWithGraphicsPipeline(" << shaderModeMask << ", " << geometrymask << ", " << maxNumDescriptors << ")" << std::endl;
 
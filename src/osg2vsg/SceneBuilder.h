@@ -10,6 +10,7 @@
 #include <osgUtil/Optimizer>
 
 #include "BuildOptions.h"
+#include "ConversionCache.h"
 
 namespace osg2vsg
 {
@@ -21,23 +22,15 @@ namespace osg2vsg
         SceneBuilderBase(vsg::ref_ptr<const BuildOptions> options) :
             buildOptions(options) {}
 
+        virtual ~SceneBuilderBase() {}
+
         using StateStack = std::vector<osg::ref_ptr<osg::StateSet>>;
         using StateSets = std::set<StateStack>;
         using StatePair = std::pair<osg::ref_ptr<osg::StateSet>, osg::ref_ptr<osg::StateSet>>;
         using StateMap = std::map<StateStack, StatePair>;
         using GeometriesMap = std::map<const osg::Geometry*, vsg::ref_ptr<vsg::Command>>;
 
-        using TexturesMap = std::map<const osg::Texture*, vsg::ref_ptr<vsg::DescriptorImage>>;
-
-        struct UniqueStateSet
-        {
-            bool operator()(const osg::ref_ptr<osg::StateSet>& lhs, const osg::ref_ptr<osg::StateSet>& rhs) const
-            {
-                if (!lhs) return true;
-                if (!rhs) return false;
-                return lhs->compare(*rhs) < 0;
-            }
-        };
+        using TexturesMap = std::map<std::pair<const osg::Texture*, bool>, vsg::ref_ptr<vsg::DescriptorImage>>;
 
         using UniqueStats = std::set<osg::ref_ptr<osg::StateSet>, UniqueStateSet>;
 
@@ -51,15 +44,35 @@ namespace osg2vsg
         TexturesMap texturesMap;
         bool writeToFileProgramAndDataSetSets = false;
 
-        osg::ref_ptr<osg::StateSet> uniqueState(osg::ref_ptr<osg::StateSet> stateset, bool programStateSet);
+        virtual osg::ref_ptr<osg::StateSet> uniqueState(osg::ref_ptr<osg::StateSet> stateset, bool programStateSet);
 
         StatePair computeStatePair(osg::StateSet* stateset);
-        StatePair& getStatePair();
+        StatePair createStatePair(const StateStack& stack);
+        StatePair getStatePair();
+        virtual StatePair getStatePair(const StateStack& stack);
 
         // core VSG style usage
-        vsg::ref_ptr<vsg::DescriptorImage> convertToVsgTexture(const osg::Texture* osgtexture);
+        // normalMap is set for textures bound to the NORMAL_TEXTURE_UNIT, so they can be excluded from texture compression
+        vsg::ref_ptr<vsg::DescriptorImage> createVsgTexture(const osg::Texture* osgtexture, bool normalMap = false);
+        virtual vsg::ref_ptr<vsg::DescriptorImage> convertToVsgTexture(const osg::Texture* osgtexture, bool normalMap = false);
+
+        // share the converted texture through buildOptions->textureContentCache when assigned, otherwise create a new one
+        bool computeTextureContentKey(const osg::Texture* osgtexture, bool normalMap, TextureContentKey& key) const;
+        vsg::ref_ptr<vsg::DescriptorImage> createOrShareVsgTexture(const osg::Texture* osgtexture, bool normalMap = false);
+
+        // called when createOrShareVsgTexture() returns a texture already converted for another osg::Texture with the same content
+        virtual void sharedTexture(const vsg::DescriptorImage& /*texture*/) {}
+
+        // return the shared equivalent of the sampler, material or descriptor set, the base implementations don't share them
+        virtual vsg::ref_ptr<vsg::Sampler> uniqueSampler(vsg::ref_ptr<vsg::Sampler> sampler) { return sampler; }
+        virtual vsg::ref_ptr<vsg::DescriptorBuffer> uniqueMaterial(vsg::ref_ptr<vsg::materialValue> material, uint32_t binding) { return vsg::DescriptorBuffer::create(material, binding); }
+        virtual vsg::ref_ptr<vsg::DescriptorSet> uniqueDescriptorSet(vsg::ref_ptr<vsg::DescriptorSet> descriptorSet) { return descriptorSet; }
 
         vsg::ref_ptr<vsg::DescriptorSet> createVsgStateSet(vsg::ref_ptr<vsg::DescriptorSetLayout> descriptorSetLayout, const osg::StateSet* stateset, uint32_t shaderModeMask);
+
+        // bounding sphere used to cull the converted geometry, computed from its vertices using buildOptions->boundingSphereMethod where they bound what is drawn, otherwise geometry.getBound()
+        vsg::dsphere computeBound(const osg::Geometry& geometry, uint32_t geometryMask);
+        virtual vsg::dsphere computeVertexBound(const osg::Vec3Array& vertices);
     };
 
     class SceneBuilder : public osg::NodeVisitor, public SceneBuilderBase
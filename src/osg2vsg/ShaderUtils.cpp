@@ -77,6 +77,8 @@ std::set<std::string> osg2vsg::createPSCDefineStrings(const uint32_t& shaderMode
     if (hascolor) defines.insert("VSG_COLOR");
     if (hastex0) defines.insert("VSG_TEXCOORD0");
     if (hastangent) defines.insert("VSG_TANGENT");
+    if (hasnormal && (geometryAttrbutes & NORMAL_OCT16)) defines.insert("VSG_OCT_NORMAL");
+    if (hastangent && (geometryAttrbutes & TANGENT_OCT16)) defines.insert("VSG_OCT_TANGENT");
 
     // shading modes/maps
     if (hasnormal && (shaderModeMask & LIGHTING)) defines.insert("VSG_LIGHTING");
@@ -94,5 +96,19 @@ std::set<std::string> osg2vsg::createPSCDefineStrings(const uint32_t& shaderMode
 
     if (shaderModeMask & SHADER_TRANSLATE) defines.insert("VSG_TRANSLATE");
 
+    if (geometryAttrbutes & INSTANCE_TRANSFORM) defines.insert("VSG_INSTANCE_TRANSFORM");
+
     return defines;
 }
+
+uint32_t osg2vsg::pruneGeometryAttributes(uint32_t shaderModeMask, uint32_t geometryAttributes)
+{
+    const uint32_t textureMaps = DIFFUSE_MAP | OPACITY_MAP | AMBIENT_MAP | NORMAL_MAP | SPECULAR_MAP | AORM_MAP;
+
+    if ((shaderModeMask & textureMaps) == 0) geometryAttributes &= ~(TEXCOORD0 | TEXCOORD0_HALF | TEXCOORD0_UNORM16);
+    if ((shaderModeMask & LIGHTING) == 0) geometryAttributes &= ~(NORMAL | NORMAL_OVERALL | NORMAL_OCT16);
+    if ((shaderModeMask & (LIGHTING | NORMAL_MAP)) != (LIGHTING | NORMAL_MAP) || (geometryAttributes & TEXCOORD0) == 0) geometryAttributes &= ~(TANGENT | TANGENT_OVERALL | TANGENT_OCT16);
+    if ((shaderModeMask & (BILLBOARD | SHADER_TRANSLATE)) == 0) geometryAttributes &= ~(TRANSLATE | TRANSLATE_OVERALL);
+
+    return geometryAttributes;
+}
@@ -43,4 +43,9 @@ namespace osg2vsg
 
     std::set<std::string> createPSCDefineStrings(const uint32_t& shaderModeMask, const uint32_t& geometryAttrbutes);
 
+    /// remove the vertex attributes that the shaders compiled with createPSCDefineStrings(shaderModeMask, ...) don't read, so the pipeline and the geometry's vertex buffers
+    /// leave them out: normals are only read for lighting, texcoords only for texture maps, tangents only for lit normal maps and translations only for billboards and SHADER_TRANSLATE.
+    /// Colors are kept as the shaders modulate the base color by them.
+    uint32_t pruneGeometryAttributes(uint32_t shaderModeMask, uint32_t geometryAttributes);
+
 } // namespace osg2vsg
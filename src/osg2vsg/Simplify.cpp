@@ -0,0 +1,342 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2026 the osg2vsg authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "Simplify.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+using namespace osg2vsg;
+
+namespace
+{
+    // sum of squared distances to a set of planes, weighted by the area of the triangles they come from, evaluated as the weighted mean squared distance
+    struct Quadric
+    {
+        double a00 = 0.0, a11 = 0.0, a22 = 0.0, a01 = 0.0, a02 = 0.0, a12 = 0.0;
+        double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+        double c = 0.0;
+        double weight = 0.0;
+
+        // add the plane n.p + d = 0, n of unit length
+        void addPlane(const vsg::dvec3& n, double d, double w)
+        {
+            a00 += w * n.x * n.x;
+            a11 += w * n.y * n.y;
+            a22 += w * n.z * n.z;
+            a01 += w * n.x * n.y;
+            a02 += w * n.x * n.z;
+            a12 += w * n.y * n.z;
+            b0 += w * n.x * d;
+            b1 += w * n.y * d;
+            b2 += w * n.z * d;
+            c += w * d * d;
+            weight += w;
+        }
+
+        Quadric& operator+=(const Quadric& rhs)
+        {
+            a00 += rhs.a00;
+            a11 += rhs.a11;
+            a22 += rhs.a22;
+            a01 += rhs.a01;
+            a02 += rhs.a02;
+            a12 += rhs.a12;
+            b0 += rhs.b0;
+            b1 += rhs.b1;
+            b2 += rhs.b2;
+            c += rhs.c;
+            weight += rhs.weight;
+            return *this;
+        }
+
+        double error(const vsg::dvec3& p) const
+        {
+            if (weight <= 0.0) return 0.0;
+
+            double e = a00 * p.x * p.x + a11 * p.y * p.y + a22 * p.z * p.z + 2.0 * (a01 * p.x * p.y + a02 * p.x * p.z + a12 * p.y * p.z) + 2.0 * (b0 * p.x + b1 * p.y + b2 * p.z) + c;
+            return std::max(e, 0.0) / weight;
+        }
+    };
+
+    enum VertexKind : uint8_t
+    {
+        MANIFOLD, // collapses onto any neighbour
+        BORDER,   // on an open border, collapses only along it
+        LOCKED    // shares its position with other vertices, or is on a non manifold edge
+    };
+
+    // border edges are weighted well above the triangles so borders keep their shape as the triangles along them are removed
+    constexpr double borderWeight = 10.0;
+
+    inline uint64_t edgeKey(uint32_t a, uint32_t b)
+    {
+        return (static_cast<uint64_t>(a) << 32) | b;
+    }
+
+    inline bool hasEdge(const std::vector<uint64_t>& edges, uint32_t a, uint32_t b)
+    {
+        return std::binary_search(edges.begin(), edges.end(), edgeKey(a, b));
+    }
+
+    // map each vertex to the first of the vertices with bitwise identical positions
+    std::vector<uint32_t> positionRemap(const vsg::vec3* vertices, size_t numVertices)
+    {
+        auto bits = [&](uint32_t v) {
+            std::array<uint32_t, 3> value;
+            std::memcpy(value.data(), &vertices[v], sizeof(value));
+            return value;
+        };
+
+        std::vector<uint32_t> order(numVertices);
+        for (size_t i = 0; i < numVertices; ++i) order[i] = static_cast<uint32_t>(i);
+        std::sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) { return bits(lhs) < bits(rhs) || (bits(lhs) == bits(rhs) && lhs < rhs); });
+
+        std::vector<uint32_t> remap(numVertices);
+        for (size_t i = 0; i < numVertices; ++i)
+        {
+            remap[order[i]] = (i > 0 && bits(order[i]) == bits(order[i - 1])) ? remap[order[i - 1]] : order[i];
+        }
+        return remap;
+    }
+
+    // sorted directed edges of the triangles between position representatives
+    std::vector<uint64_t> collectEdges(const std::vector<uint32_t>& indices, const std::vector<uint32_t>& remap)
+    {
+        std::vector<uint64_t> edges;
+        edges.reserve(indices.size());
+        for (size_t t = 0; t + 2 < indices.size(); t += 3)
+        {
+            for (size_t k = 0; k < 3; ++k)
+            {
+                uint32_t a = remap[indices[t + k]], b = remap[indices[t + (k + 1) % 3]];
+                if (a != b) edges.push_back(edgeKey(a, b));
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+        return edges;
+    }
+
+    vsg::dvec3 position(const vsg::vec3* vertices, uint32_t v)
+    {
+        return vsg::dvec3(vertices[v].x, vertices[v].y, vertices[v].z);
+    }
+} // namespace
+
+float osg2vsg::simplifyTriangles(std::vector<uint32_t>& indices, const vsg::vec3* vertices, size_t numVertices, size_t targetIndexCount, float maxError)
+{
+    if (indices.size() <= targetIndexCount || numVertices == 0) return 0.0f;
+    for (auto index : indices)
+    {
+        if (index >= numVertices) return 0.0f;
+    }
+
+    auto remap = positionRemap(vertices, numVertices);
+
+    // classify the vertices from the open and repeated edges around their positions
+    std::vector<VertexKind> kinds(numVertices, LOCKED);
+    {
+        std::vector<uint32_t> numShared(numVertices, 0), openOut(numVertices, 0), openIn(numVertices, 0);
+        std::vector<uint8_t> referenced(numVertices, 0), nonManifold(numVertices, 0);
+        for (auto index : indices) referenced[index] = 1;
+        for (size_t v = 0; v < numVertices; ++v)
+        {
+            if (referenced[v]) ++numShared[remap[v]];
+        }
+
+        auto edges = collectEdges(indices, remap);
+        for (size_t i = 0; i < edges.size(); ++i)
+        {
+            uint32_t a = static_cast<uint32_t>(edges[i] >> 32), b = static_cast<uint32_t>(edges[i] & 0xffffffff);
+            if ((i > 0 && edges[i - 1] == edges[i]) || (i + 1 < edges.size() && edges[i + 1] == edges[i]))
+            {
+                nonManifold[a] = nonManifold[b] = 1;
+            }
+            else if (!hasEdge(edges, b, a))
+            {
+                ++openOut[a];
+                ++openIn[b];
+            }
+        }
+
+        for (size_t v = 0; v < numVertices; ++v)
+        {
+            uint32_t r = remap[v];
+            if (numShared[r] > 1 || nonManifold[r]) continue;
+
+            if (openOut[r] == 0 && openIn[r] == 0) kinds[v] = MANIFOLD;
+            else if (openOut[r] == 1 && openIn[r] == 1) kinds[v] = BORDER;
+        }
+    }
+
+    // quadrics of the planes of the triangles around each vertex, along with planes through the border edges perpendicular to their triangles
+    std::vector<Quadric> quadrics(numVertices);
+    {
+        auto edges = collectEdges(indices, remap);
+        for (size_t t = 0; t + 2 < indices.size(); t += 3)
+        {
+            uint32_t v[3] = {indices[t], indices[t + 1], indices[t + 2]};
+            vsg::dvec3 p[3] = {position(vertices, v[0]), position(vertices, v[1]), position(vertices, v[2])};
+
+            vsg::dvec3 n = vsg::cross(p[1] - p[0], p[2] - p[0]);
+            double length = vsg::length(n);
+            if (length == 0.0) continue;
+            n = n / length;
+
+            Quadric q;
+            q.addPlane(n, -vsg::dot(n, p[0]), 0.5 * length);
+            for (auto i : v) quadrics[i] += q;
+
+            for (size_t k = 0; k < 3; ++k)
+            {
+                size_t k1 = (k + 1) % 3;
+                if (hasEdge(edges, remap[v[k1]], remap[v[k]])) continue;
+
+                vsg::dvec3 edge = p[k1] - p[k];
+                vsg::dvec3 m = vsg::cross(edge, n);
+                double edgeLength = vsg::length(m);
+                if (edgeLength == 0.0) continue;
+                m = m / edgeLength;
+
+                Quadric border;
+                border.addPlane(m, -vsg::dot(m, p[k]), borderWeight * vsg::dot(edge, edge));
+                quadrics[v[k]] += border;
+                quadrics[v[k1]] += border;
+            }
+        }
+    }
+
+    struct Collapse
+    {
+        double error;
+        uint32_t source;
+        uint32_t target;
+
+        bool operator<(const Collapse& rhs) const { return error < rhs.error || (error == rhs.error && (source < rhs.source || (source == rhs.source && target < rhs.target))); }
+    };
+
+    double maxError2 = static_cast<double>(maxError) * static_cast<double>(maxError);
+    double largestError2 = 0.0;
+
+    std::vector<uint32_t> offsets(numVertices + 1);
+    std::vector<uint32_t> vertexTriangles;
+    std::vector<Collapse> collapses;
+    std::vector<uint32_t> collapseTarget(numVertices);
+    std::vector<uint8_t> touched(numVertices);
+
+    // each pass collapses the cheapest edges whose neighbourhoods don't overlap, until the target or error limit is reached
+    while (indices.size() > targetIndexCount)
+    {
+        size_t numTriangles = indices.size() / 3;
+
+        // the triangles around each vertex
+        std::fill(offsets.begin(), offsets.end(), 0);
+        for (auto index : indices) ++offsets[index + 1];
+        for (size_t v = 0; v < numVertices; ++v) offsets[v + 1] += offsets[v];
+        vertexTriangles.resize(indices.size());
+        {
+            std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < indices.size(); ++i) vertexTriangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+
+        auto edges = collectEdges(indices, remap);
+
+        collapses.clear();
+        for (size_t t = 0; t < numTriangles; ++t)
+        {
+            for (size_t k = 0; k < 3; ++k)
+            {
+                uint32_t a = indices[t * 3 + k], b = indices[t * 3 + (k + 1) % 3];
+                bool borderEdge = !hasEdge(edges, remap[b], remap[a]);
+
+                // interior edges are seen from the triangles on both sides, so are only considered from one
+                if (!borderEdge && remap[a] > remap[b]) continue;
+
+                for (auto [source, target] : {std::pair(a, b), std::pair(b, a)})
+                {
+                    if (kinds[source] == LOCKED || (kinds[source] == BORDER && !borderEdge)) continue;
+
+                    double error = quadrics[source].error(position(vertices, target));
+                    if (error <= maxError2) collapses.push_back(Collapse{error, source, target});
+                }
+            }
+        }
+        if (collapses.empty()) break;
+
+        std::sort(collapses.begin(), collapses.end());
+
+        size_t goal = (indices.size() - targetIndexCount + 2) / 3;
+        size_t removed = 0;
+        for (size_t v = 0; v < numVertices; ++v) collapseTarget[v] = static_cast<uint32_t>(v);
+        std::fill(touched.begin(), touched.end(), 0);
+
+        for (auto& collapse : collapses)
+        {
+            if (removed >= goal) break;
+
+            uint32_t u = collapse.source, w = collapse.target;
+            if (touched[u] || touched[w]) continue;
+
+            // reject collapses that flip the remaining triangles around u
+            vsg::dvec3 pw = position(vertices, w), pu = position(vertices, u);
+            bool flips = false;
+            size_t numRemoved = 0;
+            for (uint32_t i = offsets[u]; i < offsets[u + 1] && !flips; ++i)
+            {
+                const uint32_t* triangle = &indices[vertexTriangles[i] * 3];
+                if (triangle[0] == w || triangle[1] == w || triangle[2] == w)
+                {
+                    ++numRemoved;
+                    continue;
+                }
+
+                size_t k = (triangle[0] == u) ? 0 : ((triangle[1] == u) ? 1 : 2);
+                vsg::dvec3 p1 = position(vertices, triangle[(k + 1) % 3]), p2 = position(vertices, triangle[(k + 2) % 3]);
+                vsg::dvec3 before = vsg::cross(p1 - pu, p2 - pu);
+                vsg::dvec3 after = vsg::cross(p1 - pw, p2 - pw);
+                flips = vsg::dot(before, after) < 0.25 * vsg::length(before) * vsg::length(after);
+            }
+            if (flips || numRemoved == 0) continue;
+
+            collapseTarget[u] = w;
+            quadrics[w] += quadrics[u];
+            largestError2 = std::max(largestError2, collapse.error);
+            removed += numRemoved;
+
+            // lock the neighbourhood of u for the rest of the pass so the flip tests of later collapses see the positions they will be drawn with
+            touched[w] = 1;
+            for (uint32_t i = offsets[u]; i < offsets[u + 1]; ++i)
+            {
+                const uint32_t* triangle = &indices[vertexTriangles[i] * 3];
+                touched[triangle[0]] = touched[triangle[1]] = touched[triangle[2]] = 1;
+            }
+        }
+        if (removed == 0) break;
+
+        // apply the collapses, dropping the triangles that became degenerate
+        size_t numIndices = 0;
+        for (size_t t = 0; t < numTriangles; ++t)
+        {
+            uint32_t a = collapseTarget[indices[t * 3]], b = collapseTarget[indices[t * 3 + 1]], c = collapseTarget[indices[t * 3 + 2]];
+            if (a == b || b == c || c == a) continue;
+
+            indices[numIndices++] = a;
+            indices[numIndices++] = b;
+            indices[numIndices++] = c;
+        }
+        indices.resize(numIndices);
+    }
+
+    return static_cast<float>(std::sqrt(largestError2));
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <vector>
+
+namespace osg2vsg
+{
+    /// reduce the triangle list indices towards targetIndexCount indices by collapsing edges onto one of their vertices in order of their quadric error (Garland and Heckbert 1997),
+    /// stopping when the next collapse would move the surface further than maxError. Vertices that share their position with another vertex, such as along texcoord or normal seams,
+    /// and vertices on non manifold edges are left in place, vertices on open borders only collapse along the border, and collapses that would flip a triangle are rejected.
+    /// Returns the largest error of the collapses made, in the units of vertices.
+    extern float simplifyTriangles(std::vector<uint32_t>& indices, const vsg::vec3* vertices, size_t numVertices, size_t targetIndexCount, float maxError);
+
+} // namespace osg2vsg
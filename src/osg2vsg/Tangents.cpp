@@ -0,0 +1,139 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2026 the osg2vsg authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "Tangents.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace osg2vsg;
+
+namespace
+{
+    // project v onto the plane perpendicular to the unit vector n
+    inline vsg::vec3 project(const vsg::vec3& v, const vsg::vec3& n)
+    {
+        return v - n * vsg::dot(n, v);
+    }
+
+    // normalize v, or return false if it's too short to have a direction
+    inline bool normalizeVector(vsg::vec3& v)
+    {
+        float lengthSquared = vsg::dot(v, v);
+        if (!(lengthSquared > 1e-20f)) return false;
+        v = v / std::sqrt(lengthSquared);
+        return true;
+    }
+
+    // a unit vector perpendicular to the unit vector n, from the axis least aligned with n
+    inline vsg::vec3 perpendicular(const vsg::vec3& n)
+    {
+        float ax = std::abs(n.x), ay = std::abs(n.y), az = std::abs(n.z);
+        vsg::vec3 axis = (ax <= ay && ax <= az) ? vsg::vec3(1.0f, 0.0f, 0.0f) : ((ay <= az) ? vsg::vec3(0.0f, 1.0f, 0.0f) : vsg::vec3(0.0f, 0.0f, 1.0f));
+        vsg::vec3 t = project(axis, n);
+        if (!normalizeVector(t)) t = axis;
+        return t;
+    }
+} // namespace
+
+void osg2vsg::generateTangents(const vsg::vec3* vertices, const vsg::vec3* normals, const vsg::vec2* texcoords, size_t numVertices, const std::vector<uint32_t>& triangles, vsg::vec4* tangents)
+{
+    if (numVertices == 0) return;
+
+    size_t numTriangles = triangles.size() / 3;
+    auto validTriangle = [&](size_t t) {
+        const uint32_t* v = &triangles[t * 3];
+        return v[0] < numVertices && v[1] < numVertices && v[2] < numVertices;
+    };
+
+    // unit vertex normals, from the area weighted triangle normals when there are no per vertex normals
+    std::vector<vsg::vec3> unitNormals(numVertices);
+    if (normals)
+    {
+        std::copy(normals, normals + numVertices, unitNormals.begin());
+    }
+    else
+    {
+        for (size_t t = 0; t < numTriangles; ++t)
+        {
+            if (!validTriangle(t)) continue;
+
+            const uint32_t* v = &triangles[t * 3];
+            auto faceNormal = vsg::cross(vertices[v[1]] - vertices[v[0]], vertices[v[2]] - vertices[v[0]]);
+            for (int c = 0; c < 3; ++c) unitNormals[v[c]] += faceNormal;
+        }
+    }
+    for (auto& n : unitNormals)
+    {
+        if (!normalizeVector(n)) n.set(0.0f, 0.0f, 1.0f);
+    }
+
+    // angle weighted sums of the tangents of the triangles using each vertex, kept separately for each texture orientation
+    std::vector<vsg::vec3> sums(texcoords ? numVertices * 2 : 0);
+    std::vector<float> weights(texcoords ? numVertices * 2 : 0, 0.0f);
+
+    for (size_t t = 0; t < numTriangles && texcoords; ++t)
+    {
+        if (!validTriangle(t)) continue;
+
+        const uint32_t* v = &triangles[t * 3];
+        auto e1 = vertices[v[1]] - vertices[v[0]];
+        auto e2 = vertices[v[2]] - vertices[v[0]];
+        auto d1 = texcoords[v[1]] - texcoords[v[0]];
+        auto d2 = texcoords[v[2]] - texcoords[v[0]];
+
+        // the triangle's texture space s direction, scaled by twice its signed texture area whose sign gives the orientation
+        float signedArea = d1.x * d2.y - d1.y * d2.x;
+        if (signedArea == 0.0f || !std::isfinite(signedArea)) continue;
+
+        vsg::vec3 s = (e1 * d2.y - e2 * d1.y) * (signedArea > 0.0f ? 1.0f : -1.0f);
+        size_t orientation = signedArea > 0.0f ? 0 : 1;
+
+        for (int c = 0; c < 3; ++c)
+        {
+            uint32_t vi = v[c];
+            const auto& n = unitNormals[vi];
+
+            vsg::vec3 tangent = project(s, n);
+            if (!normalizeVector(tangent)) continue;
+
+            // the corner's angle between its edges, projected onto the plane of its normal
+            vsg::vec3 a = project(vertices[v[(c + 1) % 3]] - vertices[vi], n);
+            vsg::vec3 b = project(vertices[v[(c + 2) % 3]] - vertices[vi], n);
+            if (!normalizeVector(a) || !normalizeVector(b)) continue;
+            float angle = std::acos(std::clamp(vsg::dot(a, b), -1.0f, 1.0f));
+
+            sums[vi * 2 + orientation] += tangent * angle;
+            weights[vi * 2 + orientation] += angle;
+        }
+    }
+
+    // orthogonalize against the vertex normal, each vertex is independent so this loop is left for the compiler to vectorize
+    for (size_t i = 0; i < numVertices; ++i)
+    {
+        const auto& n = unitNormals[i];
+
+        vsg::vec3 tangent;
+        float handedness = 1.0f;
+        bool valid = false;
+        if (texcoords)
+        {
+            size_t orientation = weights[i * 2 + 1] > weights[i * 2] ? 1 : 0;
+            tangent = project(sums[i * 2 + orientation], n);
+            handedness = orientation == 0 ? 1.0f : -1.0f;
+            valid = normalizeVector(tangent);
+        }
+        if (!valid) tangent = perpendicular(n);
+
+        tangents[i].set(tangent.x, tangent.y, tangent.z, handedness);
+    }
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <vector>
+
+namespace osg2vsg
+{
+    /// generate per vertex tangents of the triangle list following the MikkTSpace conventions, so they match those of normal maps baked by tools using it:
+    /// each triangle's texture space tangent is projected onto the plane of each corner's normal and summed weighted by the corner's angle, then orthogonalized against the vertex normal,
+    /// with the handedness of the bitangent, cross(normal, tangent) * w, in w. MikkTSpace splits vertices shared by triangles of opposite texture orientation, here the orientation with the
+    /// larger angle sum is used. Triangles with degenerate texcoords don't contribute, vertices they leave without a tangent are given one perpendicular to their normal.
+    /// When normals is null the vertex normals are computed from the area weighted triangle normals, when texcoords is null every tangent is perpendicular to its normal.
+    extern void generateTangents(const vsg::vec3* vertices, const vsg::vec3* normals, const vsg::vec2* texcoords, size_t numVertices, const std::vector<uint32_t>& triangles, vsg::vec4* tangents);
+
+} // namespace osg2vsg
@@ -0,0 +1,183 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2026 the osg2vsg authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "TaskScheduler.h"
+
+using namespace osg2vsg;
+
+namespace
+{
+    // the scheduler and queue index of the worker thread, if any, that the current thread belongs to
+    thread_local const TaskScheduler* s_currentScheduler = nullptr;
+    thread_local size_t s_currentQueue = 0;
+} // namespace
+
+TaskScheduler::TaskScheduler(uint32_t in_numThreads)
+{
+    if (in_numThreads == 0) in_numThreads = 1;
+
+    for (uint32_t i = 0; i <= in_numThreads; ++i)
+    {
+        _queues.emplace_back(new Queue);
+    }
+
+    for (uint32_t i = 0; i < in_numThreads; ++i)
+    {
+        _threads.emplace_back([this, i]() { workerLoop(i); });
+    }
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _active = false;
+    }
+    _wakeup.notify_all();
+
+    for (auto& thread : _threads)
+    {
+        thread.join();
+    }
+}
+
+vsg::ref_ptr<TaskScheduler> TaskScheduler::instance(uint32_t numThreads)
+{
+    static std::mutex s_mutex;
+    static std::map<uint32_t, vsg::ref_ptr<TaskScheduler>> s_schedulers;
+
+    std::lock_guard<std::mutex> guard(s_mutex);
+    auto& scheduler = s_schedulers[numThreads];
+    if (!scheduler) scheduler = TaskScheduler::create(numThreads);
+    return scheduler;
+}
+
+size_t TaskScheduler::localQueueIndex() const
+{
+    return (s_currentScheduler == this) ? s_currentQueue : (_queues.size() - 1);
+}
+
+void TaskScheduler::run(TaskGroup& group, Task task)
+{
+    ++group.pending;
+
+    auto& queue = *_queues[localQueueIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.entries.push_back(Entry{std::move(task), &group});
+    }
+
+    ++_numQueued;
+
+    // take the sleep mutex so a worker can't miss the notification between checking _numQueued and waiting
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+    }
+    _wakeup.notify_one();
+}
+
+bool TaskScheduler::pop(size_t index, Entry& entry)
+{
+    auto& queue = *_queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.entries.empty()) return false;
+
+    entry = std::move(queue.entries.back());
+    queue.entries.pop_back();
+    --_numQueued;
+    return true;
+}
+
+bool TaskScheduler::popGroup(size_t index, const TaskGroup& group, Entry& entry)
+{
+    auto& queue = *_queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    for (auto itr = queue.entries.rbegin(); itr != queue.entries.rend(); ++itr)
+    {
+        if (itr->group == &group)
+        {
+            entry = std::move(*itr);
+            queue.entries.erase(std::next(itr).base());
+            --_numQueued;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TaskScheduler::steal(size_t index, Entry& entry)
+{
+    size_t numQueues = _queues.size();
+    for (size_t i = 1; i < numQueues; ++i)
+    {
+        auto& queue = *_queues[(index + i) % numQueues];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.entries.empty()) continue;
+
+        entry = std::move(queue.entries.front());
+        queue.entries.pop_front();
+        --_numQueued;
+        return true;
+    }
+    return false;
+}
+
+void TaskScheduler::execute(Entry& entry)
+{
+    entry.task();
+
+    // decrement while holding the group's mutex so the waiting thread can't destroy the group before we have finished with it
+    auto& group = *entry.group;
+    std::lock_guard<std::mutex> lock(group.mutex);
+    if (--group.pending == 0) group.completed.notify_all();
+}
+
+void TaskScheduler::wait(TaskGroup& group)
+{
+    size_t index = localQueueIndex();
+
+    while (group.pending > 0)
+    {
+        Entry entry;
+        if (popGroup(index, group, entry))
+        {
+            execute(entry);
+            continue;
+        }
+
+        // remaining tasks are being run by other threads
+        std::unique_lock<std::mutex> lock(group.mutex);
+        group.completed.wait(lock, [&group]() { return group.pending == 0; });
+    }
+
+    // make sure the thread that completed the last task has released the group
+    std::lock_guard<std::mutex> lock(group.mutex);
+}
+
+void TaskScheduler::workerLoop(size_t index)
+{
+    s_currentScheduler = this;
+    s_currentQueue = index;
+
+    while (_active)
+    {
+        Entry entry;
+        if (pop(index, entry) || steal(index, entry))
+        {
+            execute(entry);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _wakeup.wait(lock, [this]() { return !_active || _numQueued > 0; });
+    }
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <vsg/core/Inherit.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace osg2vsg
+{
+    /// work-stealing thread pool used to convert independent parts of a scene graph in parallel.
+    /// Each worker thread has its own task queue, tasks added from a worker go to the back of its own queue
+    /// and idle workers steal from the front of the other queues.
+    class TaskScheduler : public vsg::Inherit<vsg::Object, TaskScheduler>
+    {
+    public:
+        explicit TaskScheduler(uint32_t in_numThreads);
+
+        TaskScheduler(const TaskScheduler&) = delete;
+        TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+        /// process wide scheduler with numThreads worker threads, created on first use so concurrent and successive conversions share its threads.
+        static vsg::ref_ptr<TaskScheduler> instance(uint32_t numThreads);
+
+        using Task = std::function<void()>;
+
+        /// set of tasks that can be waited on together.
+        struct TaskGroup
+        {
+            std::atomic<size_t> pending = 0;
+            std::mutex mutex;
+            std::condition_variable completed;
+        };
+
+        /// add task to group, to be run by one of the worker threads or by the thread that calls wait(group).
+        void run(TaskGroup& group, Task task);
+
+        /// wait for all the tasks in group to complete, running any of the group's tasks still queued on the calling thread.
+        /// Only tasks from this group are run while waiting so a caller never re-enters unrelated work.
+        void wait(TaskGroup& group);
+
+        uint32_t numThreads() const { return static_cast<uint32_t>(_threads.size()); }
+
+    protected:
+        virtual ~TaskScheduler();
+
+        struct Entry
+        {
+            Task task;
+            TaskGroup* group = nullptr;
+        };
+
+        struct Queue
+        {
+            std::mutex mutex;
+            std::deque<Entry> entries;
+        };
+
+        size_t localQueueIndex() const;
+        bool pop(size_t index, Entry& entry);
+        bool popGroup(size_t index, const TaskGroup& group, Entry& entry);
+        bool steal(size_t index, Entry& entry);
+        void execute(Entry& entry);
+        void workerLoop(size_t index);
+
+        // one queue per worker thread, plus a final queue shared by all non worker threads
+        std::vector<std::unique_ptr<Queue>> _queues;
+        std::vector<std::thread> _threads;
+
+        std::atomic<bool> _active = true;
+        std::atomic<size_t> _numQueued = 0;
+        std::mutex _sleepMutex;
+        std::condition_variable _wakeup;
+    };
+
+    /// call function(i) for all i in [0, count), in chunks of grainSize on the scheduler's threads, or serially on the calling thread when no scheduler is provided.
+    template<typename F>
+    void parallel_for(TaskScheduler* scheduler, size_t count, size_t grainSize, F function)
+    {
+        if (grainSize == 0) grainSize = 1;
+        if (!scheduler || count <= grainSize)
+        {
+            for (size_t i = 0; i < count; ++i) function(i);
+            return;
+        }
+
+        TaskScheduler::TaskGroup group;
+        for (size_t begin = 0; begin < count; begin += grainSize)
+        {
+            size_t end = std::min(begin + grainSize, count);
+            scheduler->run(group, [begin, end, &function]() {
+                for (size_t i = begin; i < end; ++i) function(i);
+            });
+        }
+        scheduler->wait(group);
+    }
+
+} // namespace osg2vsg
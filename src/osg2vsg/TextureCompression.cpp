@@ -0,0 +1,560 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2026 the osg2vsg authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "TextureCompression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+using namespace osg2vsg;
+
+namespace
+{
+    constexpr int numBlockPixels = 16;
+
+    template<typename T>
+    T clampTo(T value, T minValue, T maxValue)
+    {
+        return std::min(std::max(value, minValue), maxValue);
+    }
+
+    /// compute a pair of endpoints for the first N channels of the block's RGBA pixels.
+    template<int N>
+    void fitEndpoints(const uint8_t* rgba, uint32_t quality, float* lo, float* hi)
+    {
+        float minValue[N], maxValue[N], mean[N] = {};
+        for (int c = 0; c < N; ++c)
+        {
+            minValue[c] = 255.0f;
+            maxValue[c] = 0.0f;
+        }
+
+        for (int i = 0; i < numBlockPixels; ++i)
+        {
+            for (int c = 0; c < N; ++c)
+            {
+                float v = rgba[i * 4 + c];
+                minValue[c] = std::min(minValue[c], v);
+                maxValue[c] = std::max(maxValue[c], v);
+                mean[c] += v;
+            }
+        }
+        for (int c = 0; c < N; ++c) mean[c] /= float(numBlockPixels);
+
+        float covariance[N][N] = {};
+        for (int i = 0; i < numBlockPixels; ++i)
+        {
+            float d[N];
+            for (int c = 0; c < N; ++c) d[c] = rgba[i * 4 + c] - mean[c];
+            for (int r = 0; r < N; ++r)
+                for (int c = r; c < N; ++c) covariance[r][c] += d[r] * d[c];
+        }
+        for (int r = 0; r < N; ++r)
+            for (int c = 0; c < r; ++c) covariance[r][c] = covariance[c][r];
+
+        if (quality == TEXTURE_COMPRESSION_FAST)
+        {
+            // use the bounding box diagonal, flipping channels that are anti-correlated with the channel of greatest range
+            int major = 0;
+            for (int c = 1; c < N; ++c)
+            {
+                if (maxValue[c] - minValue[c] > maxValue[major] - minValue[major]) major = c;
+            }
+
+            for (int c = 0; c < N; ++c)
+            {
+                bool flip = covariance[major][c] < 0.0f;
+                lo[c] = flip ? maxValue[c] : minValue[c];
+                hi[c] = flip ? minValue[c] : maxValue[c];
+            }
+            return;
+        }
+
+        // principal axis by power iteration, starting from the bounding box diagonal
+        float axis[N];
+        for (int c = 0; c < N; ++c) axis[c] = maxValue[c] - minValue[c];
+
+        for (int iteration = 0; iteration < 8; ++iteration)
+        {
+            float next[N] = {};
+            for (int r = 0; r < N; ++r)
+                for (int c = 0; c < N; ++c) next[r] += covariance[r][c] * axis[c];
+
+            float length = 0.0f;
+            for (int c = 0; c < N; ++c) length = std::max(length, std::abs(next[c]));
+            if (length == 0.0f) break;
+
+            for (int c = 0; c < N; ++c) axis[c] = next[c] / length;
+        }
+
+        float lengthSquared = 0.0f;
+        for (int c = 0; c < N; ++c) lengthSquared += axis[c] * axis[c];
+        if (lengthSquared == 0.0f)
+        {
+            // single colour block
+            for (int c = 0; c < N; ++c) lo[c] = hi[c] = mean[c];
+            return;
+        }
+
+        float tmin = std::numeric_limits<float>::max(), tmax = -std::numeric_limits<float>::max();
+        for (int i = 0; i < numBlockPixels; ++i)
+        {
+            float t = 0.0f;
+            for (int c = 0; c < N; ++c) t += (rgba[i * 4 + c] - mean[c]) * axis[c];
+            tmin = std::min(tmin, t);
+            tmax = std::max(tmax, t);
+        }
+
+        for (int c = 0; c < N; ++c)
+        {
+            lo[c] = clampTo(mean[c] + axis[c] * tmin / lengthSquared, 0.0f, 255.0f);
+            hi[c] = clampTo(mean[c] + axis[c] * tmax / lengthSquared, 0.0f, 255.0f);
+        }
+    }
+
+    /// least squares fit of the endpoints to the pixels, given the weight of the hi endpoint used by each pixel. Returns false if the fit is degenerate.
+    template<int N>
+    bool refineEndpoints(const uint8_t* rgba, const float* weights, float* lo, float* hi)
+    {
+        float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+        float ax[N] = {}, bx[N] = {};
+        for (int i = 0; i < numBlockPixels; ++i)
+        {
+            float b = weights[i], a = 1.0f - b;
+            aa += a * a;
+            ab += a * b;
+            bb += b * b;
+            for (int c = 0; c < N; ++c)
+            {
+                ax[c] += a * rgba[i * 4 + c];
+                bx[c] += b * rgba[i * 4 + c];
+            }
+        }
+
+        float determinant = aa * bb - ab * ab;
+        if (std::abs(determinant) < 1e-6f) return false;
+
+        for (int c = 0; c < N; ++c)
+        {
+            lo[c] = clampTo((bb * ax[c] - ab * bx[c]) / determinant, 0.0f, 255.0f);
+            hi[c] = clampTo((aa * bx[c] - ab * ax[c]) / determinant, 0.0f, 255.0f);
+        }
+        return true;
+    }
+
+    void writeLE16(uint8_t* dst, uint16_t value)
+    {
+        dst[0] = static_cast<uint8_t>(value);
+        dst[1] = static_cast<uint8_t>(value >> 8);
+    }
+
+    void writeLE32(uint8_t* dst, uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i) dst[i] = static_cast<uint8_t>(value >> (i * 8));
+    }
+
+    //
+    // BC1 colour
+    //
+    uint16_t packRGB565(const float* rgb)
+    {
+        auto r = static_cast<uint16_t>(std::lround(clampTo(rgb[0], 0.0f, 255.0f) * 31.0f / 255.0f));
+        auto g = static_cast<uint16_t>(std::lround(clampTo(rgb[1], 0.0f, 255.0f) * 63.0f / 255.0f));
+        auto b = static_cast<uint16_t>(std::lround(clampTo(rgb[2], 0.0f, 255.0f) * 31.0f / 255.0f));
+        return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+    }
+
+    void unpackRGB565(uint16_t color, int* rgb)
+    {
+        int r = (color >> 11) & 31, g = (color >> 5) & 63, b = color & 31;
+        rgb[0] = (r << 3) | (r >> 2);
+        rgb[1] = (g << 2) | (g >> 4);
+        rgb[2] = (b << 3) | (b >> 2);
+    }
+
+    struct ColorBlock
+    {
+        uint16_t color0 = 0;
+        uint16_t color1 = 0;
+        uint8_t indices[numBlockPixels] = {};
+        int error = 0;
+    };
+
+    /// quantize the endpoints and select the nearest of the four palette entries for each pixel.
+    ColorBlock encodeColors(const uint8_t* rgba, const float* lo, const float* hi)
+    {
+        ColorBlock block;
+        block.color0 = packRGB565(hi);
+        block.color1 = packRGB565(lo);
+
+        // four colour mode requires color0 > color1
+        if (block.color0 < block.color1) std::swap(block.color0, block.color1);
+
+        int palette[4][3];
+        unpackRGB565(block.color0, palette[0]);
+        unpackRGB565(block.color1, palette[1]);
+        for (int c = 0; c < 3; ++c)
+        {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+
+        // equal endpoints decode as three colour mode, where index 3 is black, so only index 0 may be used
+        int numEntries = (block.color0 == block.color1) ? 1 : 4;
+
+        for (int i = 0; i < numBlockPixels; ++i)
+        {
+            const uint8_t* pixel = rgba + i * 4;
+            int bestError = std::numeric_limits<int>::max();
+            for (int p = 0; p < numEntries; ++p)
+            {
+                int dr = pixel[0] - palette[p][0], dg = pixel[1] - palette[p][1], db = pixel[2] - palette[p][2];
+                int error = dr * dr + dg * dg + db * db;
+                if (error < bestError)
+                {
+                    bestError = error;
+                    block.indices[i] = static_cast<uint8_t>(p);
+                }
+            }
+            block.error += bestError;
+        }
+        return block;
+    }
+
+    void encodeColorBlock(const uint8_t* rgba, uint8_t* dst, uint32_t quality)
+    {
+        float lo[3], hi[3];
+        fitEndpoints<3>(rgba, quality, lo, hi);
+
+        ColorBlock best = encodeColors(rgba, lo, hi);
+
+        if (quality >= TEXTURE_COMPRESSION_BEST)
+        {
+            // weights of color0 for each of the palette indices
+            static constexpr float color0Weights[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+            for (int iteration = 0; iteration < 2 && best.error > 0; ++iteration)
+            {
+                float weights[numBlockPixels];
+                for (int i = 0; i < numBlockPixels; ++i) weights[i] = color0Weights[best.indices[i]];
+
+                if (!refineEndpoints<3>(rgba, weights, lo, hi)) break;
+
+                ColorBlock candidate = encodeColors(rgba, lo, hi);
+                if (candidate.error >= best.error) break;
+                best = candidate;
+            }
+        }
+
+        uint32_t indexBits = 0;
+        for (int i = 0; i < numBlockPixels; ++i) indexBits |= uint32_t(best.indices[i]) << (i * 2);
+
+        writeLE16(dst, best.color0);
+        writeLE16(dst + 2, best.color1);
+        writeLE32(dst + 4, indexBits);
+    }
+
+    //
+    // BC3 alpha
+    //
+    void encodeAlphaBlock(const uint8_t* rgba, uint8_t* dst)
+    {
+        int minAlpha = 255, maxAlpha = 0;
+        for (int i = 0; i < numBlockPixels; ++i)
+        {
+            minAlpha = std::min(minAlpha, int(rgba[i * 4 + 3]));
+            maxAlpha = std::max(maxAlpha, int(rgba[i * 4 + 3]));
+        }
+
+        // alpha0 > alpha1 selects the eight value mode, codes 0 and 1 are the endpoints and codes 2 to 7 interpolate from alpha0 to alpha1
+        uint64_t indexBits = 0;
+        if (maxAlpha > minAlpha)
+        {
+            int range = maxAlpha - minAlpha;
+            for (int i = 0; i < numBlockPixels; ++i)
+            {
+                int step = ((maxAlpha - rgba[i * 4 + 3]) * 7 + range / 2) / range;
+                uint64_t code = (step == 0) ? 0 : (step == 7) ? 1 : static_cast<uint64_t>(step + 1);
+                indexBits |= code << (i * 3);
+            }
+        }
+
+        dst[0] = static_cast<uint8_t>(maxAlpha);
+        dst[1] = static_cast<uint8_t>(minAlpha);
+        for (int i = 0; i < 6; ++i) dst[2 + i] = static_cast<uint8_t>(indexBits >> (i * 8));
+    }
+
+    //
+    // BC7 mode 6, one subset with 7.7.7.7 RGBA endpoints, a p-bit per endpoint and 4 bit indices
+    //
+    constexpr int bc7Weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+    struct BC7Block
+    {
+        int endpoints[2][4] = {}; // 7 bit values
+        int pbits[2] = {};
+        uint8_t indices[numBlockPixels] = {};
+        int error = 0;
+    };
+
+    /// quantize endpoint to 7 bits per channel plus a shared p-bit, choosing the p-bit with the lowest error
+    void quantizeBC7Endpoint(const float* value, int* endpoint, int& pbit)
+    {
+        float bestError = std::numeric_limits<float>::max();
+        for (int p = 0; p < 2; ++p)
+        {
+            int candidate[4];
+            float error = 0.0f;
+            for (int c = 0; c < 4; ++c)
+            {
+                candidate[c] = clampTo(static_cast<int>(std::lround((value[c] - p) / 2.0f)), 0, 127);
+                float d = float((candidate[c] << 1) | p) - value[c];
+                error += d * d;
+            }
+
+            if (error < bestError)
+            {
+                bestError = error;
+                pbit = p;
+                std::copy(candidate, candidate + 4, endpoint);
+            }
+        }
+    }
+
+    BC7Block encodeBC7Colors(const uint8_t* rgba, const float* lo, const float* hi)
+    {
+        BC7Block block;
+        quantizeBC7Endpoint(lo, block.endpoints[0], block.pbits[0]);
+        quantizeBC7Endpoint(hi, block.endpoints[1], block.pbits[1]);
+
+        int e0[4], e1[4];
+        for (int c = 0; c < 4; ++c)
+        {
+            e0[c] = (block.endpoints[0][c] << 1) | block.pbits[0];
+            e1[c] = (block.endpoints[1][c] << 1) | block.pbits[1];
+        }
+
+        int palette[16][4];
+        for (int p = 0; p < 16; ++p)
+        {
+            for (int c = 0; c < 4; ++c) palette[p][c] = ((64 - bc7Weights[p]) * e0[c] + bc7Weights[p] * e1[c] + 32) >> 6;
+        }
+
+        for (int i = 0; i < numBlockPixels; ++i)
+        {
+            const uint8_t* pixel = rgba + i * 4;
+            int bestError = std::numeric_limits<int>::max();
+            for (int p = 0; p < 16; ++p)
+            {
+                int error = 0;
+                for (int c = 0; c < 4; ++c)
+                {
+                    int d = pixel[c] - palette[p][c];
+                    error += d * d;
+                }
+                if (error < bestError)
+                {
+                    bestError = error;
+                    block.indices[i] = static_cast<uint8_t>(p);
+                }
+            }
+            block.error += bestError;
+        }
+        return block;
+    }
+
+    struct BitWriter
+    {
+        uint8_t* data;
+        uint32_t position = 0;
+
+        void write(uint32_t value, uint32_t numBits)
+        {
+            for (uint32_t i = 0; i < numBits; ++i, ++position)
+            {
+                if ((value >> i) & 1) data[position >> 3] |= static_cast<uint8_t>(1 << (position & 7));
+            }
+        }
+    };
+} // namespace
+
+void osg2vsg::encodeBC1Block(const uint8_t* rgba, uint8_t* block, uint32_t quality)
+{
+    encodeColorBlock(rgba, block, quality);
+}
+
+void osg2vsg::encodeBC3Block(const uint8_t* rgba, uint8_t* block, uint32_t quality)
+{
+    encodeAlphaBlock(rgba, block);
+    encodeColorBlock(rgba, block + 8, quality);
+}
+
+void osg2vsg::encodeBC7Block(const uint8_t* rgba, uint8_t* block, uint32_t quality)
+{
+    float lo[4], hi[4];
+    fitEndpoints<4>(rgba, quality, lo, hi);
+
+    BC7Block best = encodeBC7Colors(rgba, lo, hi);
+
+    if (quality >= TEXTURE_COMPRESSION_BEST)
+    {
+        for (int iteration = 0; iteration < 2 && best.error > 0; ++iteration)
+        {
+            float weights[numBlockPixels];
+            for (int i = 0; i < numBlockPixels; ++i) weights[i] = bc7Weights[best.indices[i]] / 64.0f;
+
+            if (!refineEndpoints<4>(rgba, weights, lo, hi)) break;
+
+            BC7Block candidate = encodeBC7Colors(rgba, lo, hi);
+            if (candidate.error >= best.error) break;
+            best = candidate;
+        }
+    }
+
+    // the most significant bit of the first pixel's index is implicitly zero, so swap the endpoints if required
+    if (best.indices[0] & 8)
+    {
+        std::swap(best.endpoints[0], best.endpoints[1]);
+        std::swap(best.pbits[0], best.pbits[1]);
+        for (auto& index : best.indices) index = static_cast<uint8_t>(15 - index);
+    }
+
+    std::memset(block, 0, 16);
+    BitWriter writer{block};
+    writer.write(1 << 6, 7); // mode 6
+    for (int c = 0; c < 4; ++c)
+    {
+        writer.write(best.endpoints[0][c], 7);
+        writer.write(best.endpoints[1][c], 7);
+    }
+    writer.write(best.pbits[0], 1);
+    writer.write(best.pbits[1], 1);
+    writer.write(best.indices[0], 3);
+    for (int i = 1; i < numBlockPixels; ++i) writer.write(best.indices[i], 4);
+}
+
+vsg::ref_ptr<vsg::Data> osg2vsg::compressImage(const osg::Image* image, TextureCompression compression, uint32_t quality, TaskScheduler* scheduler)
+{
+    if (!image || compression == TEXTURE_COMPRESSION_NONE) return {};
+    if (image->isCompressed() || image->getDataType() != GL_UNSIGNED_BYTE || image->r() != 1) return {};
+
+    // offsets of the red, green, blue and alpha components in each pixel, -1 for no alpha
+    int componentOffset[4];
+    switch (image->getPixelFormat())
+    {
+    case (GL_RGB): componentOffset[0] = 0, componentOffset[1] = 1, componentOffset[2] = 2, componentOffset[3] = -1; break;
+    case (GL_BGR): componentOffset[0] = 2, componentOffset[1] = 1, componentOffset[2] = 0, componentOffset[3] = -1; break;
+    case (GL_RGBA): componentOffset[0] = 0, componentOffset[1] = 1, componentOffset[2] = 2, componentOffset[3] = 3; break;
+    case (GL_BGRA): componentOffset[0] = 2, componentOffset[1] = 1, componentOffset[2] = 0, componentOffset[3] = 3; break;
+    default: return {};
+    }
+
+    uint32_t pixelSize = image->getPixelSizeInBits() / 8;
+    uint32_t width = image->s(), height = image->t();
+    if (width == 0 || height == 0) return {};
+
+    if (compression == TEXTURE_COMPRESSION_BC1 && componentOffset[3] >= 0)
+    {
+        // keep translucent images' alpha by falling back to BC3
+        bool opaque = true;
+        for (uint32_t t = 0; t < height && opaque; ++t)
+        {
+            const uint8_t* row = image->data(0, t);
+            for (uint32_t s = 0; s < width; ++s)
+            {
+                if (row[s * pixelSize + componentOffset[3]] != 255)
+                {
+                    opaque = false;
+                    break;
+                }
+            }
+        }
+        if (!opaque) compression = TEXTURE_COMPRESSION_BC3;
+    }
+
+    // vsg computes the size of each mipmap level by halving the number of blocks, so only keep the levels where that matches the image's mipmap sizes
+    uint32_t blocksWide = (width + 3) / 4, blocksHigh = (height + 3) / 4;
+    uint32_t numLevels = 0;
+    size_t numBlocks = 0;
+    for (uint32_t level = 0; level < image->getNumMipmapLevels(); ++level)
+    {
+        uint32_t levelWidth = std::max(width >> level, 1u), levelHeight = std::max(height >> level, 1u);
+        uint32_t levelBlocksWide = (levelWidth + 3) / 4, levelBlocksHigh = (levelHeight + 3) / 4;
+        if (levelBlocksWide != std::max(blocksWide >> level, 1u) || levelBlocksHigh != std::max(blocksHigh >> level, 1u)) break;
+        if (level > 0 && (blocksWide >> (level - 1)) <= 1 && (blocksHigh >> (level - 1)) <= 1) break;
+
+        numBlocks += size_t(levelBlocksWide) * levelBlocksHigh;
+        ++numLevels;
+    }
+
+    // only BC1 uses 64 bit blocks, BC3 and BC7 use 128 bit blocks
+    size_t blockSize = (compression == TEXTURE_COMPRESSION_BC1) ? 8 : 16;
+    uint8_t* data = static_cast<uint8_t*>(vsg::allocate(numBlocks * blockSize, vsg::ALLOCATOR_AFFINITY_DATA));
+
+    auto encodeBlock = (compression == TEXTURE_COMPRESSION_BC1) ? encodeBC1Block : (compression == TEXTURE_COMPRESSION_BC3) ? encodeBC3Block : encodeBC7Block;
+
+    uint8_t* levelData = data;
+    for (uint32_t level = 0; level < numLevels; ++level)
+    {
+        uint32_t levelWidth = std::max(width >> level, 1u), levelHeight = std::max(height >> level, 1u);
+        uint32_t levelBlocksWide = (levelWidth + 3) / 4, levelBlocksHigh = (levelHeight + 3) / 4;
+        const uint8_t* source = image->getMipmapData(level);
+        size_t rowSize = (level == 0) ? image->getRowStepInBytes() : osg::Image::computeRowWidthInBytes(levelWidth, image->getPixelFormat(), image->getDataType(), image->getPacking());
+
+        // encode rows of blocks in parallel, each task encoding around 1024 blocks
+        parallel_for(scheduler, levelBlocksHigh, std::max(1024u / levelBlocksWide, 1u), [&](size_t by) {
+            uint8_t rgba[numBlockPixels * 4];
+            for (uint32_t bx = 0; bx < levelBlocksWide; ++bx)
+            {
+                // gather the block, replicating the edge pixels of levels smaller than a block
+                for (uint32_t y = 0; y < 4; ++y)
+                {
+                    uint32_t t = std::min(static_cast<uint32_t>(by) * 4 + y, levelHeight - 1);
+                    const uint8_t* row = source + t * rowSize;
+                    for (uint32_t x = 0; x < 4; ++x)
+                    {
+                        const uint8_t* pixel = row + std::min(bx * 4 + x, levelWidth - 1) * pixelSize;
+                        uint8_t* dst = rgba + (y * 4 + x) * 4;
+                        dst[0] = pixel[componentOffset[0]];
+                        dst[1] = pixel[componentOffset[1]];
+                        dst[2] = pixel[componentOffset[2]];
+                        dst[3] = (componentOffset[3] >= 0) ? pixel[componentOffset[3]] : 255;
+                    }
+                }
+
+                encodeBlock(rgba, levelData + (by * levelBlocksWide + bx) * blockSize, quality);
+            }
+        });
+
+        levelData += size_t(levelBlocksWide) * levelBlocksHigh * blockSize;
+    }
+
+    vsg::Data::Properties layout;
+    layout.blockWidth = 4;
+    layout.blockHeight = 4;
+    layout.maxNumMipmaps = static_cast<uint8_t>(numLevels);
+    layout.origin = (image->getOrigin() == osg::Image::BOTTOM_LEFT) ? vsg::BOTTOM_LEFT : vsg::TOP_LEFT;
+
+    switch (compression)
+    {
+    case (TEXTURE_COMPRESSION_BC1):
+        layout.format = VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+        return vsg::block64Array2D::create(blocksWide, blocksHigh, reinterpret_cast<vsg::block64*>(data), layout);
+    case (TEXTURE_COMPRESSION_BC3):
+        layout.format = VK_FORMAT_BC3_UNORM_BLOCK;
+        return vsg::block128Array2D::create(blocksWide, blocksHigh, reinterpret_cast<vsg::block128*>(data), layout);
+    default:
+        layout.format = VK_FORMAT_BC7_UNORM_BLOCK;
+        return vsg::block128Array2D::create(blocksWide, blocksHigh, reinterpret_cast<vsg::block128*>(data), layout);
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <osg/Image>
+
+#include "TaskScheduler.h"
+
+namespace osg2vsg
+{
+    enum TextureCompression : uint32_t
+    {
+        TEXTURE_COMPRESSION_NONE,
+        TEXTURE_COMPRESSION_BC1, // BC1 for opaque images, images with translucent alpha fall back to BC3 so their alpha isn't lost
+        TEXTURE_COMPRESSION_BC3,
+        TEXTURE_COMPRESSION_BC7
+    };
+
+    /// quality settings for the block encoders, higher qualities search for better endpoints at the cost of encode time.
+    enum TextureCompressionQuality : uint32_t
+    {
+        TEXTURE_COMPRESSION_FAST,    // endpoints from the block's bounding box
+        TEXTURE_COMPRESSION_NORMAL,  // endpoints along the principal axis of the block's colours
+        TEXTURE_COMPRESSION_BEST     // principal axis endpoints refined by least squares fitting to the selected indices
+    };
+
+    /// encode 4x4 block of RGBA8 pixels, stored row by row, to a 64 bit BC1 block. Alpha is ignored.
+    void encodeBC1Block(const uint8_t* rgba, uint8_t* block, uint32_t quality);
+
+    /// encode 4x4 block of RGBA8 pixels, stored row by row, to a 128 bit BC3 block.
+    void encodeBC3Block(const uint8_t* rgba, uint8_t* block, uint32_t quality);
+
+    /// encode 4x4 block of RGBA8 pixels, stored row by row, to a 128 bit BC7 mode 6 block.
+    void encodeBC7Block(const uint8_t* rgba, uint8_t* block, uint32_t quality);
+
+    /// compress an uncompressed 8 bit RGB, RGBA, BGR or BGRA 2D image, including any mipmaps, returning a vsg::block64Array2D or vsg::block128Array2D.
+    /// Returns null if the image isn't suitable for compression, in which case it should be converted uncompressed.
+    /// Blocks are encoded in parallel when a scheduler is provided.
+    vsg::ref_ptr<vsg::Data> compressImage(const osg::Image* image, TextureCompression compression, uint32_t quality, TaskScheduler* scheduler = nullptr);
+
+} // namespace osg2vsg
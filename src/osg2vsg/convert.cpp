@@ -15,7 +15,12 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <osgDB/FileNameUtils>
 
 #include "ConvertToVsg.h"
+#include "CullGroupHierarchy.h"
 #include "ImageUtils.h"
+#include "InstanceGeometries.h"
+#include "MergeGeometries.h"
+#include "Meshlets.h"
+#include "OptimizeMeshes.h"
 #include <filesystem>
 
 using namespace osg2vsg;
@@ -93,7 +98,6 @@ public:
         osg::NodeVisitor(TRAVERSE_ALL_CHILDREN),
         m_path{ std::move(in_path) }
     {
-        m_path = m_path.substr(0, m_path.find_last_of('\\'));
     }
 
     ProcessTextureVisitor(const ProcessTextureVisitor&) = default;
@@ -156,31 +160,11 @@ private:
             return;
 
         osg::Texture2D* baseTexture{ dynamic_cast<osg::Texture2D*> (in_stateSet->getTextureAttribute(0, osg::StateAttribute::TEXTURE)) };
-        std::string base{ osgDB::getNameLessExtension(baseImagePath) };
-
-        size_t pos = base.rfind("_diffuse");
-
-        if (pos != std::string::npos) {
-            base = base.erase(pos);
-        }
-        else {
-            pos = base.rfind("_Diffuse");
-            if (pos != std::string::npos) {
-                base = base.erase(pos);
-            }
-            else {
-                pos = base.rfind("_DIFFUSE");
-                if (pos != std::string::npos) {
-                    base = base.erase(pos);
-                }
-            }
-        }
-
         std::string extension{ osgDB::getFileExtension(baseImagePath) };
 
         auto loadAndSetTexture = [&](const std::string& in_textureType, unsigned int in_unit, const std::string& in_userValue)
         {
-            std::string imageFileName{ m_path + "\\" + base + in_textureType + extension };
+            std::string imageFileName{ siblingImageFileName(m_path, baseImagePath, in_textureType) };
 
             if (std::filesystem::exists(imageFileName))
             {
@@ -235,31 +219,49 @@ private:
 
 vsg::ref_ptr<vsg::Node> osg2vsg::convert(const osg::Node& node, vsg::ref_ptr<const vsg::Options> options, const vsg::Path& filePath)
 {
-    bool mapRGBtoRGBAHint = !options || options->mapRGBtoRGBAHint;
     vsg::Paths searchPaths = options ? options->paths : vsg::getEnvPaths("VSG_FILE_PATH");
 
-    vsg::ref_ptr<osg2vsg::BuildOptions> buildOptions;
-    auto pipelineCache = osg2vsg::PipelineCache::create();
+    auto buildOptions = osg2vsg::readBuildOptions(options);
 
     std::string build_options_filename;
-    if (options->getValue(OSG::read_build_options, build_options_filename))
+    if (options->getValue(OSG::write_build_options, build_options_filename))
     {
-        buildOptions = vsg::read_cast<osg2vsg::BuildOptions>(build_options_filename, options);
+        vsg::write(buildOptions, build_options_filename, options);
     }
 
-    if (!buildOptions)
+    buildOptions->numThreads = vsg::value<uint32_t>(buildOptions->numThreads, OSG::num_threads, options);
+
+    buildOptions->options = options;
+    // reuse the pipelines created by previous reads so they are shared across the loaded subgraphs and only compiled once
+    if (!buildOptions->pipelineCache) buildOptions->pipelineCache = osg2vsg::PipelineCache::instance(options);
+    if (buildOptions->numThreads > 1 && !buildOptions->scheduler)
     {
-        buildOptions = osg2vsg::BuildOptions::create();
-        buildOptions->mapRGBtoRGBAHint = mapRGBtoRGBAHint;
+        buildOptions->scheduler = osg2vsg::TaskScheduler::instance(buildOptions->numThreads);
     }
 
-    if (options->getValue(OSG::write_build_options, build_options_filename))
+    // share the conversion caches between all the reads, potentially on different threads, that use the same sharedObjects
+    if (!buildOptions->conversionCache && options->sharedObjects)
     {
-        vsg::write(buildOptions, build_options_filename, options);
+        buildOptions->conversionCache = options->sharedObjects->shared_default<osg2vsg::ConversionCache>();
     }
 
-    buildOptions->options = options;
-    buildOptions->pipelineCache = pipelineCache;
+    // share the textures with identical content across the scope selected by the texture_deduplication option
+    if (!buildOptions->textureContentCache)
+    {
+        switch (buildOptions->textureDeduplication)
+        {
+        case (osg2vsg::TEXTURE_DEDUPLICATION_NONE): break;
+        case (osg2vsg::TEXTURE_DEDUPLICATION_PROCESS): buildOptions->textureContentCache = osg2vsg::TextureContentCache::instance(); break;
+        case (osg2vsg::TEXTURE_DEDUPLICATION_SHARED):
+            if (options->sharedObjects)
+            {
+                buildOptions->textureContentCache = options->sharedObjects->shared_default<osg2vsg::TextureContentCache>();
+                break;
+            }
+            [[fallthrough]];
+        default: buildOptions->textureContentCache = osg2vsg::TextureContentCache::create(); break;
+        }
+    }
 
     auto osg_scene = const_cast<osg::Node*>(&node);
     ProcessTextureVisitor processTextureVisitor{ filePath.string() };
@@ -278,8 +280,64 @@ vsg::ref_ptr<vsg::Node> osg2vsg::convert(const osg::Node& node, vsg::ref_ptr<con
         osg2vsg::ConvertToVsg sceneBuilder(buildOptions, inheritedStateGroup);
 
         sceneBuilder.optimize(osg_scene);
+
         auto vsg_scene = sceneBuilder.convert(osg_scene);
 
+        // the scene's own statistics, the shared ConversionCache only accumulates the totals of all the conversions using it
+        auto& geometryStatistics = sceneBuilder.sceneCache->geometryStatistics;
+        vsg::debug("osg2vsg::convert() saved ", geometryStatistics.indexBytesSaved, " index bytes with 16 bit indices.");
+        if (buildOptions->triangleStrips) vsg::debug("osg2vsg::convert() saved ", geometryStatistics.stripBytesSaved, " index bytes with triangle strips.");
+        if (buildOptions->vertexCompression.enabled) vsg::debug("osg2vsg::convert() saved ", geometryStatistics.vertexBytesSaved, " vertex bytes with compressed vertex attributes.");
+        if (buildOptions->meshSimplification.enabled) vsg::debug("osg2vsg::convert() simplified ", geometryStatistics.numMeshesSimplified, " meshes into LOD levels.");
+        vsg::debug("osg2vsg::convert() dropped ", geometryStatistics.vertexBytesPruned, " bytes of vertex attributes the pipelines don't read.");
+
+        // optimize the meshes first, so instanced and merged draws inherit the optimized order
+        if (vsg_scene && buildOptions->optimizeMeshes)
+        {
+            osg2vsg::OptimizeMeshes optimizeMeshes(buildOptions->scheduler.get(), buildOptions->vertexCacheSize);
+            vsg_scene->accept(optimizeMeshes);
+            optimizeMeshes.optimize();
+            vsg::debug("osg2vsg::convert() optimized ", optimizeMeshes.numDrawsOptimized, " meshes, ACMR ", optimizeMeshes.before.acmr(), " -> ", optimizeMeshes.after.acmr(), ", ATVR ", optimizeMeshes.before.atvr(), " -> ", optimizeMeshes.after.atvr());
+        }
+
+        if (vsg_scene && buildOptions->instanceGeometries && (buildOptions->supportedGeometryAttributes & osg2vsg::INSTANCE_TRANSFORM))
+        {
+            osg2vsg::InstanceGeometries instanceGeometries(buildOptions, buildOptions->minInstances, buildOptions->maxInstances);
+            vsg_scene->accept(instanceGeometries);
+            vsg::debug("osg2vsg::convert() instanced ", instanceGeometries.numInstancedDraws, " draws, eliminating ", instanceGeometries.numDrawsEliminated, " draw calls.");
+        }
+
+        if (vsg_scene && buildOptions->mergeGeometries)
+        {
+            osg2vsg::MergeGeometries mergeGeometries(buildOptions->maxMergedVertices);
+            vsg_scene->accept(mergeGeometries);
+            vsg::debug("osg2vsg::convert() merged ", mergeGeometries.numDrawsMerged, " draws into ", mergeGeometries.numBatches, " batches.");
+        }
+
+        // meshlets are built over the final index arrays of the instanced and merged draws
+        if (vsg_scene && buildOptions->buildMeshlets)
+        {
+            osg2vsg::BuildMeshlets buildMeshlets(buildOptions->scheduler.get(), buildOptions->maxMeshletVertices, buildOptions->maxMeshletTriangles);
+            vsg_scene->accept(buildMeshlets);
+            buildMeshlets.build();
+            vsg::debug("osg2vsg::convert() built ", buildMeshlets.numMeshlets, " meshlets for ", buildMeshlets.numDraws, " draws.");
+        }
+
+        // build the hierarchy last, over the children left once draws have been instanced and merged
+        if (vsg_scene && buildOptions->buildCullGroupHierarchy)
+        {
+            osg2vsg::BuildCullGroupHierarchy buildHierarchy(buildOptions->hierarchyFanOut, buildOptions->hierarchyLeafSize);
+            vsg_scene->accept(buildHierarchy);
+            vsg::debug("osg2vsg::convert() reorganised ", buildHierarchy.numGroupsReorganised, " groups under ", buildHierarchy.numCullGroupsCreated, " CullGroups.");
+        }
+
+        sceneBuilder.conversionCache->addSceneCacheCounts(*sceneBuilder.sceneCache);
+
+        if (auto& sceneCache = sceneBuilder.sceneCache; sceneCache->duplicateTextures > 0)
+        {
+            vsg::debug("osg2vsg::convert() ", sceneCache->duplicateTextures, " duplicate textures shared, ", sceneCache->duplicateTextureBytes, " bytes saved.");
+        }
+
         if (sceneBuilder.numOfPagedLOD > 0)
         {
             uint32_t maxLevel = 20;
@@ -301,3 +359,21 @@ vsg::ref_ptr<vsg::Node> osg2vsg::convert(const osg::Node& node, vsg::ref_ptr<con
         return vsg_scene;
     }
 }
+
+void osg2vsg::reportCaches(const vsg::Options& options, std::ostream& out)
+{
+    auto pipelineCache = osg2vsg::PipelineCache::instance(&options);
+    pipelineCache->report(out);
+
+    auto textureContentCache = osg2vsg::TextureContentCache::instance();
+    if (textureContentCache->textures.size() > 0) textureContentCache->report(out);
+
+    if (!options.sharedObjects)
+    {
+        out << "No sharedObjects assigned to options, conversion caches are not shared." << std::endl;
+        return;
+    }
+
+    options.sharedObjects->shared_default<osg2vsg::ConversionCache>()->report(out);
+    options.sharedObjects->shared_default<osg2vsg::TextureContentCache>()->report(out);
+}
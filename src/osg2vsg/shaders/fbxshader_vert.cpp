@@ -11,7 +11,7 @@ Root id=1 vsg::ShaderStage
     userObjects 0
     hints id=0
     source "#version 450
-#pragma import_defines ( VSG_NORMAL, VSG_COLOR, VSG_TEXCOORD0, VSG_LIGHTING )
+#pragma import_defines ( VSG_NORMAL, VSG_COLOR, VSG_TEXCOORD0, VSG_LIGHTING, VSG_INSTANCE_TRANSFORM, VSG_OCT_NORMAL )
 #extension GL_ARB_separate_shader_objects : enable
 layout(push_constant) uniform PushConstants {
     mat4 projection;
@@ -20,7 +20,11 @@ layout(push_constant) uniform PushConstants {
 } pc;
 layout(location = 0) in vec3 osg_Vertex;
 #ifdef VSG_NORMAL
+#ifdef VSG_OCT_NORMAL
+layout(location = 1) in vec2 osg_Normal;
+#else
 layout(location = 1) in vec3 osg_Normal;
+#endif
 layout(location = 1) out vec3 normalDir;
 #endif
 #ifdef VSG_COLOR
@@ -35,21 +39,40 @@ layout(location = 4) out vec2 texCoord0;
 layout(location = 5) out vec3 viewDir;
 layout(location = 6) out vec3 lightDir;
 #endif
+#ifdef VSG_INSTANCE_TRANSFORM
+layout(location = 9) in mat4 instanceTransform;
+#endif
 out gl_PerVertex{ vec4 gl_Position; };
+#ifdef VSG_OCT_NORMAL
+vec3 octDecode(vec2 e)
+{
+    vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (v.z < 0.0) v.xy = (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(v);
+}
+#endif
 
 void main()
 {
-    gl_Position = (pc.projection * pc.modelview) * vec4(osg_Vertex, 1.0);
+    mat4 modelview = pc.modelview;
+#ifdef VSG_INSTANCE_TRANSFORM
+    modelview = modelview * instanceTransform;
+#endif
+    gl_Position = (pc.projection * modelview) * vec4(osg_Vertex, 1.0);
 #ifdef VSG_TEXCOORD0
     texCoord0 = osg_MultiTexCoord0.st;
 #endif
 #ifdef VSG_NORMAL
-    vec3 n = ((pc.modelview) * vec4(osg_Normal, 0.0)).xyz;
+#ifdef VSG_OCT_NORMAL
+    vec3 n = ((modelview) * vec4(octDecode(osg_Normal), 0.0)).xyz;
+#else
+    vec3 n = ((modelview) * vec4(osg_Normal, 0.0)).xyz;
+#endif
     normalDir = n;
 #endif
 #ifdef VSG_LIGHTING
     vec4 lpos = /*osg_LightSource.position*/ vec4(0.0, 0.25, 1.0, 0.0);
-    viewDir = -vec3((pc.modelview) * vec4(osg_Vertex, 1.0));
+    viewDir = -vec3((modelview) * vec4(osg_Vertex, 1.0));
     if (lpos.w == 0.0)
         lightDir = lpos.xyz;
     else
@@ -11,7 +11,7 @@ Root id=1 vsg::ShaderStage
     userObjects 0
     hints id=0
     source "#version 450
-#pragma import_defines ( VSG_NORMAL, VSG_COLOR, VSG_TEXCOORD0, VSG_LIGHTING )
+#pragma import_defines ( VSG_NORMAL, VSG_COLOR, VSG_TEXCOORD0, VSG_LIGHTING, VSG_INSTANCE_TRANSFORM, VSG_OCT_NORMAL )
 #extension GL_ARB_separate_shader_objects : enable
 
 layout(push_constant) uniform PushConstants 
@@ -24,7 +24,11 @@ layout(push_constant) uniform PushConstants
 layout(location = 0) in vec3 osg_Vertex;
 
 #ifdef VSG_NORMAL
+#ifdef VSG_OCT_NORMAL
+layout(location = 1) in vec2 osg_Normal;
+#else
 layout(location = 1) in vec3 osg_Normal;
+#endif
 layout(location = 1) out vec3 normalDir;
 #endif
 
@@ -44,21 +48,38 @@ layout(location = 5) out vec3 viewDir;
 layout(location = 6) out vec3 lightDir;
 #endif
 
+#ifdef VSG_INSTANCE_TRANSFORM
+layout(location = 9) in mat4 instanceTransform;
+#endif
+
 out gl_PerVertex{ vec4 gl_Position; };
 
+#ifdef VSG_OCT_NORMAL
+vec3 octDecode(vec2 e)
+{
+    vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (v.z < 0.0) v.xy = (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(v);
+}
+#endif
+
 void main()
 {
 	vec4 vertex = vec4(osg_Vertex, 1.0);
+	mat4 modelview = pc.modelview;
+#ifdef VSG_INSTANCE_TRANSFORM
+	modelview = modelview * instanceTransform;
+#endif
 	
-	gl_Position = (pc.projection * pc.modelview) * vertex;
+	gl_Position = (pc.projection * modelview) * vertex;
 	
 #ifdef VSG_LIGHTING
-	eyePos = (pc.modelview * vertex).xyz;
-	viewDir = -(pc.modelview * vertex).xyz;
+	eyePos = (modelview * vertex).xyz;
+	viewDir = -(modelview * vertex).xyz;
 	
 	// TODO : use real light source positions
 	vec4 lightPos = /*osg_LightSource.position*/ vec4(0.0, 10.0, 50.0, 0.0);
-    viewDir = -vec3((pc.modelview) * vec4(osg_Vertex, 1.0));
+    viewDir = -vec3((modelview) * vec4(osg_Vertex, 1.0));
     if (lightPos.w == 0.0)
         lightDir = lightPos.xyz;
     else
@@ -66,8 +87,12 @@ void main()
 #endif
 	
 #ifdef VSG_NORMAL
+#ifdef VSG_OCT_NORMAL
+	vec4 normal = vec4(octDecode(osg_Normal), 0.0);
+#else
 	vec4 normal = vec4(osg_Normal, 0.0);
-	normalDir = (pc.modelview * normal).xyz;
+#endif
+	normalDir = (modelview * normal).xyz;
 #endif
 	
 #ifdef VSG_COLOR